@@ -22,136 +22,145 @@ const uint32_t NOISE_DIVISORS[8] = {8, 16, 32, 48, 64, 80, 96, 112};
 // Global APU instance for callback access
 static struct APU* g_callback_apu = NULL;
 
-// Helper function to convert samples to time-based ticks
-static void update_frame_sequencer_timers(struct APU* apu, float samples_generated) {
-    float time_elapsed = samples_generated / APU_SAMPLE_RATE;
-    
-    // Update frame sequencer accumulator (512 Hz)
-    apu->frame_sequencer_accumulator += time_elapsed * 512.0f;
+// One 512 Hz frame sequencer step: length counters, sweep and envelopes
+static void apu_frame_sequencer_step(struct APU* apu) {
+    // Frame sequencer runs at 512 Hz with 8 steps
+    uint8_t step = apu->frame_sequencer_step;
     
-    // Process frame sequencer steps
-    while (apu->frame_sequencer_accumulator >= 1.0f) {
-        apu->frame_sequencer_accumulator -= 1.0f;
-        
-        // Frame sequencer runs at 512 Hz with 8 steps
-        uint8_t step = apu->frame_sequencer_step;
+    // Length counter updates (256 Hz) - steps 0, 2, 4, 6
+    if ((step & 1) == 0) {
+        // Square 1
+        if (apu->square1.length_enabled && apu->square1.length_counter > 0) {
+            apu->square1.length_counter--;
+            if (apu->square1.length_counter == 0) {
+                apu->square1.enabled = false;
+                apu->square1.phase = 0.0f;
+                apu->square1.duty_step = 0;
+            }
+        }
         
-        // Length counter updates (256 Hz) - steps 0, 2, 4, 6
-        if ((step & 1) == 0) {
-            // Square 1
-            if (apu->square1.length_enabled && apu->square1.length_counter > 0) {
-                apu->square1.length_counter--;
-                if (apu->square1.length_counter == 0) {
-                    apu->square1.enabled = false;
-                    apu->square1.phase = 0.0f;
-                    apu->square1.duty_step = 0;
-                }
+        // Square 2
+        if (apu->square2.length_enabled && apu->square2.length_counter > 0) {
+            apu->square2.length_counter--;
+            if (apu->square2.length_counter == 0) {
+                apu->square2.enabled = false;
+                apu->square2.phase = 0.0f;
+                apu->square2.duty_step = 0;
             }
-            
-            // Square 2
-            if (apu->square2.length_enabled && apu->square2.length_counter > 0) {
-                apu->square2.length_counter--;
-                if (apu->square2.length_counter == 0) {
-                    apu->square2.enabled = false;
-                    apu->square2.phase = 0.0f;
-                    apu->square2.duty_step = 0;
-                }
+        }
+        
+        // Wave
+        if (apu->wave.length_enabled && apu->wave.length_counter > 0) {
+            apu->wave.length_counter--;
+            if (apu->wave.length_counter == 0) {
+                apu->wave.enabled = false;
+                apu->wave.phase = 0.0f;
+                apu->wave.sample_index = 0;
             }
-            
-            // Wave
-            if (apu->wave.length_enabled && apu->wave.length_counter > 0) {
-                apu->wave.length_counter--;
-                if (apu->wave.length_counter == 0) {
-                    apu->wave.enabled = false;
-                    apu->wave.phase = 0.0f;
-                    apu->wave.sample_index = 0;
-                }
+        }
+        
+        // Noise
+        if (apu->noise.length_enabled && apu->noise.length_counter > 0) {
+            apu->noise.length_counter--;
+            if (apu->noise.length_counter == 0) {
+                apu->noise.enabled = false;
+                apu->noise.phase = 0.0f;
+                apu->noise.lfsr = 0x7FFF;
             }
-            
-            // Noise
-            if (apu->noise.length_enabled && apu->noise.length_counter > 0) {
-                apu->noise.length_counter--;
-                if (apu->noise.length_counter == 0) {
-                    apu->noise.enabled = false;
-                    apu->noise.phase = 0.0f;
-                    apu->noise.lfsr = 0x7FFF;
+        }
+    }
+    
+    // Envelope updates (64 Hz) - step 7 only
+    if (step == 7) {
+        // Square 1 envelope
+        if (apu->square1.enabled && apu->square1.envelope_period > 0) {
+            apu->square1.envelope_counter++;
+            if (apu->square1.envelope_counter >= apu->square1.envelope_period) {
+                apu->square1.envelope_counter = 0;
+                if (apu->square1.envelope_add && apu->square1.volume < 15) {
+                    apu->square1.volume++;
+                } else if (!apu->square1.envelope_add && apu->square1.volume > 0) {
+                    apu->square1.volume--;
                 }
             }
         }
         
-        // Envelope updates (64 Hz) - step 7 only
-        if (step == 7) {
-            // Square 1 envelope
-            if (apu->square1.enabled && apu->square1.envelope_period > 0) {
-                apu->square1.envelope_counter++;
-                if (apu->square1.envelope_counter >= apu->square1.envelope_period) {
-                    apu->square1.envelope_counter = 0;
-                    if (apu->square1.envelope_add && apu->square1.volume < 15) {
-                        apu->square1.volume++;
-                    } else if (!apu->square1.envelope_add && apu->square1.volume > 0) {
-                        apu->square1.volume--;
-                    }
-                }
-            }
-            
-            // Square 2 envelope
-            if (apu->square2.enabled && apu->square2.envelope_period > 0) {
-                apu->square2.envelope_counter++;
-                if (apu->square2.envelope_counter >= apu->square2.envelope_period) {
-                    apu->square2.envelope_counter = 0;
-                    if (apu->square2.envelope_add && apu->square2.volume < 15) {
-                        apu->square2.volume++;
-                    } else if (!apu->square2.envelope_add && apu->square2.volume > 0) {
-                        apu->square2.volume--;
-                    }
+        // Square 2 envelope
+        if (apu->square2.enabled && apu->square2.envelope_period > 0) {
+            apu->square2.envelope_counter++;
+            if (apu->square2.envelope_counter >= apu->square2.envelope_period) {
+                apu->square2.envelope_counter = 0;
+                if (apu->square2.envelope_add && apu->square2.volume < 15) {
+                    apu->square2.volume++;
+                } else if (!apu->square2.envelope_add && apu->square2.volume > 0) {
+                    apu->square2.volume--;
                 }
             }
-            
-            // Noise envelope
-            if (apu->noise.enabled && apu->noise.envelope_period > 0) {
-                apu->noise.envelope_counter++;
-                if (apu->noise.envelope_counter >= apu->noise.envelope_period) {
-                    apu->noise.envelope_counter = 0;
-                    if (apu->noise.envelope_add && apu->noise.volume < 15) {
-                        apu->noise.volume++;
-                    } else if (!apu->noise.envelope_add && apu->noise.volume > 0) {
-                        apu->noise.volume--;
-                    }
+        }
+        
+        // Noise envelope
+        if (apu->noise.enabled && apu->noise.envelope_period > 0) {
+            apu->noise.envelope_counter++;
+            if (apu->noise.envelope_counter >= apu->noise.envelope_period) {
+                apu->noise.envelope_counter = 0;
+                if (apu->noise.envelope_add && apu->noise.volume < 15) {
+                    apu->noise.volume++;
+                } else if (!apu->noise.envelope_add && apu->noise.volume > 0) {
+                    apu->noise.volume--;
                 }
             }
         }
-        
-        // Sweep updates (128 Hz) - steps 2, 6 only
-        if (step == 2 || step == 6) {
-            if (apu->square1.enabled && apu->square1.sweep_period > 0 && apu->square1.sweep_shift > 0) {
-                apu->square1.sweep_counter++;
-                if (apu->square1.sweep_counter >= apu->square1.sweep_period) {
-                    apu->square1.sweep_counter = 0;
-                    
-                    uint16_t new_freq = apu->square1.frequency;
-                    uint16_t delta = new_freq >> apu->square1.sweep_shift;
-                    
-                    if (apu->square1.sweep_negate) {
-                        new_freq -= delta;
-                    } else {
-                        new_freq += delta;
-                        // Overflow check
-                        if (new_freq > 2047) {
-                            apu->square1.enabled = false;
-                            apu->square1.phase = 0.0f;
-                            apu->square1.duty_step = 0;
-                        }
-                    }
-                    
-                    if (apu->square1.enabled) {
-                        apu->square1.frequency = new_freq;
+    }
+    
+    // Sweep updates (128 Hz) - steps 2, 6 only
+    if (step == 2 || step == 6) {
+        if (apu->square1.enabled && apu->square1.sweep_period > 0 && apu->square1.sweep_shift > 0) {
+            apu->square1.sweep_counter++;
+            if (apu->square1.sweep_counter >= apu->square1.sweep_period) {
+                apu->square1.sweep_counter = 0;
+                
+                uint16_t new_freq = apu->square1.frequency;
+                uint16_t delta = new_freq >> apu->square1.sweep_shift;
+                
+                if (apu->square1.sweep_negate) {
+                    new_freq -= delta;
+                } else {
+                    new_freq += delta;
+                    // Overflow check
+                    if (new_freq > 2047) {
+                        apu->square1.enabled = false;
+                        apu->square1.phase = 0.0f;
+                        apu->square1.duty_step = 0;
                     }
                 }
+                
+                if (apu->square1.enabled) {
+                    apu->square1.frequency = new_freq;
+                }
             }
         }
-        
-        // Advance frame sequencer step
-        apu->frame_sequencer_step = (apu->frame_sequencer_step + 1) & 7;
+    }
+    
+    // Advance frame sequencer step
+    apu->frame_sequencer_step = (apu->frame_sequencer_step + 1) & 7;
+}
+
+// Helper function to convert samples to time-based ticks
+static void update_frame_sequencer_timers(struct APU* apu, float samples_generated) {
+    // Clocked by EVENT_APU_FRAME_SEQUENCER instead when a scheduler is attached
+    if (apu->scheduler) {
+        return;
+    }
+
+    float time_elapsed = samples_generated / APU_SAMPLE_RATE;
+    
+    // Update frame sequencer accumulator (512 Hz)
+    apu->frame_sequencer_accumulator += time_elapsed * 512.0f;
+    
+    // Process frame sequencer steps
+    while (apu->frame_sequencer_accumulator >= 1.0f) {
+        apu->frame_sequencer_accumulator -= 1.0f;
+        apu_frame_sequencer_step(apu);
     }
 }
 
@@ -673,6 +682,34 @@ void apu_attach_mmu(struct APU* apu, struct MMU* mmu) {
     }
 }
 
+// Frame sequencer tick in emulated time
+void apu_handle_frame_sequencer_event(void* context, uint64_t deadline) {
+    struct APU* apu = (struct APU*)context;
+    if (apu->sound_enabled) {
+        // The audio callback reads the length, envelope and sweep counters with the stream lock
+        // held, so the step runs under the same lock
+        if (apu->audio_stream) {
+            SDL_LockAudioStream(apu->audio_stream);
+        }
+        apu_frame_sequencer_step(apu);
+        if (apu->audio_stream) {
+            SDL_UnlockAudioStream(apu->audio_stream);
+        }
+    }
+    scheduler_schedule_at(apu->scheduler, EVENT_APU_FRAME_SEQUENCER,
+                          deadline + APU_FRAME_SEQUENCER_CYCLES);
+}
+
+// Attach scheduler to APU, the frame sequencer then follows emulated time
+void apu_attach_scheduler(struct APU* apu, struct Scheduler* scheduler) {
+    if (apu) {
+        apu->scheduler = scheduler;
+        scheduler_register(scheduler, EVENT_APU_FRAME_SEQUENCER,
+                           apu_handle_frame_sequencer_event, apu);
+        scheduler_schedule_in(scheduler, EVENT_APU_FRAME_SEQUENCER, APU_FRAME_SEQUENCER_CYCLES);
+    }
+}
+
 // Free APU
 void free_apu(struct APU* apu) {
     if (apu) {
@@ -2,6 +2,7 @@
 #define GAMEBOY_APU_H
 
 #include "general.h"
+#include "scheduler.h"
 #include <SDL3/SDL.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -51,6 +52,8 @@ extern struct EmulatorConfig config;
 
 // Game Boy APU constants
 #define APU_SAMPLE_RATE 44100
+// Frame sequencer period in CPU cycles (4194304 Hz / 512 Hz)
+#define APU_FRAME_SEQUENCER_CYCLES 8192
 #define APU_CHANNELS 2
 
 // Sound register addresses
@@ -194,6 +197,9 @@ struct APU {
     // MMU for register access
     struct MMU* mmu;
     
+    // Scheduler clocking the frame sequencer, NULL to clock it from the audio callback
+    struct Scheduler* scheduler;
+    
     // Method pointers (compatible with old API)
     void (*step)(struct APU*, uint32_t cycles);  // NO-OP in callback-driven mode!
     void (*write_register)(struct APU*, uint16_t address, uint8_t value);
@@ -206,6 +212,8 @@ struct APU {
 struct APU* create_apu(void);
 void free_apu(struct APU* apu);
 void apu_attach_mmu(struct APU* apu, struct MMU* mmu);
+void apu_attach_scheduler(struct APU* apu, struct Scheduler* scheduler);
+void apu_handle_frame_sequencer_event(void* context, uint64_t deadline);
 
 // APU control - callback-driven!
 void apu_write_register(struct APU* apu, uint16_t address, uint8_t value);
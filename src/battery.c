@@ -0,0 +1,217 @@
+// pthread_condattr_setclock is POSIX, -std=c2x alone does not declare it
+#define _POSIX_C_SOURCE 200809L
+
+#include "battery.h"
+#include "cartridge.h"
+
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+char* battery_save_path(const char* rom_path)
+{
+    size_t      stem_length = strlen(rom_path);
+    const char* extension   = strrchr(rom_path, '.');
+    // a dot before the last path separator belongs to a directory name
+    if (extension != NULL && strchr(extension, '/') == NULL && strchr(extension, '\\') == NULL) {
+        stem_length = extension - rom_path;
+    }
+    char* path = (char*)malloc(stem_length + sizeof(".sav"));
+    if (path == NULL) {
+        return NULL;
+    }
+    memcpy(path, rom_path, stem_length);
+    memcpy(path + stem_length, ".sav", sizeof(".sav"));
+    return path;
+}
+
+#ifndef _WIN32
+// Map the save file over the cartridge RAM window, growing a short file to the RAM size
+static bool battery_map(struct BatterySave* save)
+{
+    save->fd = open(save->path, O_RDWR | O_CREAT, 0644);
+    if (save->fd < 0) {
+        BATTERY_ERROR_PRINT("Failed to open save file: %s\n", save->path);
+        return false;
+    }
+    // a new save starts out cleared, a longer one (clock data after the RAM) keeps its tail
+    struct stat save_stat;
+    if (fstat(save->fd, &save_stat) != 0 ||
+        ((size_t)save_stat.st_size < save->size && ftruncate(save->fd, save->size) != 0)) {
+        BATTERY_ERROR_PRINT("Failed to size save file: %s\n", save->path);
+        close(save->fd);
+        return false;
+    }
+
+    void* mapping;
+    if (save->map_size > save->size) {
+        // RAM shorter than a bank: reserve the whole bank from /dev/zero, then lay the file over
+        // its start so pages past the end of the file never fault
+        int zero_fd = open("/dev/zero", O_RDWR);
+        mapping     = zero_fd < 0 ? MAP_FAILED
+                                  : mmap(NULL, save->map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                                         zero_fd, 0);
+        if (zero_fd >= 0) {
+            close(zero_fd);
+        }
+        if (mapping != MAP_FAILED && mmap(mapping, save->size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_FIXED, save->fd, 0) == MAP_FAILED) {
+            munmap(mapping, save->map_size);
+            mapping = MAP_FAILED;
+        }
+    }
+    else {
+        mapping = mmap(NULL, save->size, PROT_READ | PROT_WRITE, MAP_SHARED, save->fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        BATTERY_ERROR_PRINT("Failed to map save file: %s\n", save->path);
+        close(save->fd);
+        return false;
+    }
+    save->mapping = (uint8_t*)mapping;
+    return true;
+}
+
+// Write the dirty pages of the save back, clean pages cost nothing
+static void battery_flush(struct BatterySave* save)
+{
+    if (msync(save->mapping, save->size, MS_SYNC) != 0) {
+        BATTERY_ERROR_PRINT("Failed to flush save file: %s\n", save->path);
+    }
+}
+
+static void* battery_flush_main(void* context)
+{
+    struct BatterySave* save = (struct BatterySave*)context;
+    pthread_mutex_lock(&save->lock);
+    while (true) {
+        bool stopping = save->stopping;
+        if (!stopping) {
+            if (save->flush_interval > 0) {
+                struct timespec deadline;
+                clock_gettime(CLOCK_MONOTONIC, &deadline);
+                deadline.tv_sec += save->flush_interval / 1000;
+                deadline.tv_nsec += (long)(save->flush_interval % 1000) * 1000000;
+                if (deadline.tv_nsec >= 1000000000) {
+                    deadline.tv_sec += 1;
+                    deadline.tv_nsec -= 1000000000;
+                }
+                pthread_cond_timedwait(&save->wake_up, &save->lock, &deadline);
+            }
+            else {
+                pthread_cond_wait(&save->wake_up, &save->lock);
+            }
+            stopping = save->stopping;
+        }
+        pthread_mutex_unlock(&save->lock);
+
+        battery_flush(save);
+        if (stopping) {
+            return NULL;
+        }
+        pthread_mutex_lock(&save->lock);
+    }
+}
+#endif
+
+struct BatterySave* create_battery_save(struct Cartridge* cartridge, const char* rom_path,
+                                        int flush_interval)
+{
+    // a battery that only keeps the clock running has no RAM to save
+    if (cartridge->ram_data == NULL) {
+        return NULL;
+    }
+    struct BatterySave* save = (struct BatterySave*)malloc(sizeof(struct BatterySave));
+    if (save == NULL) {
+        return NULL;
+    }
+    save->cartridge      = cartridge;
+    save->path           = battery_save_path(rom_path);
+    save->fd             = -1;
+    save->mapping        = NULL;
+    save->size           = cartridge->ram_size;
+    save->map_size       = cartridge_ram_alloc_size(cartridge->ram_size);
+    save->flush_interval = flush_interval;
+    save->thread_running = false;
+    save->stopping       = false;
+    if (save->path == NULL) {
+        free(save);
+        return NULL;
+    }
+
+#ifndef _WIN32
+    if (!battery_map(save)) {
+        free(save->path);
+        free(save);
+        return NULL;
+    }
+    // the mapped file replaces the heap RAM
+    free(cartridge->ram_data);
+    cartridge->ram_data = save->mapping;
+    cartridge_update_banks(cartridge);
+
+    // the flush deadline follows the monotonic clock, wall clock jumps neither stall nor rush it
+    pthread_condattr_t wake_up_attributes;
+    pthread_condattr_init(&wake_up_attributes);
+    pthread_condattr_setclock(&wake_up_attributes, CLOCK_MONOTONIC);
+    pthread_mutex_init(&save->lock, NULL);
+    pthread_cond_init(&save->wake_up, &wake_up_attributes);
+    pthread_condattr_destroy(&wake_up_attributes);
+    save->thread_running = pthread_create(&save->thread, NULL, battery_flush_main, save) == 0;
+    if (!save->thread_running) {
+        BATTERY_ERROR_PRINT("Failed to start flush thread, saving only on exit\n");
+    }
+    BATTERY_DEBUG_PRINT("Mapped %zu bytes of RAM from %s, flushing every %d ms\n", save->size,
+                        save->path, flush_interval);
+#else
+    FILE* save_file = fopen(save->path, "rb");
+    if (save_file != NULL) {
+        if (!cartridge->mapper->load(cartridge, save_file)) {
+            BATTERY_DEBUG_PRINT("Save file %s is shorter than the RAM\n", save->path);
+        }
+        fclose(save_file);
+    }
+#endif
+    return save;
+}
+
+void free_battery_save(struct BatterySave* save)
+{
+    if (save == NULL) {
+        return;
+    }
+    struct Cartridge* cartridge = save->cartridge;
+#ifndef _WIN32
+    if (save->thread_running) {
+        // the flush thread writes the save a last time before it exits
+        pthread_mutex_lock(&save->lock);
+        save->stopping = true;
+        pthread_cond_signal(&save->wake_up);
+        pthread_mutex_unlock(&save->lock);
+        pthread_join(save->thread, NULL);
+    }
+    else {
+        battery_flush(save);
+    }
+    pthread_cond_destroy(&save->wake_up);
+    pthread_mutex_destroy(&save->lock);
+
+    cartridge->ram_data = NULL;
+    cartridge_update_banks(cartridge);
+    munmap(save->mapping, save->map_size);
+    close(save->fd);
+#else
+    FILE* save_file = fopen(save->path, "wb");
+    if (save_file == NULL || !cartridge->mapper->save(cartridge, save_file)) {
+        BATTERY_ERROR_PRINT("Failed to write save file: %s\n", save->path);
+    }
+    if (save_file != NULL) {
+        fclose(save_file);
+    }
+#endif
+    free(save->path);
+    free(save);
+}
@@ -0,0 +1,65 @@
+#ifndef GAMEBOY_BATTERY_H
+#define GAMEBOY_BATTERY_H
+
+#include <pthread.h>
+
+#include "general.h"
+
+struct Cartridge;
+
+extern struct EmulatorConfig config;
+
+// Battery save debug print
+#define BATTERY_DEBUG_PRINT(fmt, ...)                               \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("BAT: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+#define BATTERY_ERROR_PRINT(fmt, ...) \
+    {                                 \
+        PRINT_TIME_IN_SECONDS();      \
+        PRINT_LEVEL(ERROR_LEVEL);     \
+        printf("BAT: ");              \
+        printf(fmt, ##__VA_ARGS__);   \
+    }
+
+// Default milliseconds between two flushes of the save file
+#define BATTERY_FLUSH_INTERVAL 1000
+
+// Battery backed cartridge RAM kept in a .sav file next to the ROM.
+// The save file is mapped shared and becomes the cartridge RAM itself, so a write from the game is
+// a plain store: the kernel holds the dirty pages even if the emulator crashes. A flush thread
+// writes them back every flush_interval milliseconds and once more when the save is freed, the
+// emulation thread never waits on the disk.
+// Without mmap (Windows) the save is read into the RAM on creation and written back on free.
+struct BatterySave
+{
+    struct Cartridge* cartridge;
+    char*             path;
+
+    int      fd;
+    uint8_t* mapping;    // cartridge->ram_data while mapped
+    size_t   size;       // bytes backed by the file, cartridge->ram_size
+    size_t   map_size;   // bytes mapped, the tail past size is anonymous
+
+    int             flush_interval;   // ms, 0 flushes only when the save is freed
+    pthread_t       thread;
+    bool            thread_running;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake_up;
+    bool            stopping;
+};
+
+// save file path for a ROM: its extension replaced by .sav, caller frees
+char* battery_save_path(const char* rom_path);
+// back the cartridge RAM with the save file of rom_path, NULL if the cartridge keeps heap RAM
+struct BatterySave* create_battery_save(struct Cartridge* cartridge, const char* rom_path,
+                                        int flush_interval);
+// write the save file a last time, then hand the cartridge RAM back (ram_data is NULL afterwards
+// when it was mapped)
+void free_battery_save(struct BatterySave* save);
+
+#endif
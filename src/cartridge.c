@@ -1,6 +1,7 @@
 #include "cartridge.h"
 
-bool load_cartridge(struct Cartridge* cartridge, const char* rom_path)
+// Read the whole ROM into a private heap buffer, for hosts without mmap
+static bool cartridge_read_rom(struct Cartridge* cartridge, const char* rom_path)
 {
     FILE* rom_file = fopen(rom_path, "rb");
     if (rom_file == NULL) {
@@ -8,14 +9,6 @@ bool load_cartridge(struct Cartridge* cartridge, const char* rom_path)
         return false;
     }
 
-    // Get file size
-    fseek(rom_file, 0, SEEK_END);
-    cartridge->rom_size = ftell(rom_file);
-    fseek(rom_file, 0, SEEK_SET);
-
-    CARTRIDGE_INFO_PRINT("ROM file size: %zu bytes\n", cartridge->rom_size);
-
-    // Allocate memory for ROM
     cartridge->rom_data = malloc(cartridge->rom_size);
     if (cartridge->rom_data == NULL) {
         CARTRIDGE_ERROR_PRINT("Failed to allocate memory for ROM\n");
@@ -23,17 +16,56 @@ bool load_cartridge(struct Cartridge* cartridge, const char* rom_path)
         return false;
     }
 
-    // Read ROM data
     size_t bytes_read = fread(cartridge->rom_data, 1, cartridge->rom_size, rom_file);
+    fclose(rom_file);
     if (bytes_read != cartridge->rom_size) {
         CARTRIDGE_ERROR_PRINT("Failed to read complete ROM file\n");
         free(cartridge->rom_data);
         cartridge->rom_data = NULL;
-        fclose(rom_file);
         return false;
     }
+    cartridge->rom_mapped = false;
+    return true;
+}
 
-    fclose(rom_file);
+bool load_cartridge(struct Cartridge* cartridge, const char* rom_path)
+{
+    struct stat rom_stat;
+    if (stat(rom_path, &rom_stat) != 0) {
+        CARTRIDGE_ERROR_PRINT("Failed to open ROM file: %s\n", rom_path);
+        return false;
+    }
+
+    // the header is read right away, anything shorter is not a cartridge
+    if (rom_stat.st_size < GAMEBOY_CARTRIDGE_HEADER_END) {
+        CARTRIDGE_ERROR_PRINT("ROM file too small: %lld bytes\n", (long long)rom_stat.st_size);
+        return false;
+    }
+    cartridge->rom_size = (size_t)rom_stat.st_size;
+
+    CARTRIDGE_INFO_PRINT("ROM file size: %zu bytes\n", cartridge->rom_size);
+
+    cartridge->rom_data = NULL;
+#ifndef _WIN32
+    // Map the ROM read only: pages are faulted in on first access and, being clean file pages,
+    // are shared through the page cache by every instance running the same ROM
+    int rom_fd = open(rom_path, O_RDONLY);
+    if (rom_fd >= 0) {
+        void* mapping = mmap(NULL, cartridge->rom_size, PROT_READ, MAP_PRIVATE, rom_fd, 0);
+        // the mapping stays valid after the descriptor is closed
+        close(rom_fd);
+        if (mapping != MAP_FAILED) {
+            cartridge->rom_data   = mapping;
+            cartridge->rom_mapped = true;
+        }
+    }
+    if (cartridge->rom_data == NULL) {
+        CARTRIDGE_DEBUG_PRINT("mmap failed, reading ROM into memory instead\n");
+    }
+#endif
+    if (cartridge->rom_data == NULL && !cartridge_read_rom(cartridge, rom_path)) {
+        return false;
+    }
 
     // Extract ROM name from header
     strncpy((char*)cartridge->rom_name, (char*)(cartridge->rom_data + 0x134), 16);
@@ -42,17 +74,37 @@ bool load_cartridge(struct Cartridge* cartridge, const char* rom_path)
     CARTRIDGE_INFO_PRINT("ROM loaded successfully. Name: %s\n", cartridge->rom_name);
 
     // check cartridge type
-    return check_cartridge_type(cartridge);
+    if (!check_cartridge_type(cartridge)) {
+        return false;
+    }
+
+    // battery backed RAM lives in a save file next to the ROM
+    if (cartridge->battery) {
+        cartridge->battery_save = create_battery_save(cartridge, rom_path, config.save_interval);
+    }
+    return true;
 }
 
 void free_cartridge(struct Cartridge* cartridge)
 {
     if (cartridge) {
-        // Free dynamically allocated ROM data
+        // Release the ROM image, mapped or read
         if (cartridge->rom_data) {
+#ifndef _WIN32
+            if (cartridge->rom_mapped) {
+                munmap(cartridge->rom_data, cartridge->rom_size);
+            }
+            else {
+                free(cartridge->rom_data);
+            }
+#else
             free(cartridge->rom_data);
+#endif
             cartridge->rom_data = NULL;
         }
+        // the last save flush, leaves ram_data NULL when it was the mapped file
+        free_battery_save(cartridge->battery_save);
+        free(cartridge->ram_data);
         free(cartridge);
     }
 }
@@ -71,27 +123,39 @@ struct Cartridge* create_cartridge()
     cartridge->ram_attributes_bank_count = 0;
     cartridge->ram_attributes_bank_size  = 0;   // in kb
 
+    // Nothing mapped until a ROM is loaded
+    cartridge->rom_bank_0 = NULL;
+    cartridge->rom_bank_1 = NULL;
+    cartridge->ram        = NULL;
+
     // Initialize dynamic ROM fields
-    cartridge->rom_data = NULL;
-    cartridge->rom_size = 0;
+    cartridge->rom_data   = NULL;
+    cartridge->rom_size   = 0;
+    cartridge->rom_mapped = false;
 
     // Initialize dynamic RAM fields
-    cartridge->ram_data = NULL;
-    cartridge->ram_size = 0;
+    cartridge->ram_data    = NULL;
+    cartridge->ram_size    = 0;
+    cartridge->ram_enabled = false;
 
-    // Initialize MBC2 internal RAM
-    memset(cartridge->mbc2_ram, 0, sizeof(cartridge->mbc2_ram));
+    // MBC2 internal RAM lives in ram_data as well
     cartridge->mbc2_ram_enabled = false;
 
+    // No battery until the cartridge type says so
+    cartridge->battery      = false;
+    cartridge->battery_save = NULL;
+
     // Initialize controller type
     cartridge->controller_type = CONTROLLER_ROM_ONLY;
-
-    // Initialize MBC5 extended ROM banking
-    cartridge->mbc5_rom_bank = 1;
+    cartridge->mapper          = &mapper_rom_only;
 
     // Initialize rumble motor
     cartridge->rumble_motor_on = false;
 
+    // No MMU attached yet
+    cartridge->mmu            = NULL;
+    cartridge->on_bank_switch = NULL;
+
     // set method pointers
     cartridge->check_cartridge_type = check_cartridge_type;
     cartridge->create_cartridge     = create_cartridge;
@@ -105,9 +169,45 @@ struct Cartridge* create_cartridge()
     cartridge->get_rom_bank        = cartridge_get_rom_bank;
     cartridge->get_ram_bank        = cartridge_get_ram_bank;
     cartridge->get_rom_name        = cartridge_get_rom_name;
+    cartridge->get_cartridge_page  = cartridge_get_cartridge_page;
     return cartridge;
 }
 
+void cartridge_update_banks(struct Cartridge* cartridge)
+{
+    cartridge->rom_bank_0 = cartridge->rom_data;
+
+    // banks past the end of the ROM wrap around, like the unconnected upper bank lines
+    size_t rom_banks      = cartridge->rom_size / GAMEBOY_BANK_SIZE;
+    cartridge->rom_bank_1 = NULL;
+    if (cartridge->rom_data != NULL && rom_banks >= 2) {
+        size_t bank           = cartridge->rom_alternative_bank % rom_banks;
+        cartridge->rom_bank_1 = cartridge->rom_data + bank * GAMEBOY_BANK_SIZE;
+    }
+
+    // MBC2 never sets ram_enabled, its nibble RAM is not byte addressable and keeps its handlers
+    cartridge->ram = NULL;
+    if (cartridge->ram_enabled && cartridge->ram_data != NULL) {
+        size_t ram_banks = cartridge->ram_size / GAMEBOY_RAM_BANK_SIZE;
+        size_t bank      = ram_banks > 1 ? cartridge->ram_alternative_bank % ram_banks : 0;
+        cartridge->ram   = cartridge->ram_data + bank * GAMEBOY_RAM_BANK_SIZE;
+    }
+}
+
+static bool cartridge_has_battery(uint8_t controller_type)
+{
+    switch (controller_type) {
+    case CONTROLLER_MBC1_RAM_BATTERY:
+    case CONTROLLER_MBC2_BATTERY:
+    case CONTROLLER_MBC3_TIMER_BATTERY:
+    case CONTROLLER_MBC3_TIMER_RAM_BATTERY:
+    case CONTROLLER_MBC3_RAM_BATTERY:
+    case CONTROLLER_MBC5_RAM_BATTERY:
+    case CONTROLLER_MBC5_RUMBLE_RAM_BATTERY: return true;
+    default: return false;
+    }
+}
+
 bool check_cartridge_type(struct Cartridge* cartridge)
 {
     // Store controller type
@@ -116,54 +216,71 @@ bool check_cartridge_type(struct Cartridge* cartridge)
     switch (cartridge->controller_type) {
     case CONTROLLER_ROM_ONLY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM only (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_rom_only;
         break;
     case CONTROLLER_MBC1:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC1 (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc1;
         break;
     case CONTROLLER_MBC1_RAM:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC1 + RAM (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc1;
         break;
     case CONTROLLER_MBC1_RAM_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC1 + RAM + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc1;
         break;
     case CONTROLLER_MBC2:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC2 (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc2;
         break;
     case CONTROLLER_MBC2_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC2 + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc2;
         break;
     case CONTROLLER_MBC3_TIMER_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC3 + TIMER + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc3;
         break;
     case CONTROLLER_MBC3_TIMER_RAM_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC3 + TIMER + RAM + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc3;
         break;
     case CONTROLLER_MBC3:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC3 (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc3;
         break;
     case CONTROLLER_MBC3_RAM:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC3 + RAM (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc3;
         break;
     case CONTROLLER_MBC3_RAM_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC3 + RAM + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc3;
         break;
     case CONTROLLER_MBC5:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5;
         break;
     case CONTROLLER_MBC5_RAM:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 + RAM (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5;
         break;
     case CONTROLLER_MBC5_RAM_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 + RAM + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5;
         break;
     case CONTROLLER_MBC5_RUMBLE:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 + RUMBLE (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5_rumble;
         break;
     case CONTROLLER_MBC5_RUMBLE_RAM:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 + RUMBLE + RAM (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5_rumble;
         break;
     case CONTROLLER_MBC5_RUMBLE_RAM_BATTERY:
         CARTRIDGE_DEBUG_PRINT("Cartridge Type: ROM + MBC5 + RUMBLE + RAM + BATTERY (0x%02x)\n", cartridge->controller_type);
+        cartridge->mapper = &mapper_mbc5_rumble;
         break;
     default:
         CARTRIDGE_DEBUG_PRINT("Unsupported Cartridge Type: (0x%02x)\n", cartridge->controller_type);
@@ -236,39 +353,50 @@ bool check_cartridge_type(struct Cartridge* cartridge)
     }
 
     // MBC2 has internal RAM regardless of the RAM size byte
-    if (cartridge->controller_type == CONTROLLER_MBC2 || cartridge->controller_type == CONTROLLER_MBC2_BATTERY) {
+    if (cartridge->mapper == &mapper_mbc2) {
         CARTRIDGE_DEBUG_PRINT("MBC2: Using internal 512x4bit RAM\n");
-        // MBC2 internal RAM is already allocated in the struct
+        cartridge->ram_size = MBC2_RAM_SIZE;
     } else if (cartridge->ram_attributes_bank_count > 0) {
         CARTRIDGE_DEBUG_PRINT("RAM Banks: %d with size %dKB each\n",
                              cartridge->ram_attributes_bank_count,
                              cartridge->ram_attributes_bank_size);
-        
-        // Allocate memory for external RAM
         cartridge->ram_size = cartridge->ram_attributes_bank_count * cartridge->ram_attributes_bank_size * 1024;
-        cartridge->ram_data = malloc(cartridge->ram_size);
+    } else {
+        CARTRIDGE_DEBUG_PRINT("No external RAM\n");
+    }
+
+    // Allocate memory for the RAM, battery backed RAM is moved to its save file later
+    if (cartridge->ram_size > 0) {
+        cartridge->ram_data = calloc(cartridge_ram_alloc_size(cartridge->ram_size), 1);
         if (cartridge->ram_data == NULL) {
             CARTRIDGE_ERROR_PRINT("Failed to allocate memory for RAM\n");
             return false;
         }
-        memset(cartridge->ram_data, 0, cartridge->ram_size);
-    } else {
-        CARTRIDGE_DEBUG_PRINT("No external RAM\n");
     }
+    cartridge->battery = cartridge_has_battery(cartridge->controller_type);
 
+    cartridge_update_banks(cartridge);
     return true;
 }
 
-void cartridge_set_rom_bank(struct Cartridge* cartridge, uint8_t bank)
+// recompute the bank pointers, and let the MMU repoint its page table only if one of them moved
+static void cartridge_switch_banks(struct Cartridge* cartridge)
+{
+    uint8_t* rom_bank_1 = cartridge->rom_bank_1;
+    uint8_t* ram        = cartridge->ram;
+    cartridge_update_banks(cartridge);
+    bool switched = cartridge->rom_bank_1 != rom_bank_1 || cartridge->ram != ram;
+    if (switched && cartridge->on_bank_switch) {
+        cartridge->on_bank_switch(cartridge->mmu);
+    }
+}
+
+void cartridge_set_rom_bank(struct Cartridge* cartridge, uint16_t bank)
 {
     // MBC1 constraint: Bank 0 cannot be selected for upper region
     // But MBC5 can select bank 0 for upper region
-    if (bank == 0 
-        && cartridge->controller_type != CONTROLLER_MBC5
-        && cartridge->controller_type != CONTROLLER_MBC5_RUMBLE
-        && cartridge->controller_type != CONTROLLER_MBC5_RUMBLE_RAM
-        && cartridge->controller_type != CONTROLLER_MBC5_RUMBLE_RAM_BATTERY
-    ) {
+    bool is_mbc5 = cartridge->mapper == &mapper_mbc5 || cartridge->mapper == &mapper_mbc5_rumble;
+    if (bank == 0 && !is_mbc5) {
         bank = 1;
     }
     
@@ -279,9 +407,10 @@ void cartridge_set_rom_bank(struct Cartridge* cartridge, uint8_t bank)
     }
     
     cartridge->rom_alternative_bank = bank;
+    cartridge_switch_banks(cartridge);
 }
 
-uint8_t cartridge_get_rom_bank(struct Cartridge* cartridge)
+uint16_t cartridge_get_rom_bank(struct Cartridge* cartridge)
 {
     return cartridge->rom_alternative_bank;
 }
@@ -289,6 +418,7 @@ uint8_t cartridge_get_rom_bank(struct Cartridge* cartridge)
 void cartridge_set_ram_bank(struct Cartridge* cartridge, uint8_t bank)
 {
     cartridge->ram_alternative_bank = bank;
+    cartridge_switch_banks(cartridge);
 }
 
 uint8_t cartridge_get_ram_bank(struct Cartridge* cartridge)
@@ -296,297 +426,70 @@ uint8_t cartridge_get_ram_bank(struct Cartridge* cartridge)
     return cartridge->ram_alternative_bank;
 }
 
-// MBC1 handler
-static void cartridge_handle_mbc1_write(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+uint8_t mapper_read_rom(struct Cartridge* cartridge, uint16_t address)
 {
-    if (address >= 0x0000 && address <= 0x1FFF) {
-        // RAM Enable (0x0A enables, anything else disables)
-        if ((byte & 0x0F) == 0x0A) {
-            cartridge->ram_enabled = true;
-            CARTRIDGE_DEBUG_PRINT("MBC1: RAM Enabled\n");
-        }
-        else {
-            cartridge->ram_enabled = false;
-            CARTRIDGE_DEBUG_PRINT("MBC1: RAM Disabled\n");
+    // 0x0000-0x3FFF is always ROM bank 0, a ROM file shorter than a bank reads 0xFF past its end
+    if (address <= 0x3FFF) {
+        if (address >= cartridge->rom_size) {
+            return 0xFF;
         }
+        return cartridge->rom_bank_0[address];
     }
-    else if (address >= 0x2000 && address <= 0x3FFF) {
-        // ROM Bank Number (lower 5 bits)
-        uint8_t bank = byte & 0x1F;
-        
-        // MBC1 quirk: Bank 0 cannot be selected, defaults to bank 1
-        if (bank == 0) {
-            bank = 1;
-        }
-        
-        // Bounds check
-        if (bank >= cartridge->rom_attributes_bank_count) {
-            bank = bank % cartridge->rom_attributes_bank_count;
-            if (bank == 0) bank = 1; // Ensure we don't wrap to bank 0
-        }
-
-        cartridge->rom_alternative_bank = bank;
-        CARTRIDGE_DEBUG_PRINT("MBC1: ROM Bank set to %d\n", bank);
-    }
-    else if (address >= 0x4000 && address <= 0x5FFF) {
-        // RAM Bank Number OR Upper ROM Bank bits
-        uint8_t bank = byte & 0x03;
-        cartridge->ram_alternative_bank = bank;
-        CARTRIDGE_DEBUG_PRINT("MBC1: RAM Bank set to %d\n", bank);
-    }
-    else if (address >= 0x6000 && address <= 0x7FFF) {
-        // Banking Mode Select (0 = ROM mode, 1 = RAM mode)
-        CARTRIDGE_DEBUG_PRINT("MBC1: Banking mode: %s\n", 
-                             (byte & 0x01) ? "RAM mode" : "ROM mode");
-    }
-    else if (address >= 0xA000 && address <= 0xBFFF) {
-        if (!cartridge->ram_enabled || cartridge->ram_data == NULL) {
-            return;
-        }
-        // Calculate correct RAM bank address
-        uint32_t bank_address = (address - 0xA000) + (cartridge->ram_alternative_bank * 0x2000);
-        if (bank_address < cartridge->ram_size) {
-            cartridge->ram_data[bank_address] = byte;
-        }
+    // 0x4000-0x7FFF is switchable ROM bank
+    if (cartridge->rom_bank_1 == NULL) {
+        CARTRIDGE_ERROR_PRINT("ROM access out of bounds: 0x%04x (size: 0x%08x)\n", address,
+                              (uint32_t)cartridge->rom_size);
+        return 0xFF;
     }
+    return cartridge->rom_bank_1[address - 0x4000];
 }
 
-// MBC2 handler
-static void cartridge_handle_mbc2_write(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+uint8_t mapper_read_ram(struct Cartridge* cartridge, uint16_t address)
 {
-    if (address >= 0x0000 && address <= 0x3FFF) {
-        // Check the least significant bit of the upper address byte
-        if ((address & 0x0100) == 0x0000) {
-            // RAM Enable/Disable (bit 8 = 0)
-            if ((byte & 0x0F) == 0x0A) {
-                cartridge->mbc2_ram_enabled = true;
-                CARTRIDGE_DEBUG_PRINT("MBC2: RAM Enabled\n");
-            }
-            else {
-                cartridge->mbc2_ram_enabled = false;
-                CARTRIDGE_DEBUG_PRINT("MBC2: RAM Disabled\n");
-            }
-        }
-        else {
-            // ROM Bank Selection (bit 8 = 1)
-            uint8_t bank = byte & 0x0F; // Only 4 bits for MBC2
-            
-            // MBC2 quirk: Bank 0 cannot be selected, defaults to bank 1
-            if (bank == 0) {
-                bank = 1;
-            }
-            
-            // MBC2 supports up to 16 banks (2Mbit)
-            if (bank >= cartridge->rom_attributes_bank_count) {
-                bank = bank % cartridge->rom_attributes_bank_count;
-                if (bank == 0) bank = 1;
-            }
-            
-            cartridge->rom_alternative_bank = bank;
-            CARTRIDGE_DEBUG_PRINT("MBC2: ROM Bank set to %d\n", bank);
-        }
-    }
-    else if (address >= 0xA000 && address <= 0xBFFF) {
-        if (!cartridge->mbc2_ram_enabled) {
-            return;
-        }
-        
-        // MBC2 has 512 x 4-bit RAM (0xA000-0xA1FF, only lower 4 bits)
-        uint16_t ram_address = address & 0x01FF; // Mask to 512 bytes
-        if (ram_address < 256) {
-            cartridge->mbc2_ram[ram_address] = byte & 0x0F; // Only store lower 4 bits
-            CARTRIDGE_TRACE_PRINT("MBC2: RAM write to 0x%04x = 0x%02x\n", ram_address, byte & 0x0F);
-        }
+    // NULL while disabled or absent
+    if (cartridge->ram == NULL) {
+        return 0xFF;
     }
+    return cartridge->ram[address - 0xA000];
 }
 
-// MBC3 handler
-static void cartridge_handle_mbc3_write(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+void mapper_write_ram(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
 {
-    if (address >= 0x0000 && address <= 0x1FFF) {
-        // RAM Enable (0x0A enables, anything else disables)
-        if ((byte & 0x0F) == 0x0A) {
-            cartridge->ram_enabled = true;
-            CARTRIDGE_DEBUG_PRINT("MBC3: RAM Enabled\n");
-        }
-        else {
-            cartridge->ram_enabled = false;
-            CARTRIDGE_DEBUG_PRINT("MBC3: RAM Disabled\n");
-        }
-    }
-    else if (address >= 0x2000 && address <= 0x3FFF) {
-        // ROM Bank Number (7 bits)
-        uint8_t bank = byte & 0x7F;
-        
-        // MBC3 quirk: Bank 0 cannot be selected, defaults to bank 1
-        if (bank == 0) {
-            bank = 1;
-        }
-        
-        // Bounds check
-        if (bank >= cartridge->rom_attributes_bank_count) {
-            bank = bank % cartridge->rom_attributes_bank_count;
-            if (bank == 0) bank = 1;
-        }
-        
-        cartridge->rom_alternative_bank = bank;
-        CARTRIDGE_DEBUG_PRINT("MBC3: ROM Bank set to %d\n", bank);
-    }
-    else if (address >= 0x4000 && address <= 0x5FFF) {
-        // RAM Bank Number (0x00-0x03) or RTC Register Select (0x08-0x0C)
-        if (byte <= 0x03) {
-            cartridge->ram_alternative_bank = byte;
-            CARTRIDGE_DEBUG_PRINT("MBC3: RAM Bank set to %d\n", byte);
-        }
-        else if (byte >= 0x08 && byte <= 0x0C) {
-            // RTC register selection - not implemented yet
-            CARTRIDGE_DEBUG_PRINT("MBC3: RTC register 0x%02x selected (not implemented)\n", byte);
-        }
-    }
-    else if (address >= 0x6000 && address <= 0x7FFF) {
-        // Latch Clock Data - not implemented yet
-        CARTRIDGE_DEBUG_PRINT("MBC3: Clock latch command (not implemented)\n");
-    }
-    else if (address >= 0xA000 && address <= 0xBFFF) {
-        if (!cartridge->ram_enabled || cartridge->ram_data == NULL) {
-            return;
-        }
-        // Calculate correct RAM bank address
-        uint32_t bank_address = (address - 0xA000) + (cartridge->ram_alternative_bank * 0x2000);
-        if (bank_address < cartridge->ram_size) {
-            cartridge->ram_data[bank_address] = byte;
-        }
+    if (cartridge->ram != NULL) {
+        cartridge->ram[address - 0xA000] = byte;
     }
 }
 
-// MBC5 handler  
-static void cartridge_handle_mbc5_write(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+void mapper_write_ram_enable(struct Cartridge* cartridge, uint8_t byte)
 {
-    if (address >= 0x0000 && address <= 0x1FFF) {
-        // RAM Enable (0x0A enables, anything else disables)
-        if ((byte & 0x0F) == 0x0A) {
-            cartridge->ram_enabled = true;
-            CARTRIDGE_DEBUG_PRINT("MBC5: RAM Enabled\n");
-        }
-        else {
-            cartridge->ram_enabled = false;
-            CARTRIDGE_DEBUG_PRINT("MBC5: RAM Disabled\n");
-        }
-    }
-    else if (address >= 0x2000 && address <= 0x2FFF) {
-        // ROM Bank Number (lower 8 bits)
-        cartridge->mbc5_rom_bank = (cartridge->mbc5_rom_bank & 0x0100) | byte;
-        CARTRIDGE_DEBUG_PRINT("MBC5: ROM Bank set to %d\n", cartridge->mbc5_rom_bank);
-    }
-    else if (address >= 0x3000 && address <= 0x3FFF) {
-        // ROM Bank Number (upper bit)
-        cartridge->mbc5_rom_bank = (cartridge->mbc5_rom_bank & 0x00FF) | ((byte & 0x01) << 8);
-        CARTRIDGE_DEBUG_PRINT("MBC5: ROM Bank set to %d\n", cartridge->mbc5_rom_bank);
-    }
-    else if (address >= 0x4000 && address <= 0x5FFF) {
-        // RAM Bank Number (and rumble motor for rumble carts)
-        bool is_rumble_cart = (cartridge->controller_type == CONTROLLER_MBC5_RUMBLE ||
-                              cartridge->controller_type == CONTROLLER_MBC5_RUMBLE_RAM ||
-                              cartridge->controller_type == CONTROLLER_MBC5_RUMBLE_RAM_BATTERY);
-                              
-        if (is_rumble_cart) {
-            // Rumble motor control (bit 3) and RAM bank (bits 0-2)
-            bool motor_on = (byte & 0x08) != 0;
-            if (motor_on != cartridge->rumble_motor_on) {
-                cartridge->rumble_motor_on = motor_on;
-                CARTRIDGE_WARN_PRINT("MBC5: Rumble motor %s\n", motor_on ? "ON" : "OFF");
-            }
-            cartridge->ram_alternative_bank = byte & 0x07;
-        }
-        else {
-            // Regular RAM bank selection (4 bits)
-            cartridge->ram_alternative_bank = byte & 0x0F;
-        }
-        CARTRIDGE_DEBUG_PRINT("MBC5: RAM Bank set to %d\n", cartridge->ram_alternative_bank);
+    cartridge->ram_enabled = (byte & 0x0F) == 0x0A;
+    CARTRIDGE_DEBUG_PRINT("%s: RAM %s\n", cartridge->mapper->name,
+                          cartridge->ram_enabled ? "Enabled" : "Disabled");
+}
+
+bool mapper_save_ram(struct Cartridge* cartridge, FILE* file)
+{
+    if (cartridge->ram_data == NULL) {
+        return true;
     }
-    else if (address >= 0xA000 && address <= 0xBFFF) {
-        if (!cartridge->ram_enabled || cartridge->ram_data == NULL) {
-            return;
-        }
-        // Calculate correct RAM bank address
-        uint32_t bank_address = (address - 0xA000) + (cartridge->ram_alternative_bank * 0x2000);
-        if (bank_address < cartridge->ram_size) {
-            cartridge->ram_data[bank_address] = byte;
-        }
+    return fwrite(cartridge->ram_data, 1, cartridge->ram_size, file) == cartridge->ram_size;
+}
+
+bool mapper_load_ram(struct Cartridge* cartridge, FILE* file)
+{
+    if (cartridge->ram_data == NULL) {
+        return true;
     }
+    return fread(cartridge->ram_data, 1, cartridge->ram_size, file) == cartridge->ram_size;
 }
 
 uint8_t cartridge_get_cartridge_byte(struct Cartridge* cartridge, uint16_t address)
 {
-    // 0x0000-0x3FFF is always ROM bank 0
-    if (address <= 0x3FFF) {
-        return cartridge->rom_data[address];
-    }
-    // 0x4000-0x7FFF is switchable ROM bank
-    else if (address >= 0x4000 && address <= 0x7FFF) {
-        uint16_t rom_bank;
-        
-        // Determine which ROM bank to use based on controller type
-        switch (cartridge->controller_type) {
-        case CONTROLLER_MBC5:
-        case CONTROLLER_MBC5_RAM:
-        case CONTROLLER_MBC5_RAM_BATTERY:
-        case CONTROLLER_MBC5_RUMBLE:
-        case CONTROLLER_MBC5_RUMBLE_RAM:
-        case CONTROLLER_MBC5_RUMBLE_RAM_BATTERY:
-            rom_bank = cartridge->mbc5_rom_bank;
-            break;
-        default:
-            rom_bank = cartridge->rom_alternative_bank;
-            break;
-        }
-        
-        // Calculate correct ROM bank address
-        uint32_t bank_address = (address - 0x4000) + (rom_bank * 0x4000);
-        
-        // Bounds check
-        if (bank_address >= cartridge->rom_size) {
-            CARTRIDGE_ERROR_PRINT("ROM access out of bounds: 0x%08x (size: 0x%08x)\n", 
-                                 bank_address, (uint32_t)cartridge->rom_size);
-            return 0xFF;
-        }
-        
-        return cartridge->rom_data[bank_address];
+    if (address <= 0x7FFF) {
+        return cartridge->mapper->read_rom(cartridge, address);
     }
-    // 0xA000-0xBFFF is RAM area
     else if (address >= 0xA000 && address <= 0xBFFF) {
-        // Handle MBC2 internal RAM
-        if (cartridge->controller_type == CONTROLLER_MBC2 || cartridge->controller_type == CONTROLLER_MBC2_BATTERY) {
-            if (!cartridge->mbc2_ram_enabled) {
-                return 0xFF;
-            }
-            
-            // MBC2 has 512 x 4-bit RAM (0xA000-0xA1FF, only lower 4 bits)
-            uint16_t ram_address = address & 0x01FF; // Mask to 512 bytes
-            if (ram_address < 256) {
-                return cartridge->mbc2_ram[ram_address] | 0xF0; // Upper 4 bits always set
-            }
-            return 0xFF;
-        }
-        
-        // Handle external RAM for other controllers
-        if (!cartridge->ram_enabled) {
-            return 0xFF;
-        }
-        
-        if (cartridge->ram_data == NULL) {
-            return 0xFF;
-        }
-        
-        // Calculate correct RAM bank address
-        uint32_t bank_address = (address - 0xA000) + (cartridge->ram_alternative_bank * 0x2000);
-        
-        // Bounds check
-        if (bank_address >= cartridge->ram_size) {
-            return 0xFF;
-        }
-        
-        return cartridge->ram_data[bank_address];
+        return cartridge->mapper->read_ram(cartridge, address);
     }
     else {
         CARTRIDGE_DEBUG_PRINT("Trying to access invalid address: 0x%04x\n", address);
@@ -596,67 +499,22 @@ uint8_t cartridge_get_cartridge_byte(struct Cartridge* cartridge, uint16_t addre
 
 void cartridge_set_cartridge_byte(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
 {
-    switch (cartridge->controller_type) {
-    case CONTROLLER_ROM_ONLY:
-        // ROM only - no banking, just ignore writes to control areas
-        break;
-        
-    case CONTROLLER_MBC1:
-    case CONTROLLER_MBC1_RAM:
-    case CONTROLLER_MBC1_RAM_BATTERY:
-        cartridge_handle_mbc1_write(cartridge, address, byte);
-        break;
-        
-    case CONTROLLER_MBC2:
-    case CONTROLLER_MBC2_BATTERY:
-        cartridge_handle_mbc2_write(cartridge, address, byte);
-        break;
-        
-    case CONTROLLER_MBC3:
-    case CONTROLLER_MBC3_RAM:
-    case CONTROLLER_MBC3_RAM_BATTERY:
-    case CONTROLLER_MBC3_TIMER_BATTERY:
-    case CONTROLLER_MBC3_TIMER_RAM_BATTERY:
-        cartridge_handle_mbc3_write(cartridge, address, byte);
-        break;
-        
-    case CONTROLLER_MBC5:
-    case CONTROLLER_MBC5_RAM:
-    case CONTROLLER_MBC5_RAM_BATTERY:
-    case CONTROLLER_MBC5_RUMBLE:
-    case CONTROLLER_MBC5_RUMBLE_RAM:
-    case CONTROLLER_MBC5_RUMBLE_RAM_BATTERY:
-        cartridge_handle_mbc5_write(cartridge, address, byte);
-        break;
-        
-    default:
-        CARTRIDGE_DEBUG_PRINT("Unsupported controller type for write: 0x%02x\n", cartridge->controller_type);
-        break;
+    // writes below 0x8000 hit MBC control registers and may switch banks
+    if (address <= 0x7FFF) {
+        cartridge->mapper->write_ctrl(cartridge, address, byte);
+        cartridge_switch_banks(cartridge);
+    }
+    else if (address >= 0xA000 && address <= 0xBFFF) {
+        cartridge->mapper->write_ram(cartridge, address, byte);
     }
 }
 
 uint16_t cartridge_get_cartridge_word(struct Cartridge* cartridge, uint16_t address)
 {
-    if (address <= 0x3FFF) {
-        // Bounds check for bank 0
-        if (address + 1 >= cartridge->rom_size) {
-            CARTRIDGE_ERROR_PRINT("ROM word access out of bounds: 0x%04x\n", address);
-            return 0xFFFF;
-        }
-        return cartridge->rom_data[address] | (cartridge->rom_data[address + 1] << 8);
-    }
-    else if (address >= 0x4000 && address <= 0x7FFF) {
-        // Calculate correct ROM bank address
-        uint32_t bank_address = (address - 0x4000) + (cartridge->rom_alternative_bank * 0x4000);
-        
-        // Bounds check
-        if (bank_address + 1 >= cartridge->rom_size) {
-            CARTRIDGE_ERROR_PRINT("ROM word access out of bounds: 0x%08x (size: 0x%08x)\n", 
-                                 bank_address, (uint32_t)cartridge->rom_size);
-            return 0xFFFF;
-        }
-        
-        return cartridge->rom_data[bank_address] | (cartridge->rom_data[bank_address + 1] << 8);
+    if (address <= 0x7FFE) {
+        // a word at 0x3FFF spans both banks, so go through the byte reads
+        return cartridge_get_cartridge_byte(cartridge, address) |
+               (cartridge_get_cartridge_byte(cartridge, address + 1) << 8);
     }
     else {
         CARTRIDGE_DEBUG_PRINT("Trying to access invalid ROM address: 0x%04x\n", address);
@@ -670,6 +528,30 @@ void cartridge_set_cartridge_word(struct Cartridge* cartridge, uint16_t address,
     // cartridge->rom[address + 1] = (word >> 8) & 0xFF;
 }
 
+uint8_t* cartridge_get_cartridge_page(struct Cartridge* cartridge, uint16_t address)
+{
+    // page aligned offset into the current bank
+    uint32_t page_offset = address & (0x4000 - CARTRIDGE_PAGE_SIZE);
+
+    // 0x0000-0x3FFF: ROM bank 0
+    if (address <= 0x3FFF) {
+        // a ROM shorter than a bank leaves its tail on the handler
+        if (cartridge->rom_bank_0 == NULL || page_offset + CARTRIDGE_PAGE_SIZE > cartridge->rom_size) {
+            return NULL;
+        }
+        return cartridge->rom_bank_0 + page_offset;
+    }
+    // 0x4000-0x7FFF: switchable ROM bank
+    else if (address <= 0x7FFF) {
+        return cartridge->rom_bank_1 ? cartridge->rom_bank_1 + page_offset : NULL;
+    }
+    // 0xA000-0xBFFF: external RAM, MBC2 nibble RAM always goes through the handler
+    else if (address >= 0xA000 && address <= 0xBFFF) {
+        return cartridge->ram ? cartridge->ram + (address & 0x1F00) : NULL;
+    }
+    return NULL;
+}
+
 char* cartridge_get_rom_name(struct Cartridge* cartridge)
 {
     return (char*)cartridge->rom_name;
@@ -2,10 +2,22 @@
 #define GAMEBOY_CARTRIDGE_H
 
 #include "general.h"
+#include "battery.h"
+#include "mapper.h"
+
+#include <sys/stat.h>
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#endif
 
-#define ROM_SIZE      524288
 #define ROM_NAME_SIZE 16
 
+// page size used by the MMU page table
+#define CARTRIDGE_PAGE_SIZE 0x100
+
+struct MMU;
+
 extern struct EmulatorConfig config;
 
 // Cartridge debug print with time
@@ -63,8 +75,14 @@ extern struct EmulatorConfig config;
 #define GAMEBOY_ROM_SIZE_ADDRESS 0x0148
 // Gameboy RAM size address
 #define GAMEBOY_RAM_SIZE_ADDRESS 0x0149
+// Gameboy cartridge header end (exclusive)
+#define GAMEBOY_CARTRIDGE_HEADER_END 0x0150
 // Gameboy bank size
 #define GAMEBOY_BANK_SIZE 0x4000
+// Gameboy external RAM bank size
+#define GAMEBOY_RAM_BANK_SIZE 0x2000
+// MBC2 internal RAM size, 512 x 4 bits
+#define MBC2_RAM_SIZE 512
 // Gameboy ROM name address
 #define GAMEBOY_ROM_NAME_ADDRESS 0x0134
 // Gameboy MBC1 magic number start address
@@ -93,39 +111,41 @@ extern struct EmulatorConfig config;
 
 struct Cartridge
 {
-    uint8_t* rom_bank_0;
-    uint8_t* rom_bank_1;
-    uint8_t* ram;
+    // bank base pointers, recomputed by cartridge_update_banks whenever the MBC switches banks
+    uint8_t* rom_bank_0;   // 0x0000-0x3FFF
+    uint8_t* rom_bank_1;   // 0x4000-0x7FFF, NULL when the ROM file has no second bank
+    uint8_t* ram;          // 0xA000-0xBFFF, NULL while external RAM is disabled or absent
 
-    // max possible size of ROM is 512kb
-    uint8_t rom[ROM_SIZE];
     // +1 for null terminator
     uint8_t rom_name[ROM_NAME_SIZE + 1];
 
-    // Dynamic ROM data (for larger ROMs)
+    // ROM image, mapped read only from the ROM file (read into memory where mmap is unavailable)
     uint8_t* rom_data;
     size_t   rom_size;
+    bool     rom_mapped;
 
-    // Dynamic RAM data (for cartridge RAMs)
+    // Dynamic RAM data (for cartridge RAMs), see cartridge_ram_alloc_size
     uint8_t* ram_data;
     size_t   ram_size;
     bool     ram_enabled;
 
-    // MBC2 internal RAM (512 x 4 bits)
-    uint8_t mbc2_ram[256];  // 512 nibbles stored as 256 bytes
-    bool    mbc2_ram_enabled;
+    // MBC2 internal RAM (512 x 4 bits) is kept in ram_data, one nibble per byte
+    bool mbc2_ram_enabled;
+
+    // battery backed RAM, kept in a save file next to the ROM
+    bool                battery;
+    struct BatterySave* battery_save;
 
     // Controller type
     uint8_t controller_type;
-
-    // MBC5 extended ROM banking
-    uint16_t mbc5_rom_bank;  // 9-bit ROM bank for MBC5
+    // handlers of the controller type, bound by check_cartridge_type
+    const struct Mapper* mapper;
 
     // Rumble motor (for rumble carts)
     bool rumble_motor_on;
 
-    // alternative ROM bank id
-    uint8_t rom_alternative_bank;
+    // alternative ROM bank id (9 bits on MBC5)
+    uint16_t rom_alternative_bank;
     // alternative RAM bank id
     uint8_t ram_alternative_bank;
     // ROM bank count
@@ -135,16 +155,21 @@ struct Cartridge
     // RAM bank size in kb
     uint8_t ram_attributes_bank_size;   // in kb
 
+    // MMU to notify when the mapped ROM/RAM banks change
+    struct MMU* mmu;
+    void (*on_bank_switch)(struct MMU*);
+
     // Method pointers
     uint8_t (*get_cartridge_byte)(struct Cartridge*, uint16_t);
     void (*set_cartridge_byte)(struct Cartridge*, uint16_t, uint8_t);
     uint16_t (*get_cartridge_word)(struct Cartridge*, uint16_t);
     void (*set_cartridge_word)(struct Cartridge*, uint16_t, uint16_t);
-    void (*set_rom_bank)(struct Cartridge*, uint8_t);
+    void (*set_rom_bank)(struct Cartridge*, uint16_t);
     void (*set_ram_bank)(struct Cartridge*, uint8_t);
-    uint8_t (*get_rom_bank)(struct Cartridge*);
+    uint16_t (*get_rom_bank)(struct Cartridge*);
     uint8_t (*get_ram_bank)(struct Cartridge*);
     char* (*get_rom_name)(struct Cartridge*);
+    uint8_t* (*get_cartridge_page)(struct Cartridge*, uint16_t);
     bool (*check_cartridge_type)(struct Cartridge*);
 
     // Constructor
@@ -163,13 +188,23 @@ bool load_cartridge(struct Cartridge* cartridge, const char* rom_path);
 void free_cartridge(struct Cartridge* cartridge);
 
 // set ROM bank
-void cartridge_set_rom_bank(struct Cartridge* cartridge, uint8_t bank);
+void cartridge_set_rom_bank(struct Cartridge* cartridge, uint16_t bank);
 
 // set RAM bank
 void cartridge_set_ram_bank(struct Cartridge* cartridge, uint8_t bank);
 
+// bytes allocated for ram_size bytes of RAM: a 2KB RAM still gets a whole bank so the bank
+// pointer covers 0xA000-0xBFFF without bounds checks
+static inline size_t cartridge_ram_alloc_size(size_t ram_size)
+{
+    return ram_size < GAMEBOY_RAM_BANK_SIZE ? GAMEBOY_RAM_BANK_SIZE : ram_size;
+}
+
+// recompute rom_bank_0/rom_bank_1/ram from the current bank registers
+void cartridge_update_banks(struct Cartridge* cartridge);
+
 // get ROM bank
-uint8_t cartridge_get_rom_bank(struct Cartridge* cartridge);
+uint16_t cartridge_get_rom_bank(struct Cartridge* cartridge);
 
 // get RAM bank
 uint8_t cartridge_get_ram_bank(struct Cartridge* cartridge);
@@ -186,6 +221,9 @@ uint16_t cartridge_get_cartridge_word(struct Cartridge* cartridge, uint16_t addr
 // set word at address
 void cartridge_set_cartridge_word(struct Cartridge* cartridge, uint16_t address, uint16_t word);
 
+// get host pointer to the page holding address, NULL if it has to go through the handlers
+uint8_t* cartridge_get_cartridge_page(struct Cartridge* cartridge, uint16_t address);
+
 // check cartridge type
 bool check_cartridge_type(struct Cartridge* cartridge);
 
@@ -0,0 +1,135 @@
+#include "compositor.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+void compositor_compose_scalar(uint8_t* out, const struct CompositorLine* line)
+{
+    for (int x = 0; x < COMPOSITOR_LINE_WIDTH; x++) {
+        uint8_t bg_color  = line->bg_enabled ? line->bg[x] : 0;
+        uint8_t obj_color = line->obj_color[x];
+        uint8_t obj_info  = line->obj_info[x];
+
+        uint8_t color   = bg_color;
+        uint8_t palette = line->bgp;
+        // a sprite pixel wins unless it is transparent, or behind a BG color other than 0
+        if (obj_color != 0 && (!(obj_info & COMPOSITOR_OBJ_BEHIND_BG) || bg_color == 0)) {
+            color   = obj_color;
+            palette = (obj_info & COMPOSITOR_OBJ_PALETTE_1) ? line->obp1 : line->obp0;
+        }
+        out[x] = (palette >> (color * 2)) & 0x03;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse2"))) void compositor_compose_sse2(uint8_t*                      out,
+                                                             const struct CompositorLine* line)
+{
+    const __m128i zero      = _mm_setzero_si128();
+    const __m128i three     = _mm_set1_epi8(0x03);
+    const __m128i one       = _mm_set1_epi8(0x01);
+    const __m128i two       = _mm_set1_epi8(0x02);
+    const __m128i behind    = _mm_set1_epi8((char)COMPOSITOR_OBJ_BEHIND_BG);
+    const __m128i palette_1 = _mm_set1_epi8(COMPOSITOR_OBJ_PALETTE_1);
+    const __m128i bgp       = _mm_set1_epi8(line->bgp);
+    const __m128i obp0      = _mm_set1_epi8(line->obp0);
+    const __m128i obp1      = _mm_set1_epi8(line->obp1);
+    const __m128i bg_mask   = _mm_set1_epi8(line->bg_enabled ? (char)0xFF : 0);
+
+    for (int x = 0; x < COMPOSITOR_LINE_WIDTH; x += 16) {
+        __m128i bg_color = _mm_and_si128(_mm_loadu_si128((const __m128i*)(line->bg + x)), bg_mask);
+        __m128i obj_color = _mm_loadu_si128((const __m128i*)(line->obj_color + x));
+        __m128i obj_info  = _mm_loadu_si128((const __m128i*)(line->obj_info + x));
+
+        // use_obj = obj_color != 0 && (!behind || bg_color == 0)
+        __m128i obj_transparent = _mm_cmpeq_epi8(obj_color, zero);
+        __m128i obj_in_front    = _mm_cmpeq_epi8(_mm_and_si128(obj_info, behind), zero);
+        __m128i bg_zero         = _mm_cmpeq_epi8(bg_color, zero);
+        __m128i use_obj = _mm_andnot_si128(obj_transparent, _mm_or_si128(obj_in_front, bg_zero));
+
+        __m128i obj_uses_obp1 = _mm_cmpeq_epi8(_mm_and_si128(obj_info, palette_1), palette_1);
+        __m128i obj_palette =
+            _mm_or_si128(_mm_and_si128(obj_uses_obp1, obp1), _mm_andnot_si128(obj_uses_obp1, obp0));
+        __m128i palette =
+            _mm_or_si128(_mm_and_si128(use_obj, obj_palette), _mm_andnot_si128(use_obj, bgp));
+        __m128i color =
+            _mm_or_si128(_mm_and_si128(use_obj, obj_color), _mm_andnot_si128(use_obj, bg_color));
+
+        // no per-byte variable shift in SSE2: pick one of the four 2 bit fields by compare.
+        // 16 bit shifts leak bits from the neighbouring byte into bits 6-7, the mask drops them
+        __m128i shade_0 = _mm_and_si128(palette, three);
+        __m128i shade_1 = _mm_and_si128(_mm_srli_epi16(palette, 2), three);
+        __m128i shade_2 = _mm_and_si128(_mm_srli_epi16(palette, 4), three);
+        __m128i shade_3 = _mm_and_si128(_mm_srli_epi16(palette, 6), three);
+        __m128i shade   = _mm_and_si128(_mm_cmpeq_epi8(color, zero), shade_0);
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, one), shade_1));
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, two), shade_2));
+        shade = _mm_or_si128(shade, _mm_and_si128(_mm_cmpeq_epi8(color, three), shade_3));
+
+        _mm_storeu_si128((__m128i*)(out + x), shade);
+    }
+}
+
+__attribute__((target("avx2"))) void compositor_compose_avx2(uint8_t*                      out,
+                                                             const struct CompositorLine* line)
+{
+    // 12 entry shade table indexed by palette * 4 + color: BGP, OBP0, OBP1
+    uint8_t table[16] = {0};
+    for (int color = 0; color < 4; color++) {
+        table[color]     = (line->bgp >> (color * 2)) & 0x03;
+        table[4 + color] = (line->obp0 >> (color * 2)) & 0x03;
+        table[8 + color] = (line->obp1 >> (color * 2)) & 0x03;
+    }
+    const __m256i shades    = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)table));
+    const __m256i zero      = _mm256_setzero_si256();
+    const __m256i behind    = _mm256_set1_epi8((char)COMPOSITOR_OBJ_BEHIND_BG);
+    const __m256i palette_1 = _mm256_set1_epi8(COMPOSITOR_OBJ_PALETTE_1);
+    const __m256i obp0_base = _mm256_set1_epi8(4);
+    const __m256i obp1_base = _mm256_set1_epi8(8);
+    const __m256i bg_mask   = _mm256_set1_epi8(line->bg_enabled ? (char)0xFF : 0);
+
+    // 160 = 5 * 32
+    for (int x = 0; x < COMPOSITOR_LINE_WIDTH; x += 32) {
+        __m256i bg_color =
+            _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(line->bg + x)), bg_mask);
+        __m256i obj_color = _mm256_loadu_si256((const __m256i*)(line->obj_color + x));
+        __m256i obj_info  = _mm256_loadu_si256((const __m256i*)(line->obj_info + x));
+
+        // use_obj = obj_color != 0 && (!behind || bg_color == 0)
+        __m256i obj_transparent = _mm256_cmpeq_epi8(obj_color, zero);
+        __m256i obj_in_front    = _mm256_cmpeq_epi8(_mm256_and_si256(obj_info, behind), zero);
+        __m256i bg_zero = _mm256_cmpeq_epi8(bg_color, zero);
+        __m256i use_obj =
+            _mm256_andnot_si256(obj_transparent, _mm256_or_si256(obj_in_front, bg_zero));
+
+        // table index: BG pixels use bg_color, sprite pixels 4 + color (OBP0) or 8 + color (OBP1)
+        __m256i obj_uses_obp1 =
+            _mm256_cmpeq_epi8(_mm256_and_si256(obj_info, palette_1), palette_1);
+        __m256i obj_index =
+            _mm256_add_epi8(obj_color, _mm256_blendv_epi8(obp0_base, obp1_base, obj_uses_obp1));
+        __m256i index = _mm256_blendv_epi8(bg_color, obj_index, use_obj);
+
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_shuffle_epi8(shades, index));
+    }
+}
+
+#endif
+
+compositor_fn compositor_select(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        COMPOSITOR_DEBUG_PRINT("Using AVX2 compositor%s", "\n");
+        return compositor_compose_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        COMPOSITOR_DEBUG_PRINT("Using SSE2 compositor%s", "\n");
+        return compositor_compose_sse2;
+    }
+#endif
+    COMPOSITOR_DEBUG_PRINT("Using scalar compositor%s", "\n");
+    return compositor_compose_scalar;
+}
@@ -0,0 +1,50 @@
+#ifndef GAMEBOY_COMPOSITOR_H
+#define GAMEBOY_COMPOSITOR_H
+
+#include "general.h"
+
+extern struct EmulatorConfig config;
+
+// Compositor debug print
+#define COMPOSITOR_DEBUG_PRINT(fmt, ...)                            \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("CMP: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+// Pixels per composited line, the SIMD paths need a multiple of 32
+#define COMPOSITOR_LINE_WIDTH 160
+
+// Sprite info byte, one per pixel next to the sprite color index
+#define COMPOSITOR_OBJ_BEHIND_BG 0x80   // OAM priority bit: behind BG colors 1-3
+#define COMPOSITOR_OBJ_PALETTE_1 0x40   // OAM palette bit: OBP1 instead of OBP0
+
+// One scanline worth of layers, all color indices are raw (0-3)
+struct CompositorLine
+{
+    const uint8_t* bg;          // BG/window color index per pixel
+    const uint8_t* obj_color;   // sprite color index per pixel, 0 = no sprite
+    const uint8_t* obj_info;    // COMPOSITOR_OBJ_* bits per pixel
+    bool           bg_enabled;  // LCDC.0, BG/window show as color 0 when clear
+    uint8_t        bgp;
+    uint8_t        obp0;
+    uint8_t        obp1;
+};
+
+// Resolves BG/OBJ priority and maps the winner through its palette into out (shades 0-3)
+typedef void (*compositor_fn)(uint8_t* out, const struct CompositorLine* line);
+
+// Reference implementation, one pixel at a time
+void compositor_compose_scalar(uint8_t* out, const struct CompositorLine* line);
+#if defined(__x86_64__) || defined(__i386__)
+// 16 pixels at a time, palette lookup through compares
+void compositor_compose_sse2(uint8_t* out, const struct CompositorLine* line);
+// 32 pixels at a time, palette lookup through a byte shuffle
+void compositor_compose_avx2(uint8_t* out, const struct CompositorLine* line);
+#endif
+// Fastest implementation the host CPU supports (CPUID)
+compositor_fn compositor_select(void);
+
+#endif
@@ -1059,6 +1059,7 @@ struct CPU* create_cpu(struct Registers* registers, struct MMU* mmu)
     cpu->mmu                    = mmu;
     cpu->opcode_cycle_main      = opcode_cycle_main;
     cpu->opcode_cycle_prefix_cb = opcode_cycle_prefix_cb;
+    cpu->scheduler              = NULL;
 
     // initialize cpu state
     cpu->halted                  = false;
@@ -1078,12 +1079,6 @@ struct CPU* create_cpu(struct Registers* registers, struct MMU* mmu)
     return cpu;
 }
 
-void cpu_set_serial_output(struct CPU* cpu, bool serial_output)
-{
-    CPU_DEBUG_PRINT("Serial output enabled: %d\n", serial_output);
-    cpu->serial_output = serial_output;
-}
-
 void free_cpu(struct CPU* cpu)
 {
     if (cpu->registers) {
@@ -1098,10 +1093,8 @@ void free_cpu(struct CPU* cpu)
 // Private: Handle interrupts
 uint8_t handle_interrupts(struct CPU* cpu)
 {
-    // Get interrupt flag and enable registers
-    uint8_t interrupt_flag    = cpu->mmu->mmu_get_byte(cpu->mmu, INTERRUPT_FLAG_ADDRESS);
-    uint8_t interrupt_enable  = cpu->mmu->mmu_get_byte(cpu->mmu, 0xFFFF);
-    uint8_t interrupt_enabled = interrupt_flag & interrupt_enable;
+    // IE & IF, cached by the MMU
+    uint8_t interrupt_enabled = cpu->mmu->interrupt_pending;
 
     // No interrupts pending
     if (!interrupt_enabled) {
@@ -1143,48 +1136,58 @@ uint8_t handle_interrupts(struct CPU* cpu)
 #endif
 
     // set that bit to 0 in interrupt flag
-    cpu->mmu->mmu_set_byte(
-        cpu->mmu, INTERRUPT_FLAG_ADDRESS, interrupt_flag & ~(1 << interrupt_bit));
+    mmu_acknowledge_interrupt(cpu->mmu, 1 << interrupt_bit);
 
     // calculate interrupt address
     uint16_t interrupt_address = cpu->interrupt_vector_table[interrupt_bit];
 
     // push pc to stack
-    uint16_t old_pc = cpu->registers->get_control_register(cpu->registers, PC);
-    uint16_t old_sp = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t old_pc = registers_get_control(cpu->registers, PC);
+    uint16_t old_sp = registers_get_control(cpu->registers, SP);
     uint16_t new_sp = old_sp - 2;   // Decrement SP first
     cpu->mmu->mmu_set_word(cpu->mmu, new_sp, old_pc);
-    cpu->registers->set_control_register(cpu->registers, SP, new_sp);
+    registers_set_control(cpu->registers, SP, new_sp);
 
     // jump to interrupt address
-    cpu->registers->set_control_register(cpu->registers, PC, interrupt_address);
+    registers_set_control(cpu->registers, PC, interrupt_address);
     return 4;
 }
 
-void cpu_attach_timer(struct CPU* cpu, struct Timer* timer)
+// Cycles a halted CPU can skip without missing a wake-up, 0 if it has to step normally.
+// Every device, the timer included, only raises interrupts when its event fires, so nothing
+// can wake the CPU before the next deadline.
+uint64_t cpu_halt_skip_cycles(struct CPU* cpu, uint64_t cycles)
 {
-    cpu->timer = timer;
+    if (cpu->mmu->interrupt_pending) {
+        return 0;
+    }
+    return cycles;
 }
 
-void cpu_step_for_cycles(struct CPU* cpu, int16_t cycles)
+void cpu_attach_scheduler(struct CPU* cpu, struct Scheduler* scheduler)
 {
-    while (cycles > 0) {
+    cpu->scheduler = scheduler;
+}
+
+void cpu_run_until_next_event(struct CPU* cpu)
+{
+    struct Scheduler* scheduler = cpu->scheduler;
+    uint64_t          cycles_left;
+    while ((cycles_left = scheduler_cycles_until_next_event(scheduler)) > 0) {
+        // HALT: jump straight to the next wake-up instead of idling 1 cycle at a time
+        if (cpu->halted) {
+            uint64_t skip = cpu_halt_skip_cycles(cpu, cycles_left);
+            if (skip > 1) {
+                scheduler->now += skip;
+                continue;
+            }
+        }
         uint8_t cycles_to_step = cpu_step_next(cpu);
-        cycles -= cycles_to_step;
-        cpu->timer->add_time(cpu->timer, cycles_to_step);
+        scheduler->now += cycles_to_step;
     }
-    return;
 }
 uint8_t cpu_step_next(struct CPU* cpu)
 {
-    // 0. serial output
-    if (cpu->serial_output) {
-        if (cpu->mmu->mmu_get_byte(cpu->mmu, 0xFF02) == 0x81) {
-            char c = cpu->mmu->mmu_get_byte(cpu->mmu, 0xFF01);
-            printf("%c", c);
-            cpu->mmu->mmu_set_byte(cpu->mmu, 0xFF02, 0x0);
-        }
-    }
     // 1. Check interrupts
     uint8_t interrupt_cycles = handle_interrupts(cpu);
     if (interrupt_cycles) {
@@ -1234,6 +1237,9 @@ uint8_t cpu_step(struct CPU* cpu)
 
 uint8_t cpu_step_execute_op_code(struct CPU* cpu, uint8_t op_byte)
 {
+#ifdef CPU_SWITCH_CORE
+    return cpu_step_execute_switch(cpu, op_byte);
+#endif
     if (op_byte == CB_PREFIX) {
         return cpu_step_execute_prefix_cb(cpu);
     }
@@ -1244,6 +1250,8 @@ uint8_t cpu_step_execute_main(struct CPU* cpu, uint8_t op_byte)
 {
     CPU_TRACE_PRINT("Executing Op Code: 0x%02X\n", op_byte);
     struct PackedInstructionParam* param = &cpu->instruction_table[op_byte];
+    // Conditional instructions only ever set this, clear it so a taken branch does not stick
+    param->param.result_is_alternative = false;
     param->fn(cpu, &param->param);
     if (param->param.result_is_alternative) {
         return param->cycles_alternative;
@@ -1282,15 +1290,15 @@ EXECUTABLE_INSTRUCTION(ld_imm_to_register_pair)
 {
     enum RegisterPair register_pair = param->rp_1;
     uint16_t          value         = cpu_step_read_word(cpu);
-    cpu->registers->set_register_pair(cpu->registers, register_pair, value);
+    registers_set_pair(cpu->registers, register_pair, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_register_to_address_register_pair)
 {
     enum Register     from_register    = param->reg_1;
     enum RegisterPair to_register_pair = param->rp_1;
-    uint16_t mmu_address = cpu->registers->get_register_pair(cpu->registers, to_register_pair);
-    uint8_t  value       = cpu->registers->get_register_byte(cpu->registers, from_register);
+    uint16_t mmu_address = registers_get_pair(cpu->registers, to_register_pair);
+    uint8_t  value       = registers_get_byte(cpu->registers, from_register);
     cpu->mmu->mmu_set_byte(cpu->mmu, mmu_address, value);
 }
 
@@ -1298,36 +1306,36 @@ EXECUTABLE_INSTRUCTION(ld_imm_to_register)
 {
     enum Register register_to = param->reg_1;
     uint8_t       value       = cpu_step_read_byte(cpu);
-    cpu->registers->set_register_byte(cpu->registers, register_to, value);
+    registers_set_byte(cpu->registers, register_to, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_register_to_register)
 {
     enum Register from_register = param->reg_1;
     enum Register to_register   = param->reg_2;
-    uint8_t       value         = cpu->registers->get_register_byte(cpu->registers, from_register);
-    cpu->registers->set_register_byte(cpu->registers, to_register, value);
+    uint8_t       value         = registers_get_byte(cpu->registers, from_register);
+    registers_set_byte(cpu->registers, to_register, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_address_hl_to_register)
 {
     enum Register register_to = param->reg_1;
-    uint16_t      address     = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t      address     = registers_get_pair(cpu->registers, HL);
     uint8_t       value       = cpu->mmu->mmu_get_byte(cpu->mmu, address);
-    cpu->registers->set_register_byte(cpu->registers, register_to, value);
+    registers_set_byte(cpu->registers, register_to, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_register_to_address_hl)
 {
     enum Register from_register = param->reg_1;
-    uint16_t      address       = cpu->registers->get_register_pair(cpu->registers, HL);
-    uint8_t       value         = cpu->registers->get_register_byte(cpu->registers, from_register);
+    uint16_t      address       = registers_get_pair(cpu->registers, HL);
+    uint8_t       value         = registers_get_byte(cpu->registers, from_register);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_imm_to_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu_step_read_byte(cpu);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, value);
 }
@@ -1337,36 +1345,36 @@ EXECUTABLE_INSTRUCTION(ld_imm_to_address_hl)
 EXECUTABLE_INSTRUCTION(ld_sp_to_address_imm)
 {
     uint16_t address = cpu_step_read_word(cpu);
-    uint16_t sp      = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp      = registers_get_control(cpu->registers, SP);
     cpu->mmu->mmu_set_word(cpu->mmu, address, sp);
 }
 
 EXECUTABLE_INSTRUCTION(ld_hl_to_sp)
 {
-    uint16_t hl = cpu->registers->get_register_pair(cpu->registers, HL);
-    cpu->registers->set_control_register(cpu->registers, SP, hl);
+    uint16_t hl = registers_get_pair(cpu->registers, HL);
+    registers_set_control(cpu->registers, SP, hl);
 }
 
 EXECUTABLE_INSTRUCTION(push_register_pair)
 {
     enum RegisterPair register_pair = param->rp_1;
-    uint16_t          value = cpu->registers->get_register_pair(cpu->registers, register_pair);
-    uint16_t          sp    = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t          value = registers_get_pair(cpu->registers, register_pair);
+    uint16_t          sp    = registers_get_control(cpu->registers, SP);
     sp -= 2;
     cpu->mmu->mmu_set_word(cpu->mmu, sp, value);
-    cpu->registers->set_control_register(cpu->registers, SP, sp);
+    registers_set_control(cpu->registers, SP, sp);
 }
 
 EXECUTABLE_INSTRUCTION(pop_register_pair)
 {
     enum RegisterPair register_pair = param->rp_1;
-    uint16_t          sp            = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t          sp            = registers_get_control(cpu->registers, SP);
     uint16_t          value         = cpu->mmu->mmu_get_word(cpu->mmu, sp);
     if (register_pair == AF) {
         value &= 0xFFF0;   // Lower 4 bits of F register are always zero
     }
-    cpu->registers->set_register_pair(cpu->registers, register_pair, value);
-    cpu->registers->set_control_register(cpu->registers, SP, sp + 2);
+    registers_set_pair(cpu->registers, register_pair, value);
+    registers_set_control(cpu->registers, SP, sp + 2);
 }
 
 // 8-bit arithmetic instructions:
@@ -1374,48 +1382,39 @@ EXECUTABLE_INSTRUCTION(pop_register_pair)
 EXECUTABLE_INSTRUCTION(add_register_to_a)
 {
     enum Register from_register = param->reg_1;
-    uint8_t       value         = cpu->registers->get_register_byte(cpu->registers, from_register);
-    uint8_t       a             = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t       value         = registers_get_byte(cpu->registers, from_register);
+    uint8_t       a             = registers_get_byte(cpu->registers, A);
     uint16_t      result        = a + value;
 
     // Set flags
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0x0F) + (value & 0x0F) > 0x0F);
-    cpu->registers->set_flag_c(cpu->registers, result > 0xFF);
+    registers_record_flags(cpu->registers, FlagOperation_Add, a, value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 EXECUTABLE_INSTRUCTION(add_imm_to_a)
 {
     uint8_t  value  = cpu_step_read_byte(cpu);
-    uint8_t  a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t  a      = registers_get_byte(cpu->registers, A);
     uint16_t result = a + value;
 
     // Set flags
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0x0F) + (value & 0x0F) > 0x0F);
-    cpu->registers->set_flag_c(cpu->registers, result > 0xFF);
+    registers_record_flags(cpu->registers, FlagOperation_Add, a, value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 // ADC implementation
 
 void adc_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t  a      = cpu->registers->get_register_byte(cpu->registers, A);
-    uint8_t  carry  = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t  a      = registers_get_byte(cpu->registers, A);
+    uint8_t  carry  = registers_get_flag(cpu->registers, Flag_C);
     uint16_t result = a + *value + carry;
 
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0x0F) + (*value & 0x0F) + carry > 0x0F);
-    cpu->registers->set_flag_c(cpu->registers, result > 0xFF);
+    registers_record_flags(cpu->registers, FlagOperation_Add, a, *value, carry, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 EXECUTABLE_INSTRUCTION(adc_imm_to_a)
@@ -1428,10 +1427,10 @@ EXECUTABLE_INSTRUCTION(adc_imm_to_a)
 void inc(struct CPU* cpu, uint8_t* value)
 {
     uint8_t result = *value + 1;
+    // INC/DEC keep C, read it off the pending operation instead of rebuilding F
+    uint8_t carry  = registers_get_carry(cpu->registers);
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (*value & 0xF) == 0xF);
+    registers_record_flags(cpu->registers, FlagOperation_Inc, *value, 1, carry, result);
 
     *value = result;
 }
@@ -1439,14 +1438,14 @@ void inc(struct CPU* cpu, uint8_t* value)
 EXECUTABLE_INSTRUCTION(inc_register)
 {
     enum Register reg   = param->reg_1;
-    uint8_t       value = cpu->registers->get_register_byte(cpu->registers, reg);
+    uint8_t       value = registers_get_byte(cpu->registers, reg);
     inc(cpu, &value);
-    cpu->registers->set_register_byte(cpu->registers, reg, value);
+    registers_set_byte(cpu->registers, reg, value);
 }
 
 EXECUTABLE_INSTRUCTION(inc_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     inc(cpu, &value);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, value);
@@ -1455,10 +1454,9 @@ EXECUTABLE_INSTRUCTION(inc_address_hl)
 void dec(struct CPU* cpu, uint8_t* value)
 {
     uint8_t result = *value - 1;
+    uint8_t carry  = registers_get_carry(cpu->registers);
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, true);
-    cpu->registers->set_flag_h(cpu->registers, (*value & 0xF) == 0);
+    registers_record_flags(cpu->registers, FlagOperation_Dec, *value, 1, carry, result);
 
     *value = result;
 }
@@ -1466,14 +1464,14 @@ void dec(struct CPU* cpu, uint8_t* value)
 EXECUTABLE_INSTRUCTION(dec_register)
 {
     enum Register reg   = param->reg_1;
-    uint8_t       value = cpu->registers->get_register_byte(cpu->registers, reg);
+    uint8_t       value = registers_get_byte(cpu->registers, reg);
     dec(cpu, &value);
-    cpu->registers->set_register_byte(cpu->registers, reg, value);
+    registers_set_byte(cpu->registers, reg, value);
 }
 
 EXECUTABLE_INSTRUCTION(dec_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     dec(cpu, &value);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, value);
@@ -1481,55 +1479,55 @@ EXECUTABLE_INSTRUCTION(dec_address_hl)
 
 void add_hl(struct CPU* cpu, uint16_t* value)
 {
-    uint16_t hl     = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t hl     = registers_get_pair(cpu->registers, HL);
     uint32_t result = hl + *value;
 
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (hl & 0x0FFF) + (*value & 0x0FFF) > 0x0FFF);
-    cpu->registers->set_flag_c(cpu->registers, result > 0xFFFF);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, (hl & 0x0FFF) + (*value & 0x0FFF) > 0x0FFF);
+    registers_set_flag(cpu->registers, Flag_C, result > 0xFFFF);
 
-    cpu->registers->set_register_pair(cpu->registers, HL, result & 0xFFFF);
+    registers_set_pair(cpu->registers, HL, result & 0xFFFF);
 }
 
 EXECUTABLE_INSTRUCTION(add_register_pair_to_hl)
 {
     enum RegisterPair rp    = param->rp_1;
-    uint16_t          value = cpu->registers->get_register_pair(cpu->registers, rp);
+    uint16_t          value = registers_get_pair(cpu->registers, rp);
     add_hl(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(add_sp_to_hl)
 {
-    uint16_t sp = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp = registers_get_control(cpu->registers, SP);
     add_hl(cpu, &sp);
 }
 
 EXECUTABLE_INSTRUCTION(add_imm_to_sp)
 {
     int8_t   value  = (int8_t)cpu_step_read_byte(cpu);
-    uint16_t sp     = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp     = registers_get_control(cpu->registers, SP);
     uint16_t result = sp + value;
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (sp & 0x0F) + (value & 0x0F) > 0x0F);
-    cpu->registers->set_flag_c(cpu->registers, (sp & 0xFF) + (value & 0xFF) > 0xFF);
+    registers_set_flag(cpu->registers, Flag_Z, false);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, (sp & 0x0F) + (value & 0x0F) > 0x0F);
+    registers_set_flag(cpu->registers, Flag_C, (sp & 0xFF) + (value & 0xFF) > 0xFF);
 
-    cpu->registers->set_control_register(cpu->registers, SP, result);
+    registers_set_control(cpu->registers, SP, result);
 }
 
 EXECUTABLE_INSTRUCTION(daa)
 {
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
-    bool    carry  = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
+    bool    carry  = registers_get_flag(cpu->registers, Flag_C);
     uint8_t adjust = carry ? 0x60 : 0x00;
 
-    bool half_carry = cpu->registers->get_flag_h(cpu->registers);
+    bool half_carry = registers_get_flag(cpu->registers, Flag_H);
     if (half_carry) {
         adjust |= 0x06;
     }
 
-    bool subtract = cpu->registers->get_flag_n(cpu->registers);
+    bool subtract = registers_get_flag(cpu->registers, Flag_N);
     if (!subtract) {
         if ((a & 0x0F) > 0x09) {
             adjust |= 0x06;
@@ -1544,92 +1542,80 @@ EXECUTABLE_INSTRUCTION(daa)
     }
 
     // flags
-    cpu->registers->set_flag_z(cpu->registers, a == 0);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, adjust >= 0x60);
+    registers_set_flag(cpu->registers, Flag_Z, a == 0);
+    registers_set_flag(cpu->registers, Flag_H, false);
+    registers_set_flag(cpu->registers, Flag_C, adjust >= 0x60);
 
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(cpl)
 {
-    uint8_t a = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a = registers_get_byte(cpu->registers, A);
     a         = ~a;
-    cpu->registers->set_flag_n(cpu->registers, true);
-    cpu->registers->set_flag_h(cpu->registers, true);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_flag(cpu->registers, Flag_N, true);
+    registers_set_flag(cpu->registers, Flag_H, true);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 // Rotate and shift instructions
 EXECUTABLE_INSTRUCTION(rlca)
 {
-    uint8_t a     = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a     = registers_get_byte(cpu->registers, A);
     uint8_t carry = (a & 0x80) >> 7;
     a             = (a << 1) | carry;
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_RotateA, 0, 0, carry, a);
 
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(rla)
 {
-    uint8_t a         = cpu->registers->get_register_byte(cpu->registers, A);
-    uint8_t old_carry = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t a         = registers_get_byte(cpu->registers, A);
+    uint8_t old_carry = registers_get_flag(cpu->registers, Flag_C);
     uint8_t new_carry = (a & 0x80) >> 7;
     a                 = (a << 1) | old_carry;
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, new_carry);
+    registers_record_flags(cpu->registers, FlagOperation_RotateA, 0, 0, new_carry, a);
 
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(rrca)
 {
-    uint8_t a     = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a     = registers_get_byte(cpu->registers, A);
     uint8_t carry = a & 0x01;
     a             = (a >> 1) | (carry << 7);
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_RotateA, 0, 0, carry, a);
 
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(rra)
 {
-    uint8_t a         = cpu->registers->get_register_byte(cpu->registers, A);
-    uint8_t old_carry = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t a         = registers_get_byte(cpu->registers, A);
+    uint8_t old_carry = registers_get_flag(cpu->registers, Flag_C);
     uint8_t new_carry = a & 0x01;
     a                 = (a >> 1) | (old_carry << 7);
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, new_carry);
+    registers_record_flags(cpu->registers, FlagOperation_RotateA, 0, 0, new_carry, a);
 
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 // Jump instructions
 EXECUTABLE_INSTRUCTION(jp_imm)
 {
     uint16_t address = cpu_step_read_word(cpu);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    registers_set_control(cpu->registers, PC, address);
 }
 
 EXECUTABLE_INSTRUCTION(jp_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
+    registers_set_control(cpu->registers, PC, address);
 }
 
 EXECUTABLE_INSTRUCTION(jp_cc_imm)
@@ -1639,14 +1625,14 @@ EXECUTABLE_INSTRUCTION(jp_cc_imm)
     bool               jump      = false;
 
     switch (condition) {
-    case JumpCondition_NZ: jump = !cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_Z: jump = cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_NC: jump = !cpu->registers->get_flag_c(cpu->registers); break;
-    case JumpCondition_C: jump = cpu->registers->get_flag_c(cpu->registers); break;
+    case JumpCondition_NZ: jump = !registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_Z: jump = registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_NC: jump = !registers_get_flag(cpu->registers, Flag_C); break;
+    case JumpCondition_C: jump = registers_get_flag(cpu->registers, Flag_C); break;
     }
 
     if (jump) {
-        cpu->registers->set_control_register(cpu->registers, PC, address);
+        registers_set_control(cpu->registers, PC, address);
         param->result_is_alternative = true;
     }
 }
@@ -1654,8 +1640,8 @@ EXECUTABLE_INSTRUCTION(jp_cc_imm)
 EXECUTABLE_INSTRUCTION(jr_imm)
 {
     int8_t   offset = (int8_t)cpu_step_read_byte(cpu);
-    uint16_t pc     = cpu->registers->get_control_register(cpu->registers, PC);
-    cpu->registers->set_control_register(cpu->registers, PC, pc + offset);
+    uint16_t pc     = registers_get_control(cpu->registers, PC);
+    registers_set_control(cpu->registers, PC, pc + offset);
 }
 
 EXECUTABLE_INSTRUCTION(jr_cc_imm)
@@ -1665,15 +1651,15 @@ EXECUTABLE_INSTRUCTION(jr_cc_imm)
     bool               jump      = false;
 
     switch (condition) {
-    case JumpCondition_NZ: jump = !cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_Z: jump = cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_NC: jump = !cpu->registers->get_flag_c(cpu->registers); break;
-    case JumpCondition_C: jump = cpu->registers->get_flag_c(cpu->registers); break;
+    case JumpCondition_NZ: jump = !registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_Z: jump = registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_NC: jump = !registers_get_flag(cpu->registers, Flag_C); break;
+    case JumpCondition_C: jump = registers_get_flag(cpu->registers, Flag_C); break;
     }
 
     if (jump) {
-        uint16_t pc = cpu->registers->get_control_register(cpu->registers, PC);
-        cpu->registers->set_control_register(cpu->registers, PC, pc + offset);
+        uint16_t pc = registers_get_control(cpu->registers, PC);
+        registers_set_control(cpu->registers, PC, pc + offset);
         param->result_is_alternative = true;
     }
 }
@@ -1681,13 +1667,13 @@ EXECUTABLE_INSTRUCTION(jr_cc_imm)
 EXECUTABLE_INSTRUCTION(call_imm)
 {
     uint16_t address = cpu_step_read_word(cpu);
-    uint16_t pc      = cpu->registers->get_control_register(cpu->registers, PC);
-    uint16_t sp      = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t pc      = registers_get_control(cpu->registers, PC);
+    uint16_t sp      = registers_get_control(cpu->registers, SP);
 
     sp -= 2;
     cpu->mmu->mmu_set_word(cpu->mmu, sp, pc);
-    cpu->registers->set_control_register(cpu->registers, SP, sp);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    registers_set_control(cpu->registers, SP, sp);
+    registers_set_control(cpu->registers, PC, address);
 }
 
 EXECUTABLE_INSTRUCTION(call_cc_imm)
@@ -1697,29 +1683,29 @@ EXECUTABLE_INSTRUCTION(call_cc_imm)
     bool               jump      = false;
 
     switch (condition) {
-    case JumpCondition_NZ: jump = !cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_Z: jump = cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_NC: jump = !cpu->registers->get_flag_c(cpu->registers); break;
-    case JumpCondition_C: jump = cpu->registers->get_flag_c(cpu->registers); break;
+    case JumpCondition_NZ: jump = !registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_Z: jump = registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_NC: jump = !registers_get_flag(cpu->registers, Flag_C); break;
+    case JumpCondition_C: jump = registers_get_flag(cpu->registers, Flag_C); break;
     }
 
     if (jump) {
-        uint16_t pc = cpu->registers->get_control_register(cpu->registers, PC);
-        uint16_t sp = cpu->registers->get_control_register(cpu->registers, SP);
+        uint16_t pc = registers_get_control(cpu->registers, PC);
+        uint16_t sp = registers_get_control(cpu->registers, SP);
         sp -= 2;
         cpu->mmu->mmu_set_word(cpu->mmu, sp, pc);
-        cpu->registers->set_control_register(cpu->registers, SP, sp);
-        cpu->registers->set_control_register(cpu->registers, PC, address);
+        registers_set_control(cpu->registers, SP, sp);
+        registers_set_control(cpu->registers, PC, address);
         param->result_is_alternative = true;
     }
 }
 
 EXECUTABLE_INSTRUCTION(ret)
 {
-    uint16_t sp      = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp      = registers_get_control(cpu->registers, SP);
     uint16_t address = cpu->mmu->mmu_get_word(cpu->mmu, sp);
-    cpu->registers->set_control_register(cpu->registers, SP, sp + 2);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    registers_set_control(cpu->registers, SP, sp + 2);
+    registers_set_control(cpu->registers, PC, address);
 }
 
 EXECUTABLE_INSTRUCTION(ret_cc)
@@ -1728,40 +1714,40 @@ EXECUTABLE_INSTRUCTION(ret_cc)
     bool               jump      = false;
 
     switch (condition) {
-    case JumpCondition_NZ: jump = !cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_Z: jump = cpu->registers->get_flag_z(cpu->registers); break;
-    case JumpCondition_NC: jump = !cpu->registers->get_flag_c(cpu->registers); break;
-    case JumpCondition_C: jump = cpu->registers->get_flag_c(cpu->registers); break;
+    case JumpCondition_NZ: jump = !registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_Z: jump = registers_get_flag(cpu->registers, Flag_Z); break;
+    case JumpCondition_NC: jump = !registers_get_flag(cpu->registers, Flag_C); break;
+    case JumpCondition_C: jump = registers_get_flag(cpu->registers, Flag_C); break;
     }
 
     if (jump) {
-        uint16_t sp      = cpu->registers->get_control_register(cpu->registers, SP);
+        uint16_t sp      = registers_get_control(cpu->registers, SP);
         uint16_t address = cpu->mmu->mmu_get_word(cpu->mmu, sp);
-        cpu->registers->set_control_register(cpu->registers, SP, sp + 2);
-        cpu->registers->set_control_register(cpu->registers, PC, address);
+        registers_set_control(cpu->registers, SP, sp + 2);
+        registers_set_control(cpu->registers, PC, address);
         param->result_is_alternative = true;
     }
 }
 
 EXECUTABLE_INSTRUCTION(reti)
 {
-    uint16_t sp      = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp      = registers_get_control(cpu->registers, SP);
     uint16_t address = cpu->mmu->mmu_get_word(cpu->mmu, sp);
-    cpu->registers->set_control_register(cpu->registers, SP, sp + 2);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    registers_set_control(cpu->registers, SP, sp + 2);
+    registers_set_control(cpu->registers, PC, address);
     // Enable interrupts
     cpu->interrupt_master_enable = true;
 }
 
 void rst(struct CPU* cpu, uint16_t n)
 {
-    uint16_t pc = cpu->registers->get_control_register(cpu->registers, PC);
-    uint16_t sp = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t pc = registers_get_control(cpu->registers, PC);
+    uint16_t sp = registers_get_control(cpu->registers, SP);
 
     sp -= 2;
     cpu->mmu->mmu_set_word(cpu->mmu, sp, pc);
-    cpu->registers->set_control_register(cpu->registers, SP, sp);
-    cpu->registers->set_control_register(cpu->registers, PC, n);
+    registers_set_control(cpu->registers, SP, sp);
+    registers_set_control(cpu->registers, PC, n);
 }
 
 EXECUTABLE_INSTRUCTION(rst_00h)
@@ -1818,61 +1804,58 @@ void dec_16_bit(struct CPU* cpu, uint16_t* value)
 EXECUTABLE_INSTRUCTION(inc_register_pair)
 {
     enum RegisterPair rp    = param->rp_1;
-    uint16_t          value = cpu->registers->get_register_pair(cpu->registers, rp);
+    uint16_t          value = registers_get_pair(cpu->registers, rp);
     inc_16_bit(cpu, &value);
-    cpu->registers->set_register_pair(cpu->registers, rp, value);
+    registers_set_pair(cpu->registers, rp, value);
 }
 
 EXECUTABLE_INSTRUCTION(dec_register_pair)
 {
     enum RegisterPair rp    = param->rp_1;
-    uint16_t          value = cpu->registers->get_register_pair(cpu->registers, rp);
+    uint16_t          value = registers_get_pair(cpu->registers, rp);
     dec_16_bit(cpu, &value);
-    cpu->registers->set_register_pair(cpu->registers, rp, value);
+    registers_set_pair(cpu->registers, rp, value);
 }
 
 EXECUTABLE_INSTRUCTION(inc_sp)
 {
-    uint16_t sp = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp = registers_get_control(cpu->registers, SP);
     inc_16_bit(cpu, &sp);
-    cpu->registers->set_control_register(cpu->registers, SP, sp);
+    registers_set_control(cpu->registers, SP, sp);
 }
 
 EXECUTABLE_INSTRUCTION(dec_sp)
 {
-    uint16_t sp = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp = registers_get_control(cpu->registers, SP);
     dec_16_bit(cpu, &sp);
-    cpu->registers->set_control_register(cpu->registers, SP, sp);
+    registers_set_control(cpu->registers, SP, sp);
 }
 
 EXECUTABLE_INSTRUCTION(ccf)
 {
-    bool current_carry = cpu->registers->get_flag_c(cpu->registers);
+    bool current_carry = registers_get_flag(cpu->registers, Flag_C);
 
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, !current_carry);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, false);
+    registers_set_flag(cpu->registers, Flag_C, !current_carry);
 }
 
 EXECUTABLE_INSTRUCTION(scf)
 {
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, true);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, false);
+    registers_set_flag(cpu->registers, Flag_C, true);
 }
 
 EXECUTABLE_INSTRUCTION(halt)
 {
     // Game Boy HALT bug: When IME=0 and interrupts are pending,
     // the next instruction after HALT gets executed twice
-    uint8_t interrupt_flag   = cpu->mmu->mmu_get_byte(cpu->mmu, INTERRUPT_FLAG_ADDRESS);
-    uint8_t interrupt_enable = cpu->mmu->mmu_get_byte(cpu->mmu, 0xFFFF);
-
-    if (!cpu->interrupt_master_enable && (interrupt_flag & interrupt_enable)) {
+    if (!cpu->interrupt_master_enable && cpu->mmu->interrupt_pending) {
         // HALT bug: Don't increment PC on next instruction fetch
         // This causes the instruction after HALT to execute twice
-        uint16_t pc = cpu->registers->get_control_register(cpu->registers, PC);
-        cpu->registers->set_control_register(cpu->registers, PC, pc - 1);
+        uint16_t pc = registers_get_control(cpu->registers, PC);
+        registers_set_control(cpu->registers, PC, pc - 1);
     }
     else {
         cpu->halted = true;
@@ -1897,20 +1880,20 @@ EXECUTABLE_INSTRUCTION(ei)
 EXECUTABLE_INSTRUCTION(ld_sp_plus_imm_to_hl)
 {
     int8_t   offset = (int8_t)cpu_step_read_byte(cpu);
-    uint16_t sp     = cpu->registers->get_control_register(cpu->registers, SP);
+    uint16_t sp     = registers_get_control(cpu->registers, SP);
 
-    cpu->registers->set_flag_z(cpu->registers, false);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (sp & 0x0F) + (offset & 0x0F) > 0x0F);
-    cpu->registers->set_flag_c(cpu->registers, (sp & 0xFF) + (offset & 0xFF) > 0xFF);
+    registers_set_flag(cpu->registers, Flag_Z, false);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, (sp & 0x0F) + (offset & 0x0F) > 0x0F);
+    registers_set_flag(cpu->registers, Flag_C, (sp & 0xFF) + (offset & 0xFF) > 0xFF);
 
-    cpu->registers->set_register_pair(cpu->registers, HL, sp + offset);
+    registers_set_pair(cpu->registers, HL, sp + offset);
 }
 
 EXECUTABLE_INSTRUCTION(ld_a_to_address_imm)
 {
     uint16_t address = cpu_step_read_word(cpu);
-    uint8_t  a       = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t  a       = registers_get_byte(cpu->registers, A);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, a);
 }
 
@@ -1918,20 +1901,20 @@ EXECUTABLE_INSTRUCTION(ld_address_imm_to_a)
 {
     uint16_t address = cpu_step_read_word(cpu);
     uint8_t  a       = cpu->mmu->mmu_get_byte(cpu->mmu, address);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(ld_a_to_zero_page_address_c)
 {
-    uint8_t offset = cpu->registers->get_register_byte(cpu->registers, C);
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t offset = registers_get_byte(cpu->registers, C);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     cpu->mmu->mmu_set_byte(cpu->mmu, 0xFF00 + offset, a);
 }
 
 EXECUTABLE_INSTRUCTION(ld_a_to_zero_page_address_imm)
 {
     uint8_t offset = cpu_step_read_byte(cpu);
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     cpu->mmu->mmu_set_byte(cpu->mmu, 0xFF00 + offset, a);
 }
 
@@ -1939,158 +1922,158 @@ EXECUTABLE_INSTRUCTION(ld_zero_page_address_imm_to_a)
 {
     uint8_t offset = cpu_step_read_byte(cpu);
     uint8_t a      = cpu->mmu->mmu_get_byte(cpu->mmu, 0xFF00 + offset);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(ld_zero_page_address_c_to_a)
 {
-    uint8_t offset = cpu->registers->get_register_byte(cpu->registers, C);
+    uint8_t offset = registers_get_byte(cpu->registers, C);
     uint8_t a      = cpu->mmu->mmu_get_byte(cpu->mmu, 0xFF00 + offset);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
+    registers_set_byte(cpu->registers, A, a);
 }
 
 EXECUTABLE_INSTRUCTION(ld_imm_to_sp)
 {
     uint16_t value = cpu_step_read_word(cpu);
-    cpu->registers->set_control_register(cpu->registers, SP, value);
+    registers_set_control(cpu->registers, SP, value);
 }
 
 EXECUTABLE_INSTRUCTION(ld_a_to_address_hl_inc_hl)
 {
-    uint16_t hl = cpu->registers->get_register_pair(cpu->registers, HL);
-    uint8_t  a  = cpu->registers->get_register_byte(cpu->registers, A);
+    uint16_t hl = registers_get_pair(cpu->registers, HL);
+    uint8_t  a  = registers_get_byte(cpu->registers, A);
     cpu->mmu->mmu_set_byte(cpu->mmu, hl, a);
-    cpu->registers->set_register_pair(cpu->registers, HL, hl + 1);
+    registers_set_pair(cpu->registers, HL, hl + 1);
 }
 
 EXECUTABLE_INSTRUCTION(ld_address_hl_to_a_inc_hl)
 {
-    uint16_t hl = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t hl = registers_get_pair(cpu->registers, HL);
     uint8_t  a  = cpu->mmu->mmu_get_byte(cpu->mmu, hl);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
-    cpu->registers->set_register_pair(cpu->registers, HL, hl + 1);
+    registers_set_byte(cpu->registers, A, a);
+    registers_set_pair(cpu->registers, HL, hl + 1);
 }
 
 EXECUTABLE_INSTRUCTION(ld_a_to_address_hl_dec_hl)
 {
-    uint16_t hl = cpu->registers->get_register_pair(cpu->registers, HL);
-    uint8_t  a  = cpu->registers->get_register_byte(cpu->registers, A);
+    uint16_t hl = registers_get_pair(cpu->registers, HL);
+    uint8_t  a  = registers_get_byte(cpu->registers, A);
     cpu->mmu->mmu_set_byte(cpu->mmu, hl, a);
-    cpu->registers->set_register_pair(cpu->registers, HL, hl - 1);
+    registers_set_pair(cpu->registers, HL, hl - 1);
 }
 
 EXECUTABLE_INSTRUCTION(ld_address_hl_to_a_dec_hl)
 {
-    uint16_t hl = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t hl = registers_get_pair(cpu->registers, HL);
     uint8_t  a  = cpu->mmu->mmu_get_byte(cpu->mmu, hl);
-    cpu->registers->set_register_byte(cpu->registers, A, a);
-    cpu->registers->set_register_pair(cpu->registers, HL, hl - 1);
+    registers_set_byte(cpu->registers, A, a);
+    registers_set_pair(cpu->registers, HL, hl - 1);
 }
 
 EXECUTABLE_INSTRUCTION(ld_address_register_pair_to_register)
 {
     enum Register     reg     = param->reg_1;
     enum RegisterPair rp      = param->rp_1;
-    uint16_t          address = cpu->registers->get_register_pair(cpu->registers, rp);
+    uint16_t          address = registers_get_pair(cpu->registers, rp);
     uint8_t           value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
-    cpu->registers->set_register_byte(cpu->registers, reg, value);
+    registers_set_byte(cpu->registers, reg, value);
 }
 
 EXECUTABLE_INSTRUCTION(add_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     add_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(adc_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     adc_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(sub_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     sub_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(sbc_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     sbc_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(and_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     and_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(xor_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     xor_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(or_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     or_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(cp_address_hl_to_a)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cp_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(adc_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     adc_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(sub_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     sub_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(sbc_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     sbc_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(and_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     and_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(xor_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     xor_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(or_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     or_a(cpu, &value);
 }
 
 EXECUTABLE_INSTRUCTION(cp_register_to_a)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     cp_a(cpu, &value);
 }
 
@@ -2133,8 +2116,8 @@ EXECUTABLE_INSTRUCTION(sub_imm_to_a)
 
 EXECUTABLE_INSTRUCTION(jp_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
-    cpu->registers->set_control_register(cpu->registers, PC, address);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
+    registers_set_control(cpu->registers, PC, address);
 }
 
 EXECUTABLE_INSTRUCTION(prefix_cb)
@@ -2145,92 +2128,71 @@ EXECUTABLE_INSTRUCTION(prefix_cb)
 
 void add_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t  a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t  a      = registers_get_byte(cpu->registers, A);
     uint16_t result = a + *value;
 
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0xF) + (*value & 0xF) > 0xF);
-    cpu->registers->set_flag_c(cpu->registers, result > 0xFF);
+    registers_record_flags(cpu->registers, FlagOperation_Add, a, *value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 void sub_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t  a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t  a      = registers_get_byte(cpu->registers, A);
     uint16_t result = a - *value;
 
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, true);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0xF) < (*value & 0xF));
-    cpu->registers->set_flag_c(cpu->registers, a < *value);
+    registers_record_flags(cpu->registers, FlagOperation_Sub, a, *value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 void sbc_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t  a      = cpu->registers->get_register_byte(cpu->registers, A);
-    uint8_t  carry  = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t  a      = registers_get_byte(cpu->registers, A);
+    uint8_t  carry  = registers_get_flag(cpu->registers, Flag_C);
     uint16_t result = a - *value - carry;
 
-    cpu->registers->set_flag_z(cpu->registers, (result & 0xFF) == 0);
-    cpu->registers->set_flag_n(cpu->registers, true);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0xF) < ((*value & 0xF) + carry));
-    cpu->registers->set_flag_c(cpu->registers, a < (*value + carry));
+    registers_record_flags(cpu->registers, FlagOperation_Sub, a, *value, carry, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result & 0xFF);
+    registers_set_byte(cpu->registers, A, result & 0xFF);
 }
 
 void and_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     uint8_t result = a & *value;
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, true);
-    cpu->registers->set_flag_c(cpu->registers, false);
+    registers_record_flags(cpu->registers, FlagOperation_And, a, *value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result);
+    registers_set_byte(cpu->registers, A, result);
 }
 
 void xor_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     uint8_t result = a ^ *value;
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, false);
+    registers_record_flags(cpu->registers, FlagOperation_Logic, a, *value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result);
+    registers_set_byte(cpu->registers, A, result);
 }
 
 void or_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     uint8_t result = a | *value;
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, false);
+    registers_record_flags(cpu->registers, FlagOperation_Logic, a, *value, 0, result);
 
-    cpu->registers->set_register_byte(cpu->registers, A, result);
+    registers_set_byte(cpu->registers, A, result);
 }
 
 void cp_a(struct CPU* cpu, uint8_t* value)
 {
-    uint8_t a      = cpu->registers->get_register_byte(cpu->registers, A);
+    uint8_t a      = registers_get_byte(cpu->registers, A);
     uint8_t result = a - *value;
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, true);
-    cpu->registers->set_flag_h(cpu->registers, (a & 0xF) < (*value & 0xF));
-    cpu->registers->set_flag_c(cpu->registers, a < *value);
+    registers_record_flags(cpu->registers, FlagOperation_Sub, a, *value, 0, result);
 }
 
 // CB prefix functions
@@ -2240,23 +2202,20 @@ uint8_t rlc(struct CPU* cpu, uint8_t value)
     uint8_t carry = (value & 0x80) >> 7;
     value         = (value << 1) | carry;
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(rlc_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, rlc(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, rlc(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(rlc_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, rlc(cpu, value));
 }
@@ -2266,77 +2225,68 @@ uint8_t rrc(struct CPU* cpu, uint8_t value)
     uint8_t carry = value & 0x01;
     value         = (value >> 1) | (carry << 7);
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(rrc_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, rrc(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, rrc(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(rrc_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, rrc(cpu, value));
 }
 
 uint8_t rl(struct CPU* cpu, uint8_t value)
 {
-    uint8_t old_carry = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t old_carry = registers_get_flag(cpu->registers, Flag_C);
     uint8_t new_carry = (value & 0x80) >> 7;
     value             = (value << 1) | old_carry;
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, new_carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, new_carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(rl_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, rl(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, rl(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(rl_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, rl(cpu, value));
 }
 
 uint8_t rr(struct CPU* cpu, uint8_t value)
 {
-    uint8_t old_carry = cpu->registers->get_flag_c(cpu->registers);
+    uint8_t old_carry = registers_get_flag(cpu->registers, Flag_C);
     uint8_t new_carry = value & 0x01;
     value             = (value >> 1) | (old_carry << 7);
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, new_carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, new_carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(rr_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, rr(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, rr(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(rr_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, rr(cpu, value));
 }
@@ -2346,23 +2296,20 @@ uint8_t sla(struct CPU* cpu, uint8_t value)
     uint8_t carry = (value & 0x80) >> 7;
     value         = value << 1;
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(sla_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, sla(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, sla(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(sla_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, sla(cpu, value));
 }
@@ -2372,24 +2319,21 @@ uint8_t sra(struct CPU* cpu, uint8_t value)
     uint8_t carry = value & 0x01;
     value         = (value >> 1) | (value & 0x80);
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(sra_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     uint8_t msb   = value & 0x80;
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, sra(cpu, value));
+    registers_set_byte(cpu->registers, param->reg_1, sra(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(sra_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     uint8_t  msb     = value & 0x80;
     cpu->mmu->mmu_set_byte(cpu->mmu, address, sra(cpu, value));
@@ -2400,23 +2344,20 @@ uint8_t swap(struct CPU* cpu, uint8_t value)
 {
     uint8_t result = (value >> 4) | (value << 4);
 
-    cpu->registers->set_flag_z(cpu->registers, result == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, false);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, 0, result);
 
     return result;
 }
 
 EXECUTABLE_INSTRUCTION(swap_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, swap(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, swap(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(swap_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, swap(cpu, value));
 }
@@ -2426,23 +2367,20 @@ uint8_t srl(struct CPU* cpu, uint8_t value)
     uint8_t carry = value & 0x01;
     value         = value >> 1;
 
-    cpu->registers->set_flag_z(cpu->registers, value == 0);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, false);
-    cpu->registers->set_flag_c(cpu->registers, carry);
+    registers_record_flags(cpu->registers, FlagOperation_Shift, 0, 0, carry, value);
 
     return value;
 }
 
 EXECUTABLE_INSTRUCTION(srl_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(cpu->registers, param->reg_1, srl(cpu, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, srl(cpu, value));
 }
 
 EXECUTABLE_INSTRUCTION(srl_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, srl(cpu, value));
 }
@@ -2453,21 +2391,21 @@ void bit(struct CPU* cpu, uint8_t value, uint8_t bit_position)
 {
     bool is_bit_set = (value >> bit_position) & 0x01;
 
-    cpu->registers->set_flag_z(cpu->registers, !is_bit_set);
-    cpu->registers->set_flag_n(cpu->registers, false);
-    cpu->registers->set_flag_h(cpu->registers, true);
+    registers_set_flag(cpu->registers, Flag_Z, !is_bit_set);
+    registers_set_flag(cpu->registers, Flag_N, false);
+    registers_set_flag(cpu->registers, Flag_H, true);
     // C flag is not affected
 }
 
 EXECUTABLE_INSTRUCTION(bit_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
     bit(cpu, value, param->bit_position);
 }
 
 EXECUTABLE_INSTRUCTION(bit_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     bit(cpu, value, param->bit_position);
 }
@@ -2479,14 +2417,13 @@ uint8_t res(struct CPU* cpu, uint8_t value, uint8_t bit_position)
 
 EXECUTABLE_INSTRUCTION(res_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(
-        cpu->registers, param->reg_1, res(cpu, value, param->bit_position));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, res(cpu, value, param->bit_position));
 }
 
 EXECUTABLE_INSTRUCTION(res_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, res(cpu, value, param->bit_position));
 }
@@ -2498,14 +2435,13 @@ uint8_t set(struct CPU* cpu, uint8_t bit, uint8_t value)
 
 EXECUTABLE_INSTRUCTION(set_register)
 {
-    uint8_t value = cpu->registers->get_register_byte(cpu->registers, param->reg_1);
-    cpu->registers->set_register_byte(
-        cpu->registers, param->reg_1, set(cpu, param->bit_position, value));
+    uint8_t value = registers_get_byte(cpu->registers, param->reg_1);
+    registers_set_byte(cpu->registers, param->reg_1, set(cpu, param->bit_position, value));
 }
 
 EXECUTABLE_INSTRUCTION(set_address_hl)
 {
-    uint16_t address = cpu->registers->get_register_pair(cpu->registers, HL);
+    uint16_t address = registers_get_pair(cpu->registers, HL);
     uint8_t  value   = cpu->mmu->mmu_get_byte(cpu->mmu, address);
     cpu->mmu->mmu_set_byte(cpu->mmu, address, set(cpu, param->bit_position, value));
 }
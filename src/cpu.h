@@ -145,11 +145,8 @@ struct CPU
     // Memory Management Unit
     struct MMU* mmu;
 
-    // Timer
-    struct Timer* timer;
-
-    // serial output
-    bool serial_output;
+    // Scheduler, owns the cycle counter
+    struct Scheduler* scheduler;
 
     // CPU state
     bool halted;                    // CPU is halted
@@ -169,8 +166,6 @@ struct CPU
     const uint8_t* opcode_cycle_prefix_cb;
 
     // Public method pointers
-    void (*cpu_attach_timer)(struct CPU* cpu, struct Timer* timer);
-    uint8_t (*cpu_step_for_cycles)(struct CPU* cpu, uint8_t cycles);   // Step for given number of cycles
     uint8_t (*cpu_step_next)(struct CPU*);   // Step next instruction (or interrupt)
 
     // instruction table (function pointers), 256 entries
@@ -240,11 +235,12 @@ typedef uint8_t (*cpu_instruction_fn)(struct CPU* cpu, ...);
 struct CPU* create_cpu(struct Registers* registers, struct MMU* mmu);
 void        free_cpu(struct CPU* cpu);
 
-// Attach timer
-void cpu_attach_timer(struct CPU* cpu, struct Timer* timer);
-
-// Step for given number of cycles
-void cpu_step_for_cycles(struct CPU* cpu, int16_t cycles);
+// Cycles a halted CPU can fast-forward within the next `cycles`
+uint64_t cpu_halt_skip_cycles(struct CPU* cpu, uint64_t cycles);
+// Attach the scheduler that owns the cycle counter
+void cpu_attach_scheduler(struct CPU* cpu, struct Scheduler* scheduler);
+// Step until the scheduler's next deadline (the caller dispatches the due events)
+void cpu_run_until_next_event(struct CPU* cpu);
 
 // Step next instruction (or interrupt)
 uint8_t cpu_step_next(struct CPU* cpu);
@@ -261,11 +257,16 @@ uint8_t cpu_step_execute_prefix_cb(struct CPU* cpu);
 // Execute CB Op Code
 uint8_t cpu_step_execute_cb_op_code(struct CPU* cpu, uint8_t op_byte);
 
+// Switch core (cpu_switch.c), used instead of the instruction tables with -DCPU_SWITCH_CORE
+// Execute Op Code, including the CB prefix
+uint8_t cpu_step_execute_switch(struct CPU* cpu, uint8_t op_byte);
+
+// Execute CB Op Code
+uint8_t cpu_step_execute_switch_cb(struct CPU* cpu, uint8_t op_byte);
+
 // Execute Main Op Code
 uint8_t cpu_step_execute_main(struct CPU* cpu, uint8_t op_byte);
 
-// Set serial output
-void cpu_set_serial_output(struct CPU* cpu, bool serial_output);
 
 // Read byte from MMU
 uint8_t cpu_step_read_byte(struct CPU* cpu);
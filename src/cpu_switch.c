@@ -0,0 +1,699 @@
+#include "cpu.h"
+
+// Switch interpreter core
+// Alternative to the instruction table dispatch: one dense switch with a dedicated case for every
+// opcode (and every CB opcode). Registers are accessed directly instead of through the
+// InstructionParam decode and the Registers method pointers.
+// Selected at build time with -DCPU_SWITCH_CORE (make CPU_CORE=switch).
+
+#define REG(reg) (cpu->registers->reg_primary[reg])
+#define REG_SP   (cpu->registers->reg_control[SP])
+#define REG_PC   (cpu->registers->reg_control[PC])
+
+// F goes through the register accessors so pending lazy flags are materialized or dropped
+#define FLAG_IS_SET(flag) registers_get_flag(cpu->registers, flag)
+#define SET_FLAGS(z, n, h, c)                                                     \
+    registers_set_byte(cpu->registers,                                            \
+                       F,                                                         \
+                       ((z) ? Flag_Z : 0) | ((n) ? Flag_N : 0) | ((h) ? Flag_H : 0) | \
+                           ((c) ? Flag_C : 0))
+#define RECORD_FLAGS(operation, operand_1, operand_2, carry, result) \
+    registers_record_flags(cpu->registers, operation, operand_1, operand_2, carry, result)
+
+// Register pairs
+
+static inline uint16_t switch_get_pair(struct CPU* cpu, enum RegisterPair rp)
+{
+    return registers_get_pair(cpu->registers, rp);
+}
+
+static inline void switch_set_pair(struct CPU* cpu, enum RegisterPair rp, uint16_t value)
+{
+    registers_set_pair(cpu->registers, rp, value);
+}
+
+// Memory and stack
+
+static inline uint8_t switch_read_imm_byte(struct CPU* cpu)
+{
+    return mmu_get_byte(cpu->mmu, REG_PC++);
+}
+
+static inline uint16_t switch_read_imm_word(struct CPU* cpu)
+{
+    uint16_t word = mmu_get_word(cpu->mmu, REG_PC);
+    REG_PC += 2;
+    return word;
+}
+
+static inline void switch_push(struct CPU* cpu, uint16_t value)
+{
+    REG_SP -= 2;
+    mmu_set_word(cpu->mmu, REG_SP, value);
+}
+
+static inline uint16_t switch_pop(struct CPU* cpu)
+{
+    uint16_t value = mmu_get_word(cpu->mmu, REG_SP);
+    REG_SP += 2;
+    return value;
+}
+
+// ALU
+
+static inline void switch_add(struct CPU* cpu, uint8_t value, uint8_t carry)
+{
+    uint8_t  a      = REG(A);
+    uint16_t result = a + value + carry;
+    RECORD_FLAGS(FlagOperation_Add, a, value, carry, result);
+    REG(A) = result & 0xFF;
+}
+
+// SUB, SBC and CP (store = false)
+static inline void switch_sub(struct CPU* cpu, uint8_t value, uint8_t carry, bool store)
+{
+    uint8_t  a      = REG(A);
+    uint16_t result = a - value - carry;
+    RECORD_FLAGS(FlagOperation_Sub, a, value, carry, result);
+    if (store) {
+        REG(A) = result & 0xFF;
+    }
+}
+
+static inline void switch_and(struct CPU* cpu, uint8_t value)
+{
+    REG(A) &= value;
+    RECORD_FLAGS(FlagOperation_And, 0, 0, 0, REG(A));
+}
+
+static inline void switch_xor(struct CPU* cpu, uint8_t value)
+{
+    REG(A) ^= value;
+    RECORD_FLAGS(FlagOperation_Logic, 0, 0, 0, REG(A));
+}
+
+static inline void switch_or(struct CPU* cpu, uint8_t value)
+{
+    REG(A) |= value;
+    RECORD_FLAGS(FlagOperation_Logic, 0, 0, 0, REG(A));
+}
+
+static inline uint8_t switch_inc(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = value + 1;
+    RECORD_FLAGS(FlagOperation_Inc, value, 1, registers_get_carry(cpu->registers), result);
+    return result;
+}
+
+static inline uint8_t switch_dec(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = value - 1;
+    RECORD_FLAGS(FlagOperation_Dec, value, 1, registers_get_carry(cpu->registers), result);
+    return result;
+}
+
+static inline void switch_add_hl(struct CPU* cpu, uint16_t value)
+{
+    uint16_t hl     = switch_get_pair(cpu, HL);
+    uint32_t result = hl + value;
+    SET_FLAGS(FLAG_IS_SET(Flag_Z), false, (hl & 0x0FFF) + (value & 0x0FFF) > 0x0FFF, result > 0xFFFF);
+    switch_set_pair(cpu, HL, result & 0xFFFF);
+}
+
+// SP + r8, shared by ADD SP, r8 and LD HL, SP + r8
+static inline uint16_t switch_sp_plus_imm(struct CPU* cpu)
+{
+    uint8_t  offset = switch_read_imm_byte(cpu);
+    uint16_t sp     = REG_SP;
+    SET_FLAGS(false, false, (sp & 0x0F) + (offset & 0x0F) > 0x0F, (sp & 0xFF) + offset > 0xFF);
+    return sp + (int8_t)offset;
+}
+
+static inline void switch_daa(struct CPU* cpu)
+{
+    uint8_t a      = REG(A);
+    uint8_t adjust = FLAG_IS_SET(Flag_C) ? 0x60 : 0x00;
+    if (FLAG_IS_SET(Flag_H)) {
+        adjust |= 0x06;
+    }
+    if (!FLAG_IS_SET(Flag_N)) {
+        if ((a & 0x0F) > 0x09) {
+            adjust |= 0x06;
+        }
+        if (a > 0x99) {
+            adjust |= 0x60;
+        }
+        a += adjust;
+    }
+    else {
+        a -= adjust;
+    }
+    SET_FLAGS(a == 0, FLAG_IS_SET(Flag_N), false, adjust >= 0x60);
+    REG(A) = a;
+}
+
+// CB page helpers, they set all flags like the table core
+
+static inline uint8_t switch_rlc(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value << 1) | (value >> 7);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x80) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_rrc(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value >> 1) | (value << 7);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x01) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_rl(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value << 1) | FLAG_IS_SET(Flag_C);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x80) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_rr(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value >> 1) | (FLAG_IS_SET(Flag_C) << 7);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x01) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_sla(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = value << 1;
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x80) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_sra(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value >> 1) | (value & 0x80);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x01) != 0, result);
+    return result;
+}
+
+static inline uint8_t switch_swap(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = (value >> 4) | (value << 4);
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, 0, result);
+    return result;
+}
+
+static inline uint8_t switch_srl(struct CPU* cpu, uint8_t value)
+{
+    uint8_t result = value >> 1;
+    RECORD_FLAGS(FlagOperation_Shift, 0, 0, (value & 0x01) != 0, result);
+    return result;
+}
+
+static inline void switch_bit(struct CPU* cpu, uint8_t value, uint8_t bit_position)
+{
+    SET_FLAGS(!((value >> bit_position) & 0x01), false, true, FLAG_IS_SET(Flag_C));
+}
+
+static void switch_halt(struct CPU* cpu)
+{
+    // Game Boy HALT bug: When IME=0 and interrupts are pending,
+    // the next instruction after HALT gets executed twice
+    if (!cpu->interrupt_master_enable && cpu->mmu->interrupt_pending) {
+        REG_PC--;
+    }
+    else {
+        cpu->halted = true;
+    }
+}
+
+// Opcode families, expanded into one case per opcode
+
+// LD r, r'
+#define CASE_LD_R_R(op, to, from) \
+    case op: REG(to) = REG(from); break;
+
+// LD r, (HL) / LD (HL), r
+#define CASE_LD_R_HL(op, to) \
+    case op: REG(to) = mmu_get_byte(cpu->mmu, switch_get_pair(cpu, HL)); break;
+#define CASE_LD_HL_R(op, from) \
+    case op: mmu_set_byte(cpu->mmu, switch_get_pair(cpu, HL), REG(from)); break;
+
+// 8-bit ALU on A, register operand at op, (HL) at op + 6
+#define CASE_ALU_GROUP(base, statement)                                       \
+    case base + 0: { uint8_t value = REG(B); statement; } break;              \
+    case base + 1: { uint8_t value = REG(C); statement; } break;              \
+    case base + 2: { uint8_t value = REG(D); statement; } break;              \
+    case base + 3: { uint8_t value = REG(E); statement; } break;              \
+    case base + 4: { uint8_t value = REG(H); statement; } break;              \
+    case base + 5: { uint8_t value = REG(L); statement; } break;              \
+    case base + 6: {                                                          \
+        uint8_t value = mmu_get_byte(cpu->mmu, switch_get_pair(cpu, HL));     \
+        statement;                                                            \
+    } break;                                                                  \
+    case base + 7: { uint8_t value = REG(A); statement; } break;
+
+// CB page: read-modify-write on a register or (HL)
+#define CASE_CB_RMW_R(op, reg, fn) \
+    case op: REG(reg) = fn(cpu, REG(reg)); break;
+#define CASE_CB_RMW_HL(op, fn)                                            \
+    case op: {                                                            \
+        uint16_t address = switch_get_pair(cpu, HL);                      \
+        mmu_set_byte(cpu->mmu, address, fn(cpu, mmu_get_byte(cpu->mmu, address))); \
+    } break;
+#define CASE_CB_RMW_GROUP(base, fn)    \
+    CASE_CB_RMW_R(base + 0, B, fn)     \
+    CASE_CB_RMW_R(base + 1, C, fn)     \
+    CASE_CB_RMW_R(base + 2, D, fn)     \
+    CASE_CB_RMW_R(base + 3, E, fn)     \
+    CASE_CB_RMW_R(base + 4, H, fn)     \
+    CASE_CB_RMW_R(base + 5, L, fn)     \
+    CASE_CB_RMW_HL(base + 6, fn)       \
+    CASE_CB_RMW_R(base + 7, A, fn)
+
+// CB page: BIT n
+#define CASE_CB_BIT_GROUP(base, n)                                                         \
+    case base + 0: switch_bit(cpu, REG(B), n); break;                                      \
+    case base + 1: switch_bit(cpu, REG(C), n); break;                                      \
+    case base + 2: switch_bit(cpu, REG(D), n); break;                                      \
+    case base + 3: switch_bit(cpu, REG(E), n); break;                                      \
+    case base + 4: switch_bit(cpu, REG(H), n); break;                                      \
+    case base + 5: switch_bit(cpu, REG(L), n); break;                                      \
+    case base + 6: switch_bit(cpu, mmu_get_byte(cpu->mmu, switch_get_pair(cpu, HL)), n); break; \
+    case base + 7: switch_bit(cpu, REG(A), n); break;
+
+// CB page: RES n / SET n
+#define SWITCH_RES(n) (uint8_t)(~(1 << (n)))
+#define CASE_CB_RES_GROUP(base, n)                                                  \
+    case base + 0: REG(B) &= SWITCH_RES(n); break;                                  \
+    case base + 1: REG(C) &= SWITCH_RES(n); break;                                  \
+    case base + 2: REG(D) &= SWITCH_RES(n); break;                                  \
+    case base + 3: REG(E) &= SWITCH_RES(n); break;                                  \
+    case base + 4: REG(H) &= SWITCH_RES(n); break;                                  \
+    case base + 5: REG(L) &= SWITCH_RES(n); break;                                  \
+    case base + 6: {                                                                \
+        uint16_t address = switch_get_pair(cpu, HL);                                \
+        mmu_set_byte(cpu->mmu, address, mmu_get_byte(cpu->mmu, address) & SWITCH_RES(n)); \
+    } break;                                                                        \
+    case base + 7: REG(A) &= SWITCH_RES(n); break;
+#define CASE_CB_SET_GROUP(base, n)                                                  \
+    case base + 0: REG(B) |= 1 << (n); break;                                       \
+    case base + 1: REG(C) |= 1 << (n); break;                                       \
+    case base + 2: REG(D) |= 1 << (n); break;                                       \
+    case base + 3: REG(E) |= 1 << (n); break;                                       \
+    case base + 4: REG(H) |= 1 << (n); break;                                       \
+    case base + 5: REG(L) |= 1 << (n); break;                                       \
+    case base + 6: {                                                                \
+        uint16_t address = switch_get_pair(cpu, HL);                                \
+        mmu_set_byte(cpu->mmu, address, mmu_get_byte(cpu->mmu, address) | (1 << (n))); \
+    } break;                                                                        \
+    case base + 7: REG(A) |= 1 << (n); break;
+
+uint8_t cpu_step_execute_switch_cb(struct CPU* cpu, uint8_t op_byte)
+{
+    CPU_TRACE_PRINT("Executing CB Op Code: 0xCB%02X\n", op_byte);
+    switch (op_byte) {
+        CASE_CB_RMW_GROUP(0x00, switch_rlc)
+        CASE_CB_RMW_GROUP(0x08, switch_rrc)
+        CASE_CB_RMW_GROUP(0x10, switch_rl)
+        CASE_CB_RMW_GROUP(0x18, switch_rr)
+        CASE_CB_RMW_GROUP(0x20, switch_sla)
+        CASE_CB_RMW_GROUP(0x28, switch_sra)
+        CASE_CB_RMW_GROUP(0x30, switch_swap)
+        CASE_CB_RMW_GROUP(0x38, switch_srl)
+        CASE_CB_BIT_GROUP(0x40, 0)
+        CASE_CB_BIT_GROUP(0x48, 1)
+        CASE_CB_BIT_GROUP(0x50, 2)
+        CASE_CB_BIT_GROUP(0x58, 3)
+        CASE_CB_BIT_GROUP(0x60, 4)
+        CASE_CB_BIT_GROUP(0x68, 5)
+        CASE_CB_BIT_GROUP(0x70, 6)
+        CASE_CB_BIT_GROUP(0x78, 7)
+        CASE_CB_RES_GROUP(0x80, 0)
+        CASE_CB_RES_GROUP(0x88, 1)
+        CASE_CB_RES_GROUP(0x90, 2)
+        CASE_CB_RES_GROUP(0x98, 3)
+        CASE_CB_RES_GROUP(0xA0, 4)
+        CASE_CB_RES_GROUP(0xA8, 5)
+        CASE_CB_RES_GROUP(0xB0, 6)
+        CASE_CB_RES_GROUP(0xB8, 7)
+        CASE_CB_SET_GROUP(0xC0, 0)
+        CASE_CB_SET_GROUP(0xC8, 1)
+        CASE_CB_SET_GROUP(0xD0, 2)
+        CASE_CB_SET_GROUP(0xD8, 3)
+        CASE_CB_SET_GROUP(0xE0, 4)
+        CASE_CB_SET_GROUP(0xE8, 5)
+        CASE_CB_SET_GROUP(0xF0, 6)
+        CASE_CB_SET_GROUP(0xF8, 7)
+    }
+    return cpu->opcode_cycle_prefix_cb[op_byte] + CB_PREFIX_CYCLES;
+}
+
+// Conditional jumps: cc is encoded in bits 3-4 of the opcode
+static inline bool switch_condition(struct CPU* cpu, uint8_t op_byte)
+{
+    switch ((op_byte >> 3) & 0x03) {
+    case JumpCondition_NZ: return !FLAG_IS_SET(Flag_Z);
+    case JumpCondition_Z: return FLAG_IS_SET(Flag_Z);
+    case JumpCondition_NC: return !FLAG_IS_SET(Flag_C);
+    default: return FLAG_IS_SET(Flag_C);
+    }
+}
+
+uint8_t cpu_step_execute_switch(struct CPU* cpu, uint8_t op_byte)
+{
+    CPU_TRACE_PRINT("Executing Op Code: 0x%02X\n", op_byte);
+    switch (op_byte) {
+    // 0x00: NOP
+    case 0x00: break;
+    // 0x01 / 0x11 / 0x21: LD rr, d16
+    case 0x01: switch_set_pair(cpu, BC, switch_read_imm_word(cpu)); break;
+    case 0x11: switch_set_pair(cpu, DE, switch_read_imm_word(cpu)); break;
+    case 0x21: switch_set_pair(cpu, HL, switch_read_imm_word(cpu)); break;
+    // 0x31: LD SP, d16
+    case 0x31: REG_SP = switch_read_imm_word(cpu); break;
+    // 0x02 / 0x12: LD (rr), A
+    case 0x02: mmu_set_byte(cpu->mmu, switch_get_pair(cpu, BC), REG(A)); break;
+    case 0x12: mmu_set_byte(cpu->mmu, switch_get_pair(cpu, DE), REG(A)); break;
+    // 0x22 / 0x32: LD (HL+/-), A
+    case 0x22: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        mmu_set_byte(cpu->mmu, hl, REG(A));
+        switch_set_pair(cpu, HL, hl + 1);
+    } break;
+    case 0x32: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        mmu_set_byte(cpu->mmu, hl, REG(A));
+        switch_set_pair(cpu, HL, hl - 1);
+    } break;
+    // 0x0A / 0x1A: LD A, (rr)
+    case 0x0A: REG(A) = mmu_get_byte(cpu->mmu, switch_get_pair(cpu, BC)); break;
+    case 0x1A: REG(A) = mmu_get_byte(cpu->mmu, switch_get_pair(cpu, DE)); break;
+    // 0x2A / 0x3A: LD A, (HL+/-)
+    case 0x2A: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        REG(A)      = mmu_get_byte(cpu->mmu, hl);
+        switch_set_pair(cpu, HL, hl + 1);
+    } break;
+    case 0x3A: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        REG(A)      = mmu_get_byte(cpu->mmu, hl);
+        switch_set_pair(cpu, HL, hl - 1);
+    } break;
+    // INC rr / DEC rr
+    case 0x03: switch_set_pair(cpu, BC, switch_get_pair(cpu, BC) + 1); break;
+    case 0x13: switch_set_pair(cpu, DE, switch_get_pair(cpu, DE) + 1); break;
+    case 0x23: switch_set_pair(cpu, HL, switch_get_pair(cpu, HL) + 1); break;
+    case 0x33: REG_SP++; break;
+    case 0x0B: switch_set_pair(cpu, BC, switch_get_pair(cpu, BC) - 1); break;
+    case 0x1B: switch_set_pair(cpu, DE, switch_get_pair(cpu, DE) - 1); break;
+    case 0x2B: switch_set_pair(cpu, HL, switch_get_pair(cpu, HL) - 1); break;
+    case 0x3B: REG_SP--; break;
+    // INC r / DEC r
+    case 0x04: REG(B) = switch_inc(cpu, REG(B)); break;
+    case 0x0C: REG(C) = switch_inc(cpu, REG(C)); break;
+    case 0x14: REG(D) = switch_inc(cpu, REG(D)); break;
+    case 0x1C: REG(E) = switch_inc(cpu, REG(E)); break;
+    case 0x24: REG(H) = switch_inc(cpu, REG(H)); break;
+    case 0x2C: REG(L) = switch_inc(cpu, REG(L)); break;
+    case 0x3C: REG(A) = switch_inc(cpu, REG(A)); break;
+    case 0x05: REG(B) = switch_dec(cpu, REG(B)); break;
+    case 0x0D: REG(C) = switch_dec(cpu, REG(C)); break;
+    case 0x15: REG(D) = switch_dec(cpu, REG(D)); break;
+    case 0x1D: REG(E) = switch_dec(cpu, REG(E)); break;
+    case 0x25: REG(H) = switch_dec(cpu, REG(H)); break;
+    case 0x2D: REG(L) = switch_dec(cpu, REG(L)); break;
+    case 0x3D: REG(A) = switch_dec(cpu, REG(A)); break;
+    // 0x34 / 0x35: INC (HL) / DEC (HL)
+    case 0x34: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        mmu_set_byte(cpu->mmu, hl, switch_inc(cpu, mmu_get_byte(cpu->mmu, hl)));
+    } break;
+    case 0x35: {
+        uint16_t hl = switch_get_pair(cpu, HL);
+        mmu_set_byte(cpu->mmu, hl, switch_dec(cpu, mmu_get_byte(cpu->mmu, hl)));
+    } break;
+    // LD r, d8
+    case 0x06: REG(B) = switch_read_imm_byte(cpu); break;
+    case 0x0E: REG(C) = switch_read_imm_byte(cpu); break;
+    case 0x16: REG(D) = switch_read_imm_byte(cpu); break;
+    case 0x1E: REG(E) = switch_read_imm_byte(cpu); break;
+    case 0x26: REG(H) = switch_read_imm_byte(cpu); break;
+    case 0x2E: REG(L) = switch_read_imm_byte(cpu); break;
+    case 0x3E: REG(A) = switch_read_imm_byte(cpu); break;
+    // 0x36: LD (HL), d8
+    case 0x36: {
+        uint8_t value = switch_read_imm_byte(cpu);
+        mmu_set_byte(cpu->mmu, switch_get_pair(cpu, HL), value);
+    } break;
+    // 0x07 / 0x0F / 0x17 / 0x1F: RLCA / RRCA / RLA / RRA
+    case 0x07: {
+        uint8_t a = REG(A);
+        REG(A)    = (a << 1) | (a >> 7);
+        RECORD_FLAGS(FlagOperation_RotateA, 0, 0, (a & 0x80) != 0, REG(A));
+    } break;
+    case 0x0F: {
+        uint8_t a = REG(A);
+        REG(A)    = (a >> 1) | (a << 7);
+        RECORD_FLAGS(FlagOperation_RotateA, 0, 0, (a & 0x01) != 0, REG(A));
+    } break;
+    case 0x17: {
+        uint8_t a = REG(A);
+        REG(A)    = (a << 1) | FLAG_IS_SET(Flag_C);
+        RECORD_FLAGS(FlagOperation_RotateA, 0, 0, (a & 0x80) != 0, REG(A));
+    } break;
+    case 0x1F: {
+        uint8_t a = REG(A);
+        REG(A)    = (a >> 1) | (FLAG_IS_SET(Flag_C) << 7);
+        RECORD_FLAGS(FlagOperation_RotateA, 0, 0, (a & 0x01) != 0, REG(A));
+    } break;
+    // 0x08: LD (a16), SP
+    case 0x08: mmu_set_word(cpu->mmu, switch_read_imm_word(cpu), REG_SP); break;
+    // ADD HL, rr
+    case 0x09: switch_add_hl(cpu, switch_get_pair(cpu, BC)); break;
+    case 0x19: switch_add_hl(cpu, switch_get_pair(cpu, DE)); break;
+    case 0x29: switch_add_hl(cpu, switch_get_pair(cpu, HL)); break;
+    case 0x39: switch_add_hl(cpu, REG_SP); break;
+    // 0x10: STOP
+    case 0x10: cpu->stopped = true; break;
+    // 0x18: JR r8
+    case 0x18: {
+        int8_t offset = (int8_t)switch_read_imm_byte(cpu);
+        REG_PC += offset;
+    } break;
+    // JR cc, r8
+    case 0x20:
+    case 0x28:
+    case 0x30:
+    case 0x38: {
+        int8_t offset = (int8_t)switch_read_imm_byte(cpu);
+        if (switch_condition(cpu, op_byte)) {
+            REG_PC += offset;
+            return 3;
+        }
+    } break;
+    // 0x27: DAA
+    case 0x27: switch_daa(cpu); break;
+    // 0x2F: CPL
+    case 0x2F:
+        REG(A) = ~REG(A);
+        registers_set_flag(cpu->registers, Flag_N, true);
+        registers_set_flag(cpu->registers, Flag_H, true);
+        break;
+    // 0x37: SCF
+    case 0x37: SET_FLAGS(FLAG_IS_SET(Flag_Z), false, false, true); break;
+    // 0x3F: CCF
+    case 0x3F: SET_FLAGS(FLAG_IS_SET(Flag_Z), false, false, !FLAG_IS_SET(Flag_C)); break;
+
+    // LD r, r'
+    CASE_LD_R_R(0x40, B, B)
+    CASE_LD_R_R(0x41, B, C)
+    CASE_LD_R_R(0x42, B, D)
+    CASE_LD_R_R(0x43, B, E)
+    CASE_LD_R_R(0x44, B, H)
+    CASE_LD_R_R(0x45, B, L)
+    CASE_LD_R_HL(0x46, B)
+    CASE_LD_R_R(0x47, B, A)
+    CASE_LD_R_R(0x48, C, B)
+    CASE_LD_R_R(0x49, C, C)
+    CASE_LD_R_R(0x4A, C, D)
+    CASE_LD_R_R(0x4B, C, E)
+    CASE_LD_R_R(0x4C, C, H)
+    CASE_LD_R_R(0x4D, C, L)
+    CASE_LD_R_HL(0x4E, C)
+    CASE_LD_R_R(0x4F, C, A)
+    CASE_LD_R_R(0x50, D, B)
+    CASE_LD_R_R(0x51, D, C)
+    CASE_LD_R_R(0x52, D, D)
+    CASE_LD_R_R(0x53, D, E)
+    CASE_LD_R_R(0x54, D, H)
+    CASE_LD_R_R(0x55, D, L)
+    CASE_LD_R_HL(0x56, D)
+    CASE_LD_R_R(0x57, D, A)
+    CASE_LD_R_R(0x58, E, B)
+    CASE_LD_R_R(0x59, E, C)
+    CASE_LD_R_R(0x5A, E, D)
+    CASE_LD_R_R(0x5B, E, E)
+    CASE_LD_R_R(0x5C, E, H)
+    CASE_LD_R_R(0x5D, E, L)
+    CASE_LD_R_HL(0x5E, E)
+    CASE_LD_R_R(0x5F, E, A)
+    CASE_LD_R_R(0x60, H, B)
+    CASE_LD_R_R(0x61, H, C)
+    CASE_LD_R_R(0x62, H, D)
+    CASE_LD_R_R(0x63, H, E)
+    CASE_LD_R_R(0x64, H, H)
+    CASE_LD_R_R(0x65, H, L)
+    CASE_LD_R_HL(0x66, H)
+    CASE_LD_R_R(0x67, H, A)
+    CASE_LD_R_R(0x68, L, B)
+    CASE_LD_R_R(0x69, L, C)
+    CASE_LD_R_R(0x6A, L, D)
+    CASE_LD_R_R(0x6B, L, E)
+    CASE_LD_R_R(0x6C, L, H)
+    CASE_LD_R_R(0x6D, L, L)
+    CASE_LD_R_HL(0x6E, L)
+    CASE_LD_R_R(0x6F, L, A)
+    CASE_LD_HL_R(0x70, B)
+    CASE_LD_HL_R(0x71, C)
+    CASE_LD_HL_R(0x72, D)
+    CASE_LD_HL_R(0x73, E)
+    CASE_LD_HL_R(0x74, H)
+    CASE_LD_HL_R(0x75, L)
+    // 0x76: HALT
+    case 0x76: switch_halt(cpu); break;
+    CASE_LD_HL_R(0x77, A)
+    CASE_LD_R_R(0x78, A, B)
+    CASE_LD_R_R(0x79, A, C)
+    CASE_LD_R_R(0x7A, A, D)
+    CASE_LD_R_R(0x7B, A, E)
+    CASE_LD_R_R(0x7C, A, H)
+    CASE_LD_R_R(0x7D, A, L)
+    CASE_LD_R_HL(0x7E, A)
+    CASE_LD_R_R(0x7F, A, A)
+
+    // 8-bit ALU
+    CASE_ALU_GROUP(0x80, switch_add(cpu, value, 0))
+    CASE_ALU_GROUP(0x88, switch_add(cpu, value, FLAG_IS_SET(Flag_C)))
+    CASE_ALU_GROUP(0x90, switch_sub(cpu, value, 0, true))
+    CASE_ALU_GROUP(0x98, switch_sub(cpu, value, FLAG_IS_SET(Flag_C), true))
+    CASE_ALU_GROUP(0xA0, switch_and(cpu, value))
+    CASE_ALU_GROUP(0xA8, switch_xor(cpu, value))
+    CASE_ALU_GROUP(0xB0, switch_or(cpu, value))
+    CASE_ALU_GROUP(0xB8, switch_sub(cpu, value, 0, false))
+
+    // 8-bit ALU with d8
+    case 0xC6: switch_add(cpu, switch_read_imm_byte(cpu), 0); break;
+    case 0xCE: switch_add(cpu, switch_read_imm_byte(cpu), FLAG_IS_SET(Flag_C)); break;
+    case 0xD6: switch_sub(cpu, switch_read_imm_byte(cpu), 0, true); break;
+    case 0xDE: switch_sub(cpu, switch_read_imm_byte(cpu), FLAG_IS_SET(Flag_C), true); break;
+    case 0xE6: switch_and(cpu, switch_read_imm_byte(cpu)); break;
+    case 0xEE: switch_xor(cpu, switch_read_imm_byte(cpu)); break;
+    case 0xF6: switch_or(cpu, switch_read_imm_byte(cpu)); break;
+    case 0xFE: switch_sub(cpu, switch_read_imm_byte(cpu), 0, false); break;
+
+    // RET cc
+    case 0xC0:
+    case 0xC8:
+    case 0xD0:
+    case 0xD8:
+        if (switch_condition(cpu, op_byte)) {
+            REG_PC = switch_pop(cpu);
+            return 5;
+        }
+        break;
+    // POP rr
+    case 0xC1: switch_set_pair(cpu, BC, switch_pop(cpu)); break;
+    case 0xD1: switch_set_pair(cpu, DE, switch_pop(cpu)); break;
+    case 0xE1: switch_set_pair(cpu, HL, switch_pop(cpu)); break;
+    // Lower 4 bits of F register are always zero
+    case 0xF1: switch_set_pair(cpu, AF, switch_pop(cpu) & 0xFFF0); break;
+    // JP cc, a16
+    case 0xC2:
+    case 0xCA:
+    case 0xD2:
+    case 0xDA: {
+        uint16_t address = switch_read_imm_word(cpu);
+        if (switch_condition(cpu, op_byte)) {
+            REG_PC = address;
+            return 4;
+        }
+    } break;
+    // 0xC3: JP a16
+    case 0xC3: REG_PC = switch_read_imm_word(cpu); break;
+    // CALL cc, a16
+    case 0xC4:
+    case 0xCC:
+    case 0xD4:
+    case 0xDC: {
+        uint16_t address = switch_read_imm_word(cpu);
+        if (switch_condition(cpu, op_byte)) {
+            switch_push(cpu, REG_PC);
+            REG_PC = address;
+            return 6;
+        }
+    } break;
+    // 0xCD: CALL a16
+    case 0xCD: {
+        uint16_t address = switch_read_imm_word(cpu);
+        switch_push(cpu, REG_PC);
+        REG_PC = address;
+    } break;
+    // PUSH rr
+    case 0xC5: switch_push(cpu, switch_get_pair(cpu, BC)); break;
+    case 0xD5: switch_push(cpu, switch_get_pair(cpu, DE)); break;
+    case 0xE5: switch_push(cpu, switch_get_pair(cpu, HL)); break;
+    case 0xF5: switch_push(cpu, switch_get_pair(cpu, AF)); break;
+    // RST n
+    case 0xC7:
+    case 0xCF:
+    case 0xD7:
+    case 0xDF:
+    case 0xE7:
+    case 0xEF:
+    case 0xF7:
+    case 0xFF:
+        switch_push(cpu, REG_PC);
+        REG_PC = op_byte & 0x38;
+        break;
+    // 0xC9: RET
+    case 0xC9: REG_PC = switch_pop(cpu); break;
+    // 0xD9: RETI
+    case 0xD9:
+        REG_PC                       = switch_pop(cpu);
+        cpu->interrupt_master_enable = true;
+        break;
+    // 0xCB: PREFIX CB
+    case 0xCB: return cpu_step_execute_switch_cb(cpu, switch_read_imm_byte(cpu));
+    // 0xE0: LDH (a8), A
+    case 0xE0: mmu_set_byte(cpu->mmu, 0xFF00 + switch_read_imm_byte(cpu), REG(A)); break;
+    // 0xF0: LDH A, (a8)
+    case 0xF0: REG(A) = mmu_get_byte(cpu->mmu, 0xFF00 + switch_read_imm_byte(cpu)); break;
+    // 0xE2: LD (C), A
+    case 0xE2: mmu_set_byte(cpu->mmu, 0xFF00 + REG(C), REG(A)); break;
+    // 0xF2: LD A, (C)
+    case 0xF2: REG(A) = mmu_get_byte(cpu->mmu, 0xFF00 + REG(C)); break;
+    // 0xE8: ADD SP, r8
+    case 0xE8: REG_SP = switch_sp_plus_imm(cpu); break;
+    // 0xF8: LD HL, SP + r8
+    case 0xF8: switch_set_pair(cpu, HL, switch_sp_plus_imm(cpu)); break;
+    // 0xE9: JP (HL)
+    case 0xE9: REG_PC = switch_get_pair(cpu, HL); break;
+    // 0xF9: LD SP, HL
+    case 0xF9: REG_SP = switch_get_pair(cpu, HL); break;
+    // 0xEA: LD (a16), A
+    case 0xEA: mmu_set_byte(cpu->mmu, switch_read_imm_word(cpu), REG(A)); break;
+    // 0xFA: LD A, (a16)
+    case 0xFA: REG(A) = mmu_get_byte(cpu->mmu, switch_read_imm_word(cpu)); break;
+    // 0xF3: DI
+    case 0xF3: cpu->interrupt_master_enable = false; break;
+    // 0xFB: EI
+    case 0xFB: cpu->interrupt_master_enable = true; break;
+
+    // 0xD3, 0xDB, 0xDD, 0xE3, 0xE4, 0xEB, 0xEC, 0xED, 0xF4, 0xFC, 0xFD
+    default:
+        CPU_EMERGENCY_PRINT("Invalid Opcode: 0x%02X\n", op_byte);
+        exit(EXIT_FAILURE);
+    }
+    return cpu->opcode_cycle_main[op_byte];
+}
@@ -1,5 +1,7 @@
 #include "dmg.h"
 
+#include <limits.h>
+
 void show_usage(const char* program_name)
 {
     printf("Usage: %s [options] <rom_file>\n", program_name);
@@ -11,6 +13,15 @@ void show_usage(const char* program_name)
     printf("  -b, --bootrom <file>  Specify custom boot ROM\n");
     printf("  -s, --scale <n>       Window scale factor (1-4, default: 2)\n");
     printf("  -p, --serial          Enable serial output printing\n");
+    printf("  --deferred-render     Draw each frame at V-Blank from a log of mid-frame changes\n");
+    printf("  --render-thread       Draw scanlines on a separate thread\n");
+    printf("  --render-threads <n>  Draw deferred frames with n threads (1-16, default: 1)\n");
+    printf("  --surface             Draw into the window surface instead of a renderer\n");
+    printf("  --scale-filter <f>    Surface scaling filter: nearest, scale2x, scale3x\n");
+    printf("  --integer-scale       Scale the renderer output by whole multiples only\n");
+    printf("  --vsync               Wait for vertical sync when presenting with a renderer\n");
+    printf("  --save-interval <ms>  Flush battery saves every ms milliseconds (0: only on exit, "
+           "default: 1000)\n");
     printf("Examples:\n");
     printf("  %s mario.gb\n", program_name);
     printf("  %s -d -vv zelda.gb\n", program_name);
@@ -32,6 +43,14 @@ struct EmulatorConfig config = {
     .enable_serial_print         = false,
     .print_debug_info_this_frame = false,
     .fast_forward_mode           = false,
+    .deferred_rendering          = false,
+    .render_thread               = false,
+    .render_threads              = 1,
+    .surface_output              = false,
+    .scale_filter                = 0,
+    .integer_scale               = false,
+    .vsync                       = false,
+    .save_interval               = BATTERY_FLUSH_INTERVAL,
     .disable_joypad              = false
 };
 
@@ -49,6 +68,14 @@ struct EmulatorConfig parse_args(int argc, char* argv[])
         .enable_serial_print         = false,
         .print_debug_info_this_frame = false,
         .fast_forward_mode           = false,
+        .deferred_rendering          = false,
+        .render_thread               = false,
+        .render_threads              = 1,
+        .surface_output              = false,
+        .scale_filter                = 0,
+        .integer_scale               = false,
+        .vsync                       = false,
+        .save_interval               = BATTERY_FLUSH_INTERVAL,
         .disable_joypad              = false};
 
     if (argc < 2) {
@@ -96,6 +123,73 @@ struct EmulatorConfig parse_args(int argc, char* argv[])
         else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--serial") == 0) {
             config.enable_serial_print = true;
         }
+        else if (strcmp(argv[i], "--deferred-render") == 0) {
+            config.deferred_rendering = true;
+        }
+        else if (strcmp(argv[i], "--render-thread") == 0) {
+            config.render_thread = true;
+        }
+        else if (strcmp(argv[i], "--surface") == 0) {
+            config.surface_output = true;
+        }
+        else if (strcmp(argv[i], "--scale-filter") == 0) {
+            if (i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "nearest") == 0) {
+                    config.scale_filter = UPSCALE_NEAREST;
+                }
+                else if (strcmp(argv[i], "scale2x") == 0) {
+                    config.scale_filter = UPSCALE_SCALE2X;
+                }
+                else if (strcmp(argv[i], "scale3x") == 0) {
+                    config.scale_filter = UPSCALE_SCALE3X;
+                }
+                else {
+                    fprintf(stderr, "Error: Unknown scale filter '%s'\n", argv[i]);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else {
+                fprintf(stderr, "Error: Scale filter missing\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--integer-scale") == 0) {
+            config.integer_scale = true;
+        }
+        else if (strcmp(argv[i], "--vsync") == 0) {
+            config.vsync = true;
+        }
+        else if (strcmp(argv[i], "--save-interval") == 0) {
+            if (i + 1 < argc) {
+                char* end;
+                long  interval = strtol(argv[++i], &end, 10);
+                if (end == argv[i] || *end != '\0' || interval < 0 || interval > INT_MAX) {
+                    fprintf(stderr,
+                            "Error: Save interval must be a non-negative number of milliseconds\n");
+                    exit(EXIT_FAILURE);
+                }
+                config.save_interval = (int)interval;
+            }
+            else {
+                fprintf(stderr, "Error: Save interval missing\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "--render-threads") == 0) {
+            if (i + 1 < argc) {
+                config.render_threads = atoi(argv[++i]);
+                if (config.render_threads < 1 || config.render_threads > RENDER_POOL_MAX_THREADS) {
+                    fprintf(stderr, "Error: Render threads must be between 1 and %d\n",
+                            RENDER_POOL_MAX_THREADS);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else {
+                fprintf(stderr, "Error: Render thread count missing\n");
+                exit(EXIT_FAILURE);
+            }
+        }
         else if (config.rom_path == NULL) {
             config.rom_path = argv[i];
         }
@@ -185,6 +279,29 @@ int main(int argc, char* argv[])
     DMG_DEBUG_PRINT("Attaching mmu to ppu...%s", "\n");
     ppu_attach_mmu(ppu, mmu);
 
+    // bring up render pool, it replaces the single render worker
+    if (config.render_threads > 1) {
+        DMG_DEBUG_PRINT("Bringing up render pool with %d threads...\n", config.render_threads);
+        struct RenderPool* render_pool = create_render_pool(ppu, config.render_threads);
+        if (render_pool == NULL) {
+            DMG_WARN_PRINT("Failed to create render pool, drawing on the emulation thread\n");
+        }
+        else {
+            ppu_attach_render_pool(ppu, render_pool);
+        }
+    }
+    // bring up render worker
+    else if (config.render_thread) {
+        DMG_DEBUG_PRINT("Bringing up render worker...%s", "\n");
+        struct RenderWorker* render_worker = create_render_worker(ppu);
+        if (render_worker == NULL) {
+            DMG_WARN_PRINT("Failed to create render worker, drawing on the emulation thread\n");
+        }
+        else {
+            ppu_attach_render_worker(ppu, render_worker);
+        }
+    }
+
     // bring up registers
     DMG_DEBUG_PRINT("Bringing up registers...%s", "\n");
     struct Registers* registers = create_registers();
@@ -200,7 +317,6 @@ int main(int argc, char* argv[])
         DMG_EMERGENCY_PRINT("Failed to create cpu\n");
         exit(EXIT_FAILURE);
     }
-    cpu_set_serial_output(cpu, config.enable_serial_print);
 
     // bring up timer
     DMG_DEBUG_PRINT("Bringing up timer...%s", "\n");
@@ -209,10 +325,8 @@ int main(int argc, char* argv[])
         DMG_EMERGENCY_PRINT("Failed to create timer\n");
         exit(EXIT_FAILURE);
     }
-    DMG_DEBUG_PRINT("Attaching ram to timer...%s", "\n");
-    timer_attach_ram(timer, ram);
-    DMG_DEBUG_PRINT("Attaching cpu to timer...%s", "\n");
-    cpu_attach_timer(cpu, timer);
+    DMG_DEBUG_PRINT("Attaching timer to mmu...%s", "\n");
+    mmu_attach_timer(mmu, timer);
 
     // bring up apu
     DMG_DEBUG_PRINT("Bringing up APU...%s", "\n");
@@ -226,6 +340,32 @@ int main(int argc, char* argv[])
     DMG_DEBUG_PRINT("Attaching APU to MMU...%s", "\n");
     mmu_attach_apu(mmu, apu);
 
+    // bring up serial port
+    DMG_DEBUG_PRINT("Bringing up serial port...%s", "\n");
+    struct Serial* serial = create_serial();
+    if (serial == NULL) {
+        DMG_EMERGENCY_PRINT("Failed to create serial port\n");
+        exit(EXIT_FAILURE);
+    }
+    serial_set_print_output(serial, config.enable_serial_print);
+    DMG_DEBUG_PRINT("Attaching serial port to mmu...%s", "\n");
+    mmu_attach_serial(mmu, serial);
+
+    // bring up scheduler
+    DMG_DEBUG_PRINT("Bringing up scheduler...%s", "\n");
+    struct Scheduler* scheduler = create_scheduler();
+    if (scheduler == NULL) {
+        DMG_EMERGENCY_PRINT("Failed to create scheduler\n");
+        exit(EXIT_FAILURE);
+    }
+    DMG_DEBUG_PRINT("Attaching scheduler to cpu, mmu, ppu, APU, serial port and timer...%s", "\n");
+    cpu_attach_scheduler(cpu, scheduler);
+    mmu_attach_scheduler(mmu, scheduler);
+    ppu_attach_scheduler(ppu, scheduler);
+    apu_attach_scheduler(apu, scheduler);
+    serial_attach_scheduler(serial, scheduler);
+    timer_attach_scheduler(timer, scheduler);
+
     // bring up joypad
     DMG_DEBUG_PRINT("Bringing up joypad...%s", "\n");
     struct Joypad* joypad = create_joypad(mmu);
@@ -278,7 +418,9 @@ int main(int argc, char* argv[])
     // Clean up
     DMG_DEBUG_PRINT("Cleaning up...%s", "\n");
     free_apu(apu);
+    free_serial(serial);
     free_cpu(cpu);
+    free_scheduler(scheduler);
     free_form(form);
 
     return 0;
@@ -300,10 +442,11 @@ void main_loop(struct PPU* ppu, struct CPU* cpu, struct Timer* timer, struct For
             break;
         }
 
-        next_frame(ppu, cpu, frame_count);
+        next_frame(ppu, cpu);
 
-        // update surface
-        update_surface(form);
+        // update surface, the render worker flips the framebuffer every frame
+        set_framebuffer(form);
+        form->update_surface(form);
 
         // sleep to maintain fps
         double current_time = get_time_in_seconds();
@@ -328,94 +471,13 @@ void main_loop(struct PPU* ppu, struct CPU* cpu, struct Timer* timer, struct For
     }
 }
 
-void next_frame(struct PPU* ppu, struct CPU* cpu, int current_frame)
+void next_frame(struct PPU* ppu, struct CPU* cpu)
 {
-    // Check if LCD is disabled
-    while (!ppu_is_lcd_enabled(ppu)) {
-        // When LCD is disabled, set LY to 0 and stay in V-Blank
-        ppu_set_mode(ppu, MODE_VBLANK);
-        ppu_set_ly(ppu, 0);
-        // Execute instructions for a full frame duration (154 scanlines)
-        for (uint8_t i = 0; i < 154; i++) {
-            cpu_step_for_cycles(cpu, 456);
-            // APU timing handled entirely by callback - no stepping needed!
-            // Don't step PPU when LCD is disabled
-        }
-        return;
-    }
-
-    // "Render" 144 visible scanlines (0-143)
-    for (uint8_t ly = 0; ly < 144; ly++) {
-        uint8_t lcdc_current = cpu->mmu->mmu_get_byte(cpu->mmu, LCDC_ADDRESS);
-        // reset interrupt flag
-        // uint8_t int_flag = cpu->mmu->mmu_get_byte(cpu->mmu, IF_ADDRESS);
-        // int_flag &= 0xFC;
-        // cpu->mmu->mmu_set_byte(cpu->mmu, IF_ADDRESS, int_flag);
-        // OAM Scan (Mode 2)
-        // https://hacktix.github.io/GBEDG/ppu/
-        // This mode is entered at the start of every scanline (except for V-Blank) before pixels
-        // are actually drawn to the screen. During this mode the PPU searches OAM memory for
-        // sprites that should be rendered on the current scanline and stores them in a buffer. This
-        // procedure takes a total amount of 80 T-Cycles, meaning that the PPU checks a new OAM
-        // entry every 2 T-Cycles. A sprite is only added to the buffer if all of the following
-        // conditions apply: Sprite X-Position must be greater than 0 LY + 16 must be greater than
-        // or equal to Sprite Y-Position LY + 16 must be less than Sprite Y-Position + Sprite Height
-        // (8 in Normal Mode, 16 in Tall-Sprite-Mode) The amount of sprites already stored in the
-        // OAM Buffer must be less than 10 CPU can't access OAM here
-        ppu_set_ly(ppu, ly);
-        ppu_set_mode(ppu, MODE_OAM_SEARCH);
-        if ((config.fast_forward_mode && current_frame % 4 == 0) || !config.fast_forward_mode) {
-            ppu_oam_search(ppu);  // Actually perform OAM search to populate sprite buffer!
-        }
-        cpu_step_for_cycles(cpu, 80);
-
-        // Pixel Transfer (Mode 3)
-        // https://hacktix.github.io/GBEDG/ppu/
-        // The Drawing Mode is where the PPU transfers pixels to the LCD. The duration of this mode
-        // changes depending on multiple variables, such as background scrolling, the amount of
-        // sprites on the scanline, whether or not the window should be rendered, etc. All of the
-        // specifics to these timing differences will be explained later on. CPU can't access VRAM
-        // and OAM here
-        ppu_set_mode(ppu, MODE_PIXEL_TRANSFER);
-        cpu_step_for_cycles(cpu, 172);
-        if ((config.fast_forward_mode && current_frame % 4 == 0) || !config.fast_forward_mode) {
-            ppu_render_scanline_ly(ppu, ly);
-        }
-        // ppu_render_scanline_fifo(ppu, ly);
-
-        // MODE 0: H-Blank (204 cycles to complete 456 total)
-        // H-Blank (Mode 0)
-        // https://hacktix.github.io/GBEDG/ppu/
-        // This mode takes up the remainder of the scanline after the Drawing Mode finishes, more or
-        // less "padding" the duration of the scanline to a total of 456 T-Cycles. The PPU
-        // effectively pauses during this mode.
-        ppu_set_mode(ppu, MODE_HBLANK);
-        cpu_step_for_cycles(cpu, 204);
-    }
-
-    // V-Blank interrupt happening here
-    uint8_t int_flag = cpu->mmu->mmu_get_byte(cpu->mmu, IF_ADDRESS);
-    int_flag |= 0x01;
-    cpu->mmu->mmu_set_byte(cpu->mmu, IF_ADDRESS, int_flag);
-
-    // ppu_render_full_frame(ppu);
-
-    // V-Blank period: scanlines 144-153 (10 scanlines in MODE 1)
-    // https://hacktix.github.io/GBEDG/ppu/
-    // V-Blank mode is the same as H-Blank in the way that the PPU does not draw any pixels to the
-    // LCD during its duration. However, instead of it taking place at the end of every scanline,
-    // it's a much longer period at the end of every frame. As the Gameboy has a vertical resolution
-    // of 144 pixels, it would be expected that the amount of scanlines the PPU handles would be
-    // equal - 144 scanlines. However, this is not the case. In reality there are 154 scanlines, the
-    // 10 last of which being "pseudo-scanlines" during which no pixels are drawn as the PPU is in
-    // the V-Blank state during their duration. A V-Blank scanline takes the same amount of time as
-    // any other scanline - 456 T-Cycles.
-
-    for (uint8_t ly = 144; ly < 154; ly++) {
-        // MODE 1: V-Blank (456 cycles per scanline)
-        ppu_set_ly(ppu, ly);
-        ppu_set_mode(ppu, MODE_VBLANK);
-        cpu_step_for_cycles(cpu, 456);
+    // Run the CPU from deadline to deadline, the PPU flags the end of the frame from its event
+    ppu->frame_ready = false;
+    while (!ppu->frame_ready) {
+        cpu_run_until_next_event(cpu);
+        scheduler_dispatch(cpu->scheduler);
     }
 }
 
@@ -423,19 +485,9 @@ void initialize_ram(struct Ram* ram)
 {
     // initializing ram
     DMG_DEBUG_PRINT("Initializing ram registers...%s", "\n");
-    ram->set_ram_byte(ram, 0xFF05, 0x00);
-    ram->set_ram_byte(ram, 0xFF06, 0x00);
-    ram->set_ram_byte(ram, 0xFF07, 0x00);
+    // Timer registers (0xFF04-0xFF07) are owned by the timer and start out at 0
     // APU registers are now handled by the APU component
     // These will be initialized through the MMU which routes to APU
-    ram->set_ram_byte(ram, 0xFF40, 0x91);
-    ram->set_ram_byte(ram, 0xFF42, 0x00);
-    ram->set_ram_byte(ram, 0xFF43, 0x00);
-    ram->set_ram_byte(ram, 0xFF45, 0x00);
-    ram->set_ram_byte(ram, 0xFF47, 0xFC);
-    ram->set_ram_byte(ram, 0xFF48, 0xFF);
-    ram->set_ram_byte(ram, 0xFF49, 0xFF);
-    ram->set_ram_byte(ram, 0xFF4A, 0x00);
-    ram->set_ram_byte(ram, 0xFF4B, 0x00);
+    // LCD registers (0xFF40-0xFF4B) are owned by the PPU, which starts out in the post boot state
     ram->set_ram_byte(ram, 0xFFFF, 0x00);
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "form.h"
 #include "mmu.h"
 #include "ppu.h"
+#include "render_pool.h"
+#include "render_worker.h"
+#include "scheduler.h"
 #include "timer.h"
 
 extern struct EmulatorConfig config;
@@ -62,7 +65,7 @@ extern struct EmulatorConfig config;
 
 void initialize_ram(struct Ram* ram);
 // New: we now generate (ensure we have a new frame) each frame in a separate function
-void next_frame(struct PPU* ppu, struct CPU* cpu, int current_frame);
+void next_frame(struct PPU* ppu, struct CPU* cpu);
 // Main loop
 void main_loop(struct PPU* ppu, struct CPU* cpu, struct Timer* timer, struct Form* form, struct APU* apu);
 
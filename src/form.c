@@ -27,6 +27,41 @@ typedef struct
 } BMPInfoHeader;
 #pragma pack(pop)
 
+// Set up a renderer with a streaming texture the size of the screen, false if SDL can't
+static bool form_create_renderer(struct Form* form)
+{
+    FORM_DEBUG_PRINT("Creating renderer...%s", "\n");
+    form->renderer = SDL_CreateRenderer(form->window, NULL);
+    if (form->renderer == NULL) {
+        FORM_WARN_PRINT("Failed to create renderer, using the window surface: %s\n",
+                        SDL_GetError());
+        return false;
+    }
+    if (config.vsync && !SDL_SetRenderVSync(form->renderer, 1)) {
+        FORM_WARN_PRINT("Failed to enable vsync: %s\n", SDL_GetError());
+    }
+    // keep the 160x144 aspect, whole multiples only with --integer-scale
+    int presentation = config.integer_scale ? SDL_LOGICAL_PRESENTATION_INTEGER_SCALE
+                                            : SDL_LOGICAL_PRESENTATION_LETTERBOX;
+    if (!SDL_SetRenderLogicalPresentation(
+            form->renderer, SCREEN_WIDTH, SCREEN_HEIGHT, presentation)) {
+        FORM_WARN_PRINT("Failed to set logical presentation: %s\n", SDL_GetError());
+    }
+
+    form->texture = SDL_CreateTexture(form->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                      SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (form->texture == NULL) {
+        FORM_WARN_PRINT("Failed to create texture, using the window surface: %s\n",
+                        SDL_GetError());
+        SDL_DestroyRenderer(form->renderer);
+        form->renderer = NULL;
+        return false;
+    }
+    // sharp pixels instead of a blurred frame
+    SDL_SetTextureScaleMode(form->texture, SDL_SCALEMODE_NEAREST);
+    return true;
+}
+
 struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
 {
     struct Form* form = (struct Form*)malloc(sizeof(struct Form));
@@ -77,9 +112,35 @@ struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
         physical_device_res_height,
         physical_device_refresh_rate);
 
-    // store window surface
-    FORM_DEBUG_PRINT("Creating window surface...%s", "\n")
-    form->surface = SDL_GetWindowSurface(form->window);
+    // present through a renderer unless asked not to, the window surface is the fallback
+    form->renderer = NULL;
+    form->texture  = NULL;
+    form->surface  = NULL;
+    form->upscaler = NULL;
+    if (!config.surface_output && form_create_renderer(form)) {
+        form->update_surface = update_texture;
+    }
+    else {
+        // store window surface
+        FORM_DEBUG_PRINT("Creating window surface...%s", "\n")
+        form->surface        = SDL_GetWindowSurface(form->window);
+        form->update_surface = update_surface;
+        if (form->surface == NULL) {
+            FORM_EMERGENCY_PRINT("Failed to get window surface: %s\n", SDL_GetError());
+            SDL_DestroyWindow(form->window);
+            free(form);
+            return NULL;
+        }
+        form->upscaler = create_upscaler((enum UpscaleFilter)config.scale_filter);
+        if (form->upscaler == NULL) {
+            FORM_EMERGENCY_PRINT("Failed to allocate upscaler for filter %d\n",
+                                 config.scale_filter);
+            SDL_DestroyWindow(form->window);
+            free(form);
+            return NULL;
+        }
+    }
+    form->get_joypad_state = get_joypad_state;
 
     // allocate framebuffer
     FORM_DEBUG_PRINT("Attaching framebuffer...%s", "\n");
@@ -90,9 +151,17 @@ struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
         return NULL;
     }
 
+    // allocate the ARGB frame the PPU draws into
+    form->pixels = (uint32_t*)malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint32_t));
+    if (form->pixels == NULL) {
+        free(form);
+        return NULL;
+    }
+
     // allocate event
     form->event = (SDL_Event*)malloc(sizeof(SDL_Event));
     if (form->event == NULL) {
+        free(form->pixels);
         free(form);
         return NULL;
     }
@@ -102,6 +171,7 @@ struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
     form->ppu    = ppu;
     ppu->form    = form;
     form->joypad = joypad;
+    ppu_set_output(ppu, form->pixels, SCREEN_WIDTH * sizeof(uint32_t), PPU_OUTPUT_ARGB8888);
     // no need to set joypad->form because it shouldn't be used
 
     return form;
@@ -109,6 +179,15 @@ struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
 
 void free_form(struct Form* form)
 {
+    // the PPU is gone by now, nothing draws into the frame anymore
+    free(form->pixels);
+    free_upscaler(form->upscaler);
+    if (form->texture) {
+        SDL_DestroyTexture(form->texture);
+    }
+    if (form->renderer) {
+        SDL_DestroyRenderer(form->renderer);
+    }
     // free window
     SDL_DestroyWindow(form->window);
     // free form
@@ -208,55 +287,16 @@ void dump_framebuffer_to_bmp(struct Form* form, const char* filename)
 
 void update_surface(struct Form* form)
 {
-    uint32_t* pixels = form->surface->pixels;
-
-    // Convert GameBoy colors to RGBA with scaling
-    for (int y = 0; y < 144; y++) {
-        for (int x = 0; x < 160; x++) {
-            uint8_t  color = form->framebuffer[y * 160 + x];
-            uint32_t rgb_color;
-
-            // ARGB format
-            switch (color) {
-            case 0:
-                rgb_color = 0xFFE8FCCC;   // RGB(232,252,204) - Game Boy lightest shade (BGRA)
-                // rgb_color = 0xFFFFFFFF;
-                break;
-            case 1:
-                rgb_color = 0xFFACD490;   // RGB(172,212,144) - Game Boy light shade (BGRA)
-                // rgb_color = 0xFFAAAAAA;
-                break;
-            case 2:
-                rgb_color = 0xFF548C70;   // RGB(84,140,112) - Game Boy dark shade (ARGB)
-                // rgb_color = 0xFF444444;
-                break;
-            case 3:
-                rgb_color = 0xFF142C38;   // RGB(20,44,56) - Game Boy darkest shade (ARGB)
-                // rgb_color = 0xFF000000;
-                break;
-            default:
-            {
-                static int unexpected_color_count = 0;
-                unexpected_color_count++;
-                if (unexpected_color_count <= 10) {
-                    printf("DEBUG: Unexpected color value: %d at position [%d,%d]\n", color, x, y);
-                }
-            }
-                rgb_color = 0xFF0000FF;   // Blue for debugging unexpected values
-                break;
-            }
-
-            // Scale the pixel for the 2x window size
-            for (int dy = 0; dy < config.scale_factor; dy++) {
-                for (int dx = 0; dx < config.scale_factor; dx++) {
-                    int pixel_x = x * config.scale_factor + dx;
-                    int pixel_y = y * config.scale_factor + dy;
-                    if (pixel_x < form->surface->w && pixel_y < form->surface->h) {
-                        pixels[pixel_y * (form->surface->pitch / 4) + pixel_x] = rgb_color;
-                    }
-                }
-            }
-        }
+    // The PPU already wrote the frame in ARGB, only scaling is left.
+    // Use the largest scale up to scale_factor that fits the surface
+    int scale = config.scale_factor;
+    while (scale > 1 && (SCREEN_WIDTH * scale > form->surface->w ||
+                         SCREEN_HEIGHT * scale > form->surface->h)) {
+        scale--;
+    }
+    if (SCREEN_WIDTH * scale <= form->surface->w && SCREEN_HEIGHT * scale <= form->surface->h) {
+        upscaler_scale(form->upscaler, form->surface->pixels, form->surface->pitch / 4,
+                       form->pixels, SCREEN_WIDTH, SCREEN_WIDTH, SCREEN_HEIGHT, scale);
     }
 
     // Dump framebuffer to BMP file (uncomment to enable)
@@ -265,6 +305,15 @@ void update_surface(struct Form* form)
     SDL_UpdateWindowSurface(form->window);
 }
 
+void update_texture(struct Form* form)
+{
+    // one upload of the 160x144 frame, scaling happens in the renderer
+    SDL_UpdateTexture(form->texture, NULL, form->pixels, SCREEN_WIDTH * sizeof(uint32_t));
+    SDL_RenderClear(form->renderer);
+    SDL_RenderTexture(form->renderer, form->texture, NULL, NULL);
+    SDL_RenderPresent(form->renderer);
+}
+
 void set_framebuffer(struct Form* form)
 {
     form->framebuffer = form->ppu->framebuffer;
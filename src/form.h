@@ -4,6 +4,7 @@
 #include "general.h"
 #include "joypad.h"
 #include "ppu.h"
+#include "upscaler.h"
 #include <SDL3/SDL.h>
 
 extern struct EmulatorConfig config;
@@ -62,11 +63,17 @@ struct Form
 {
     SDL_Window*   window;
     SDL_Renderer* renderer;
-    SDL_Surface*  surface;
+    SDL_Surface*  surface;    // surface path only
+    SDL_Texture*  texture;    // renderer path only, the 160x144 frame scaled by SDL
+
+    // surface path only, scales the frame into the window surface
+    struct Upscaler* upscaler;
     SDL_Event*    event;
 
     // framebuffer
     uint8_t* framebuffer;
+    // final colors of the frame, written by the PPU as it draws
+    uint32_t* pixels;
 
     // PPU
     struct PPU* ppu;
@@ -89,9 +96,15 @@ struct Form* create_form(struct PPU* ppu, struct Joypad* joypad, char* rom_name)
 // Free form
 void free_form(struct Form* form);
 
-// Update surface
+// Update surface: scale the frame into the window surface on the CPU (fallback path)
 void update_surface(struct Form* form);
 
+// Update texture: upload the frame once and let the renderer scale it
+void update_texture(struct Form* form);
+
+// Point the form at the PPU's current front framebuffer
+void set_framebuffer(struct Form* form);
+
 // Get Joypad state
 bool get_joypad_state(struct Form* form);
 
@@ -35,6 +35,14 @@ struct EmulatorConfig
     bool                    enable_serial_print;
     bool                    print_debug_info_this_frame;
     bool                    fast_forward_mode;
+    bool                    deferred_rendering;
+    bool                    render_thread;
+    int                     render_threads;
+    bool                    surface_output;
+    int                     scale_filter;   // enum UpscaleFilter
+    bool                    integer_scale;
+    bool                    vsync;
+    int                     save_interval;   // ms between battery save flushes, 0: only at exit
     bool                    disable_joypad;
 };
 
@@ -132,6 +140,10 @@ extern struct EmulatorConfig config;
 #define TIMER_TMA_ADDRESS  0xFF06  // Timer Modulo (R/W) - Value loaded into TIMA when it overflows
 #define TIMER_TAC_ADDRESS  0xFF07  // Timer Control (R/W) - Bit 2: Enable, Bits 1-0: Clock select (00=4096Hz, 01=262144Hz, 10=65536Hz, 11=16384Hz)
 
+// Serial Registers
+#define SERIAL_SB_ADDRESS 0xFF01  // Serial Transfer Data (R/W) - Byte shifted out, replaced by the byte shifted in
+#define SERIAL_SC_ADDRESS 0xFF02  // Serial Transfer Control (R/W) - Bit 7: Transfer start/busy, Bit 0: Clock (1=Internal)
+
 
 // Regular Colors
 #define ANSI_COLOR_BLACK   "\x1b[30m"
@@ -56,9 +56,7 @@ void handle_joypad_input(struct Joypad* joypad)
                           column_selection, joypad->keys_directions, joypad->keys_controls);
         
         // Set bit 4 in the interrupt flag register (IF) for joypad interrupt
-        uint8_t current_interrupt = joypad->mmu->mmu_get_byte(joypad->mmu, IF_ADDRESS);
-        current_interrupt |= 0x10;
-        joypad->mmu->mmu_set_byte(joypad->mmu, IF_ADDRESS, current_interrupt);
+        mmu_request_interrupt(joypad->mmu, INT_JOYPAD);
     }
     // uint8_t column_requested = joypad->mmu->mmu_get_byte(joypad->mmu, JOYPAD_ADDRESS) & 0x30;
     // uint8_t temp_ff00 = 0x00;
@@ -0,0 +1,48 @@
+#ifndef GAMEBOY_MAPPER_H
+#define GAMEBOY_MAPPER_H
+
+#include "general.h"
+
+struct Cartridge;
+
+// Memory bank controller behaviour, one handler table per MBC family.
+// check_cartridge_type binds the table once, so reads and writes never test the controller type.
+struct Mapper
+{
+    const char* name;
+
+    // 0x0000-0x7FFF
+    uint8_t (*read_rom)(struct Cartridge* cartridge, uint16_t address);
+    // 0xA000-0xBFFF
+    uint8_t (*read_ram)(struct Cartridge* cartridge, uint16_t address);
+    // 0x0000-0x7FFF, MBC control registers; the bank pointers are recomputed afterwards
+    void (*write_ctrl)(struct Cartridge* cartridge, uint16_t address, uint8_t byte);
+    // 0xA000-0xBFFF
+    void (*write_ram)(struct Cartridge* cartridge, uint16_t address, uint8_t byte);
+
+    // write the cartridge RAM to / read it back from a save file, false on a short read or write
+    bool (*save)(struct Cartridge* cartridge, FILE* file);
+    bool (*load)(struct Cartridge* cartridge, FILE* file);
+};
+
+extern const struct Mapper mapper_rom_only;
+extern const struct Mapper mapper_mbc1;
+extern const struct Mapper mapper_mbc2;
+extern const struct Mapper mapper_mbc3;
+extern const struct Mapper mapper_mbc5;
+extern const struct Mapper mapper_mbc5_rumble;
+
+// Handlers shared by the mappers, see cartridge.c
+
+// ROM through rom_bank_0/rom_bank_1
+uint8_t mapper_read_rom(struct Cartridge* cartridge, uint16_t address);
+// external RAM through the ram bank pointer, 0xFF while disabled
+uint8_t mapper_read_ram(struct Cartridge* cartridge, uint16_t address);
+void    mapper_write_ram(struct Cartridge* cartridge, uint16_t address, uint8_t byte);
+// 0x0000-0x1FFF RAM enable register of MBC1/MBC3/MBC5
+void mapper_write_ram_enable(struct Cartridge* cartridge, uint8_t byte);
+// ram_data as is
+bool mapper_save_ram(struct Cartridge* cartridge, FILE* file);
+bool mapper_load_ram(struct Cartridge* cartridge, FILE* file);
+
+#endif
@@ -0,0 +1,50 @@
+#include "cartridge.h"
+
+// MBC1: up to 2MB ROM, up to 32KB RAM
+
+static void mbc1_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (address <= 0x1FFF) {
+        // RAM Enable (0x0A enables, anything else disables)
+        mapper_write_ram_enable(cartridge, byte);
+    }
+    else if (address <= 0x3FFF) {
+        // ROM Bank Number (lower 5 bits)
+        uint8_t bank = byte & 0x1F;
+
+        // MBC1 quirk: Bank 0 cannot be selected, defaults to bank 1
+        if (bank == 0) {
+            bank = 1;
+        }
+
+        // Bounds check
+        if (bank >= cartridge->rom_attributes_bank_count) {
+            bank = bank % cartridge->rom_attributes_bank_count;
+            if (bank == 0) bank = 1; // Ensure we don't wrap to bank 0
+        }
+
+        cartridge->rom_alternative_bank = bank;
+        CARTRIDGE_DEBUG_PRINT("MBC1: ROM Bank set to %d\n", bank);
+    }
+    else if (address <= 0x5FFF) {
+        // RAM Bank Number OR Upper ROM Bank bits
+        uint8_t bank = byte & 0x03;
+        cartridge->ram_alternative_bank = bank;
+        CARTRIDGE_DEBUG_PRINT("MBC1: RAM Bank set to %d\n", bank);
+    }
+    else {
+        // Banking Mode Select (0 = ROM mode, 1 = RAM mode)
+        CARTRIDGE_DEBUG_PRINT("MBC1: Banking mode: %s\n",
+                              (byte & 0x01) ? "RAM mode" : "ROM mode");
+    }
+}
+
+const struct Mapper mapper_mbc1 = {
+    .name       = "MBC1",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mapper_read_ram,
+    .write_ctrl = mbc1_write_ctrl,
+    .write_ram  = mapper_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
@@ -0,0 +1,69 @@
+#include "cartridge.h"
+
+// MBC2: up to 256KB ROM and 512 x 4 bits of built in RAM
+
+static void mbc2_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (address > 0x3FFF) {
+        return;
+    }
+    // Check the least significant bit of the upper address byte
+    if ((address & 0x0100) == 0x0000) {
+        // RAM Enable/Disable (bit 8 = 0)
+        if ((byte & 0x0F) == 0x0A) {
+            cartridge->mbc2_ram_enabled = true;
+            CARTRIDGE_DEBUG_PRINT("MBC2: RAM Enabled\n");
+        }
+        else {
+            cartridge->mbc2_ram_enabled = false;
+            CARTRIDGE_DEBUG_PRINT("MBC2: RAM Disabled\n");
+        }
+    }
+    else {
+        // ROM Bank Selection (bit 8 = 1)
+        uint8_t bank = byte & 0x0F; // Only 4 bits for MBC2
+
+        // MBC2 quirk: Bank 0 cannot be selected, defaults to bank 1
+        if (bank == 0) {
+            bank = 1;
+        }
+
+        // MBC2 supports up to 16 banks (2Mbit)
+        if (bank >= cartridge->rom_attributes_bank_count) {
+            bank = bank % cartridge->rom_attributes_bank_count;
+            if (bank == 0) bank = 1;
+        }
+
+        cartridge->rom_alternative_bank = bank;
+        CARTRIDGE_DEBUG_PRINT("MBC2: ROM Bank set to %d\n", bank);
+    }
+}
+
+static uint8_t mbc2_read_ram(struct Cartridge* cartridge, uint16_t address)
+{
+    if (!cartridge->mbc2_ram_enabled) {
+        return 0xFF;
+    }
+    // 512 nibbles at 0xA000-0xA1FF, mirrored up to 0xBFFF; upper 4 bits always set
+    return cartridge->ram_data[address & 0x01FF] | 0xF0;
+}
+
+static void mbc2_write_ram(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (!cartridge->mbc2_ram_enabled) {
+        return;
+    }
+    // Only the lower 4 bits are stored
+    cartridge->ram_data[address & 0x01FF] = byte & 0x0F;
+    CARTRIDGE_TRACE_PRINT("MBC2: RAM write to 0x%04x = 0x%02x\n", address & 0x01FF, byte & 0x0F);
+}
+
+const struct Mapper mapper_mbc2 = {
+    .name       = "MBC2",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mbc2_read_ram,
+    .write_ctrl = mbc2_write_ctrl,
+    .write_ram  = mbc2_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
@@ -0,0 +1,54 @@
+#include "cartridge.h"
+
+// MBC3: up to 2MB ROM, up to 32KB RAM and a real time clock (not implemented yet)
+
+static void mbc3_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (address <= 0x1FFF) {
+        // RAM Enable (0x0A enables, anything else disables)
+        mapper_write_ram_enable(cartridge, byte);
+    }
+    else if (address <= 0x3FFF) {
+        // ROM Bank Number (7 bits)
+        uint8_t bank = byte & 0x7F;
+
+        // MBC3 quirk: Bank 0 cannot be selected, defaults to bank 1
+        if (bank == 0) {
+            bank = 1;
+        }
+
+        // Bounds check
+        if (bank >= cartridge->rom_attributes_bank_count) {
+            bank = bank % cartridge->rom_attributes_bank_count;
+            if (bank == 0) bank = 1;
+        }
+
+        cartridge->rom_alternative_bank = bank;
+        CARTRIDGE_DEBUG_PRINT("MBC3: ROM Bank set to %d\n", bank);
+    }
+    else if (address <= 0x5FFF) {
+        // RAM Bank Number (0x00-0x03) or RTC Register Select (0x08-0x0C)
+        if (byte <= 0x03) {
+            cartridge->ram_alternative_bank = byte;
+            CARTRIDGE_DEBUG_PRINT("MBC3: RAM Bank set to %d\n", byte);
+        }
+        else if (byte >= 0x08 && byte <= 0x0C) {
+            // RTC register selection - not implemented yet
+            CARTRIDGE_DEBUG_PRINT("MBC3: RTC register 0x%02x selected (not implemented)\n", byte);
+        }
+    }
+    else {
+        // Latch Clock Data - not implemented yet
+        CARTRIDGE_DEBUG_PRINT("MBC3: Clock latch command (not implemented)\n");
+    }
+}
+
+const struct Mapper mapper_mbc3 = {
+    .name       = "MBC3",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mapper_read_ram,
+    .write_ctrl = mbc3_write_ctrl,
+    .write_ram  = mapper_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
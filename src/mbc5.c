@@ -0,0 +1,74 @@
+#include "cartridge.h"
+
+// MBC5: up to 8MB ROM with a 9 bit bank number, up to 128KB RAM, optional rumble motor
+
+// 0x0000-0x3FFF: RAM enable and the 9 bit ROM bank, the same on every MBC5
+static void mbc5_write_enable_and_rom_bank(struct Cartridge* cartridge, uint16_t address,
+                                           uint8_t byte)
+{
+    if (address <= 0x1FFF) {
+        // RAM Enable (0x0A enables, anything else disables)
+        mapper_write_ram_enable(cartridge, byte);
+    }
+    else if (address <= 0x2FFF) {
+        // ROM Bank Number (lower 8 bits), bank 0 is selectable
+        cartridge->rom_alternative_bank = (cartridge->rom_alternative_bank & 0x0100) | byte;
+        CARTRIDGE_DEBUG_PRINT("MBC5: ROM Bank set to %d\n", cartridge->rom_alternative_bank);
+    }
+    else {
+        // ROM Bank Number (upper bit)
+        cartridge->rom_alternative_bank =
+            (cartridge->rom_alternative_bank & 0x00FF) | ((byte & 0x01) << 8);
+        CARTRIDGE_DEBUG_PRINT("MBC5: ROM Bank set to %d\n", cartridge->rom_alternative_bank);
+    }
+}
+
+static void mbc5_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (address <= 0x3FFF) {
+        mbc5_write_enable_and_rom_bank(cartridge, address, byte);
+    }
+    else if (address <= 0x5FFF) {
+        // RAM Bank Number (4 bits)
+        cartridge->ram_alternative_bank = byte & 0x0F;
+        CARTRIDGE_DEBUG_PRINT("MBC5: RAM Bank set to %d\n", cartridge->ram_alternative_bank);
+    }
+}
+
+// Rumble carts wire bit 3 of the RAM bank register to the motor
+static void mbc5_rumble_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    if (address <= 0x3FFF) {
+        mbc5_write_enable_and_rom_bank(cartridge, address, byte);
+    }
+    else if (address <= 0x5FFF) {
+        // Rumble motor control (bit 3) and RAM bank (bits 0-2)
+        bool motor_on = (byte & 0x08) != 0;
+        if (motor_on != cartridge->rumble_motor_on) {
+            cartridge->rumble_motor_on = motor_on;
+            CARTRIDGE_WARN_PRINT("MBC5: Rumble motor %s\n", motor_on ? "ON" : "OFF");
+        }
+        cartridge->ram_alternative_bank = byte & 0x07;
+        CARTRIDGE_DEBUG_PRINT("MBC5: RAM Bank set to %d\n", cartridge->ram_alternative_bank);
+    }
+}
+
+const struct Mapper mapper_mbc5 = {
+    .name       = "MBC5",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mapper_read_ram,
+    .write_ctrl = mbc5_write_ctrl,
+    .write_ram  = mapper_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
+
+const struct Mapper mapper_mbc5_rumble = {
+    .name       = "MBC5+RUMBLE",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mapper_read_ram,
+    .write_ctrl = mbc5_rumble_write_ctrl,
+    .write_ram  = mapper_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
@@ -1,4 +1,138 @@
 #include "mmu.h"
+#include "render_worker.h"
+
+// I/O register handlers
+
+uint8_t mmu_io_read_memory(struct MMU* mmu, uint16_t address)
+{
+    return mmu->ram->ram_byte[address];
+}
+
+void mmu_io_write_memory(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    mmu->ram->ram_byte[address] = byte;
+}
+
+// Recompute the cached IE & IF mask after either register changed
+static inline void mmu_update_interrupt_pending(struct MMU* mmu)
+{
+    mmu->interrupt_pending =
+        mmu->ram->ram_byte[IF_ADDRESS] & mmu->ram->ram_byte[IE_ADDRESS] & 0x1F;
+}
+
+// IF: only the lower 5 bits exist, the rest read back as 1
+static uint8_t mmu_io_read_interrupt_flag(struct MMU* mmu, uint16_t address)
+{
+    return mmu->ram->ram_byte[address] | 0xE0;
+}
+
+static void mmu_io_write_interrupt_flag(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    mmu->ram->ram_byte[address] = byte & 0x1F;
+    mmu_update_interrupt_pending(mmu);
+}
+
+// IE: all 8 bits are stored, only the lower 5 take part in dispatch
+static void mmu_io_write_interrupt_enable(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    mmu->ram->ram_byte[address] = byte;
+    mmu_update_interrupt_pending(mmu);
+}
+
+void mmu_request_interrupt(struct MMU* mmu, uint8_t interrupt)
+{
+    mmu->ram->ram_byte[IF_ADDRESS] |= interrupt;
+    mmu_update_interrupt_pending(mmu);
+}
+
+void mmu_acknowledge_interrupt(struct MMU* mmu, uint8_t interrupt)
+{
+    mmu->ram->ram_byte[IF_ADDRESS] &= ~interrupt;
+    mmu_update_interrupt_pending(mmu);
+}
+
+static uint8_t mmu_io_read_joypad(struct MMU* mmu, uint16_t address)
+{
+    // effectivly disable joypad
+    if (config.disable_joypad) {
+        return 0x3F;
+    }
+    return mmu->ram->ram_byte[address];
+}
+
+static void mmu_io_write_joypad(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    // controls
+    bool controls_requested   = ((byte >> 5) & 1) == 0;
+    bool directions_requested = ((byte >> 4) & 1) == 0;
+    if (controls_requested) {
+        byte = 0x20 + mmu->joypad->keys_controls;
+    }
+    if (directions_requested) {
+        byte = 0x10 + mmu->joypad->keys_directions;
+    }
+    mmu->ram->ram_byte[address] = byte;
+}
+
+static uint8_t mmu_io_read_apu(struct MMU* mmu, uint16_t address)
+{
+    return mmu->apu->read_register(mmu->apu, address);
+}
+
+static void mmu_io_write_apu(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    mmu->apu->write_register(mmu->apu, address, byte);
+}
+
+static uint8_t mmu_io_read_serial(struct MMU* mmu, uint16_t address)
+{
+    return serial_read_register(mmu->serial, address);
+}
+
+static void mmu_io_write_serial(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    serial_write_register(mmu->serial, address, byte);
+}
+
+static uint8_t mmu_io_read_timer(struct MMU* mmu, uint16_t address)
+{
+    return mmu->timer->read_register(mmu->timer, address);
+}
+
+static void mmu_io_write_timer(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    mmu->timer->write_register(mmu->timer, address, byte);
+}
+
+static uint8_t mmu_io_read_ppu(struct MMU* mmu, uint16_t address)
+{
+    return ppu_read_register(mmu->ppu, address);
+}
+
+static void mmu_io_write_ppu(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    ppu_write_register(mmu->ppu, address, byte);
+}
+
+static void mmu_io_write_dma(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    (void)address;
+    if (mmu->scheduler == NULL) {
+        DMA(mmu, byte);
+        return;
+    }
+    mmu->dma_source = byte;
+    scheduler_schedule_in(mmu->scheduler, EVENT_DMA, DMA_CYCLES);
+}
+
+void mmu_register_io_handler(
+    struct MMU* mmu, uint16_t address, uint8_t (*read)(struct MMU*, uint16_t),
+    void (*write)(struct MMU*, uint16_t, uint8_t))
+{
+    uint8_t index                = address & 0xFF;
+    mmu->io_read_handler[index]  = read ? read : mmu_io_read_memory;
+    mmu->io_write_handler[index] = write ? write : mmu_io_write_memory;
+}
 
 struct MMU* create_mmu(struct Cartridge* cartridge, struct Ram* ram, struct PPU* ppu)
 {
@@ -6,6 +140,13 @@ struct MMU* create_mmu(struct Cartridge* cartridge, struct Ram* ram, struct PPU*
     mmu->cartridge  = cartridge;
     mmu->ram        = ram;
     mmu->ppu        = ppu;
+    mmu->joypad     = NULL;
+    mmu->apu        = NULL;
+    mmu->timer      = NULL;
+    mmu->serial     = NULL;
+    mmu->scheduler  = NULL;
+    mmu->dma_source = 0;
+    mmu->interrupt_pending = 0;
     // set method pointers
     mmu->mmu_get_byte = mmu_get_byte;
     mmu->mmu_set_byte = mmu_set_byte;
@@ -13,9 +154,69 @@ struct MMU* create_mmu(struct Cartridge* cartridge, struct Ram* ram, struct PPU*
     mmu->mmu_set_word = mmu_set_word;
     mmu->mmu_attach_joypad = mmu_attach_joypad;
     mmu->mmu_attach_apu = mmu_attach_apu;
+    mmu->mmu_attach_timer = mmu_attach_timer;
+    mmu->mmu_attach_serial = mmu_attach_serial;
+    mmu->mmu_attach_ppu = mmu_attach_ppu;
+    mmu->mmu_attach_scheduler = mmu_attach_scheduler;
+    mmu->mmu_map_cartridge_pages = mmu_map_cartridge_pages;
+    // repoint cartridge pages whenever the MBC switches banks
+    cartridge->mmu            = mmu;
+    cartridge->on_bank_switch = mmu_map_cartridge_pages;
+    mmu_map_pages(mmu);
+    // I/O registers: plain memory unless a device owns them
+    for (int index = 0; index < MMU_IO_REGISTER_COUNT; index++) {
+        mmu_register_io_handler(mmu, MMU_IO_PAGE + index, NULL, NULL);
+    }
+    mmu_register_io_handler(mmu, IF_ADDRESS, mmu_io_read_interrupt_flag, mmu_io_write_interrupt_flag);
+    mmu_register_io_handler(mmu, IE_ADDRESS, NULL, mmu_io_write_interrupt_enable);
+    mmu_update_interrupt_pending(mmu);
+    mmu_register_io_handler(mmu, DMA_ADDRESS, NULL, mmu_io_write_dma);
     return mmu;
 }
 
+void mmu_map_cartridge_pages(struct MMU* mmu)
+{
+    // 0x0000 - 0x7FFF: ROM, writes are MBC control
+    for (int page = 0x00; page <= 0x7F; page++) {
+        mmu->read_page_table[page] =
+            mmu->cartridge->get_cartridge_page(mmu->cartridge, page << MMU_PAGE_SHIFT);
+        mmu->write_page_table[page] = NULL;
+    }
+    // 0xA000 - 0xBFFF: external RAM, mapped only while enabled
+    for (int page = 0xA0; page <= 0xBF; page++) {
+        uint8_t* host = mmu->cartridge->get_cartridge_page(mmu->cartridge, page << MMU_PAGE_SHIFT);
+        mmu->read_page_table[page]  = host;
+        mmu->write_page_table[page] = host;
+    }
+}
+
+void mmu_map_pages(struct MMU* mmu)
+{
+    for (int page = 0; page < MMU_PAGE_COUNT; page++) {
+        mmu->read_page_table[page]  = NULL;
+        mmu->write_page_table[page] = NULL;
+    }
+    mmu_map_cartridge_pages(mmu);
+    // 0x8000 - 0x9FFF: VRAM
+    // writes go through vram_set_byte so the decoded tile cache sees them
+    for (int page = 0x80; page <= 0x9F; page++) {
+        mmu->read_page_table[page] = mmu->ppu->vram->vram_byte + ((page - 0x80) << MMU_PAGE_SHIFT);
+    }
+    // 0xC000 - 0xDFFF: WRAM
+    for (int page = 0xC0; page <= 0xDF; page++) {
+        uint8_t* host = mmu->ram->ram_byte + (page << MMU_PAGE_SHIFT);
+        mmu->read_page_table[page]  = host;
+        mmu->write_page_table[page] = host;
+    }
+    // 0xE000 - 0xFDFF: echo RAM, mirrors WRAM
+    for (int page = 0xE0; page <= 0xFD; page++) {
+        uint8_t* host = mmu->ram->ram_byte + ((page - 0x20) << MMU_PAGE_SHIFT);
+        mmu->read_page_table[page]  = host;
+        mmu->write_page_table[page] = host;
+    }
+    // 0xFE00 - 0xFFFF: OAM/unusable and I/O/HRAM/IE stay on the handlers
+}
+
 void free_mmu(struct MMU* mmu)
 {
     if (mmu) {
@@ -53,11 +254,11 @@ struct AddressTranslationResult translate_address(uint16_t address)
         result.address = address;
         result.type    = CARTRIDGE;
     }
-    // // External RAM: from cartridge
-    // else if (address >= 0xA000 && address <= 0xBFFF) {
-    //     result.address = address;
-    //     result.type    = CARTRIDGE;
-    // }
+    // External RAM: from cartridge
+    else if (address >= 0xA000 && address <= 0xBFFF) {
+        result.address = address;
+        result.type    = CARTRIDGE;
+    }
     // Video RAM: from ppu
     else if (address >= 0x8000 && address <= 0x9FFF) {
         result.address = address;
@@ -84,17 +285,17 @@ struct AddressTranslationResult translate_address(uint16_t address)
 
 uint8_t mmu_get_byte(struct MMU* mmu, uint16_t address)
 {
-    // effectivly disable joypad
-    if (address == 0xFF00 && config.disable_joypad) {
-        return 0x3F;
+    // fast path: plain memory page
+    uint8_t* page = mmu->read_page_table[address >> MMU_PAGE_SHIFT];
+    if (page) {
+        return page[address & MMU_PAGE_MASK];
     }
-    
-    // Handle APU registers (0xFF10-0xFF26, 0xFF30-0xFF3F)
-    if (mmu->apu && ((address >= 0xFF10 && address <= 0xFF26) || 
-                     (address >= 0xFF30 && address <= 0xFF3F))) {
-        return mmu->apu->read_register(mmu->apu, address);
+
+    // I/O registers, HRAM and IE
+    if (address >= MMU_IO_PAGE) {
+        return mmu->io_read_handler[address & 0xFF](mmu, address);
     }
-    
+
     // Handle unusable memory region
     if (address >= 0xFEA0 && address <= 0xFEFF) {
         return 0x00; // Reads from this region should return 0x00 on DMG
@@ -113,41 +314,69 @@ uint8_t mmu_get_byte(struct MMU* mmu, uint16_t address)
 void mmu_attach_joypad(struct MMU* mmu, struct Joypad* joypad)
 {
     mmu->joypad = joypad;
+    mmu_register_io_handler(mmu, JOYPAD_ADDRESS, mmu_io_read_joypad, mmu_io_write_joypad);
 }
 
 void mmu_attach_apu(struct MMU* mmu, struct APU* apu)
 {
     mmu->apu = apu;
+    // APU registers (0xFF10-0xFF26, 0xFF30-0xFF3F)
+    for (uint16_t address = 0xFF10; address <= 0xFF3F; address++) {
+        if (address > 0xFF26 && address < 0xFF30) {
+            continue;
+        }
+        mmu_register_io_handler(mmu, address, mmu_io_read_apu, mmu_io_write_apu);
+    }
 }
 
-void mmu_set_byte(struct MMU* mmu, uint16_t address, uint8_t byte)
+void mmu_attach_timer(struct MMU* mmu, struct Timer* timer)
 {
-    // // Block writes to LY register - it's read-only for CPU
-    // if (address == 0xFF44) { // LY_ADDRESS
-    //     return; // LY register is read-only, managed by PPU
-    // }
-    
-    // Handle APU registers (0xFF10-0xFF26, 0xFF30-0xFF3F)
-    if (mmu->apu && ((address >= 0xFF10 && address <= 0xFF26) || 
-                     (address >= 0xFF30 && address <= 0xFF3F))) {
-        mmu->apu->write_register(mmu->apu, address, byte);
-        return;
+    mmu->timer = timer;
+    timer->mmu = mmu;
+    // Timer registers (0xFF04-0xFF07)
+    for (uint16_t address = TIMER_DIV_ADDRESS; address <= TIMER_TAC_ADDRESS; address++) {
+        mmu_register_io_handler(mmu, address, mmu_io_read_timer, mmu_io_write_timer);
     }
+}
 
-    if (address == 0xFF00) {
-        // controls
-        bool controls_requested = ((byte >> 5) & 1) == 0;
-        bool directions_requested = ((byte >> 4) & 1) == 0;
-        if (controls_requested) {
-            byte = 0x20 + mmu->joypad->keys_controls;
-        }
-        if (directions_requested) {
-            byte = 0x10 + mmu->joypad->keys_directions;
+void mmu_attach_serial(struct MMU* mmu, struct Serial* serial)
+{
+    mmu->serial = serial;
+    serial->mmu = mmu;
+    mmu_register_io_handler(mmu, SERIAL_SB_ADDRESS, mmu_io_read_serial, mmu_io_write_serial);
+    mmu_register_io_handler(mmu, SERIAL_SC_ADDRESS, mmu_io_read_serial, mmu_io_write_serial);
+}
+
+void mmu_attach_ppu(struct MMU* mmu, struct PPU* ppu)
+{
+    mmu->ppu = ppu;
+    // LCD registers (0xFF40-0xFF4B), OAM DMA at 0xFF46 stays with the MMU
+    for (uint16_t address = LCDC_ADDRESS; address <= WX_ADDRESS; address++) {
+        if (address == DMA_ADDRESS) {
+            continue;
         }
+        mmu_register_io_handler(mmu, address, mmu_io_read_ppu, mmu_io_write_ppu);
     }
-    
-    if (address == 0xFF46) {
-        DMA(mmu, byte);
+}
+
+void mmu_attach_scheduler(struct MMU* mmu, struct Scheduler* scheduler)
+{
+    mmu->scheduler = scheduler;
+    scheduler_register(scheduler, EVENT_DMA, mmu_handle_dma_event, mmu);
+}
+
+void mmu_set_byte(struct MMU* mmu, uint16_t address, uint8_t byte)
+{
+    // fast path: plain memory page
+    uint8_t* page = mmu->write_page_table[address >> MMU_PAGE_SHIFT];
+    if (page) {
+        page[address & MMU_PAGE_MASK] = byte;
+        return;
+    }
+
+    // I/O registers, HRAM and IE
+    if (address >= MMU_IO_PAGE) {
+        mmu->io_write_handler[address & 0xFF](mmu, address, byte);
         return;
     }
 
@@ -156,15 +385,28 @@ void mmu_set_byte(struct MMU* mmu, uint16_t address, uint8_t byte)
         return; // Writes to this region have no effect
     }
 
+    // VRAM and OAM writes while a deferred frame is on screen go to the PPU change log
+    if (mmu->ppu->deferred_frame &&
+        ((address >= 0x8000 && address <= 0x9FFF) || address >= 0xFE00)) {
+        ppu_log_change(mmu->ppu, address, mmu_get_byte(mmu, address), byte);
+    }
+
     struct AddressTranslationResult result = translate_address(address);
     if (result.type == CARTRIDGE) {
         mmu->cartridge->set_cartridge_byte(mmu->cartridge, result.address, byte);
     }
     else if (result.type == PPU_VRAM) {
+        // the render worker may still be drawing lines from the old contents
+        if (mmu->ppu->render_worker) {
+            render_worker_sync(mmu->ppu->render_worker);
+        }
         mmu->ppu->vram->vram_set_byte(mmu->ppu->vram, result.address, byte);
     }
     else {
         mmu->ram->set_ram_byte(mmu->ram, result.address, byte);
+        if (address >= OAM_TABLE_INITIAL_ADDDRESS) {
+            ppu_update_sprite_table(mmu->ppu, address, byte);
+        }
     }
 }
 
@@ -184,13 +426,37 @@ void DMA(struct MMU* mmu, uint8_t source_bank)
     }
 }
 
+void mmu_handle_dma_event(void* context, uint64_t deadline)
+{
+    (void)deadline;
+    struct MMU* mmu = (struct MMU*)context;
+    DMA(mmu, mmu->dma_source);
+}
+
 uint16_t mmu_get_word(struct MMU* mmu, uint16_t address)
 {
+    // fast path: both bytes on the same plain memory page
+    uint8_t* page = mmu->read_page_table[address >> MMU_PAGE_SHIFT];
+    if (page && (address & MMU_PAGE_MASK) != MMU_PAGE_MASK) {
+        uint8_t offset = address & MMU_PAGE_MASK;
+        return (uint16_t)(page[offset] | (page[offset + 1] << 8));
+    }
+
     // Handle unusable memory region
     if (address >= 0xFEA0 && address <= 0xFEFF) {
         return 0x0000; // Reads from this region should return 0x00 on DMG
     }
 
+    // I/O registers go through their handlers byte by byte, so do logged VRAM/OAM writes
+    if (address >= MMU_IO_PAGE || mmu->ppu->deferred_frame) {
+        return (uint16_t)(mmu_get_byte(mmu, address) | (mmu_get_byte(mmu, address + 1) << 8));
+    }
+
+    // Cartridge RAM off the page table (page crossing, disabled, MBC2) belongs to the mapper
+    if (address >= 0xA000 && address <= 0xBFFF) {
+        return (uint16_t)(mmu_get_byte(mmu, address) | (mmu_get_byte(mmu, address + 1) << 8));
+    }
+
     struct AddressTranslationResult result = translate_address(address);
     if (result.type == CARTRIDGE) {
         return mmu->cartridge->get_cartridge_word(mmu->cartridge, result.address);
@@ -203,16 +469,43 @@ uint16_t mmu_get_word(struct MMU* mmu, uint16_t address)
 
 void mmu_set_word(struct MMU* mmu, uint16_t address, uint16_t word)
 {
+    // fast path: both bytes on the same plain memory page
+    uint8_t* page = mmu->write_page_table[address >> MMU_PAGE_SHIFT];
+    if (page && (address & MMU_PAGE_MASK) != MMU_PAGE_MASK) {
+        uint8_t offset   = address & MMU_PAGE_MASK;
+        page[offset]     = word & 0xFF;
+        page[offset + 1] = (word >> 8) & 0xFF;
+        return;
+    }
+
     // Handle unusable memory region
     if (address >= 0xFEA0 && address <= 0xFEFF) {
         return; // Writes to this region have no effect
     }
 
+    // I/O registers go through their handlers byte by byte, so do logged VRAM writes and OAM
+    // writes (a word at 0xFDFF ends in OAM), which the PPU sprite table follows
+    if (address >= OAM_TABLE_INITIAL_ADDDRESS - 1 || mmu->ppu->deferred_frame) {
+        mmu_set_byte(mmu, address, word & 0xFF);
+        mmu_set_byte(mmu, address + 1, (word >> 8) & 0xFF);
+        return;
+    }
+
+    // so are writes to it
+    if (address >= 0xA000 && address <= 0xBFFF) {
+        mmu_set_byte(mmu, address, word & 0xFF);
+        mmu_set_byte(mmu, address + 1, (word >> 8) & 0xFF);
+        return;
+    }
+
     struct AddressTranslationResult result = translate_address(address);
     if (result.type == CARTRIDGE) {
         mmu->cartridge->set_cartridge_word(mmu->cartridge, result.address, word);
     }
     else if (result.type == PPU_VRAM) {
+        if (mmu->ppu->render_worker) {
+            render_worker_sync(mmu->ppu->render_worker);
+        }
         mmu->ppu->vram->vram_set_word(mmu->ppu->vram, result.address, word);
     }
     else {
@@ -6,11 +6,25 @@
 #include "joypad.h"
 #include "ppu.h"
 #include "ram.h"
+#include "scheduler.h"
+#include "serial.h"
 #include "timer.h"
 #include "apu.h"
 
 extern struct EmulatorConfig config;
 
+// Page table: 256 pages of 256 bytes
+#define MMU_PAGE_SHIFT 8
+#define MMU_PAGE_COUNT 256
+#define MMU_PAGE_MASK  0xFF
+
+// I/O dispatch table: one entry per register in 0xFF00 - 0xFFFF
+#define MMU_IO_REGISTER_COUNT 256
+#define MMU_IO_PAGE           0xFF00
+
+// OAM DMA copies 160 bytes, one per cycle
+#define DMA_CYCLES 160
+
 // MMU debug print
 #define MMU_DEBUG_PRINT(fmt, ...)                                   \
     if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
@@ -82,6 +96,26 @@ struct MMU
     struct PPU*       ppu;
     struct Joypad*    joypad;
     struct APU*       apu;
+    struct Timer*     timer;
+    struct Serial*    serial;
+    struct Scheduler* scheduler;
+
+    // OAM DMA source page, copied when EVENT_DMA fires
+    uint8_t dma_source;
+
+    // IE & IF & 0x1F, kept up to date by the IF/IE write handlers and mmu_request_interrupt
+    // so the CPU can check for interrupts without going through the I/O dispatch
+    uint8_t interrupt_pending;
+
+    // Page table of direct host pointers, indexed by address >> MMU_PAGE_SHIFT
+    // NULL entries (I/O, MBC control, unusable, disabled RAM) fall back to the handlers
+    uint8_t* read_page_table[MMU_PAGE_COUNT];
+    uint8_t* write_page_table[MMU_PAGE_COUNT];
+
+    // I/O register handlers, indexed by address & 0xFF
+    // every register starts out as plain memory, devices install their own on attach
+    uint8_t (*io_read_handler[MMU_IO_REGISTER_COUNT])(struct MMU*, uint16_t address);
+    void (*io_write_handler[MMU_IO_REGISTER_COUNT])(struct MMU*, uint16_t address, uint8_t byte);
 
     // Public method pointers
     uint8_t (*mmu_get_byte)(struct MMU*, uint16_t address);
@@ -90,6 +124,11 @@ struct MMU
     void (*mmu_set_word)(struct MMU*, uint16_t address, uint16_t word);
     void (*mmu_attach_joypad)(struct MMU* mmu, struct Joypad* joypad);
     void (*mmu_attach_apu)(struct MMU* mmu, struct APU* apu);
+    void (*mmu_attach_timer)(struct MMU* mmu, struct Timer* timer);
+    void (*mmu_attach_serial)(struct MMU* mmu, struct Serial* serial);
+    void (*mmu_attach_ppu)(struct MMU* mmu, struct PPU* ppu);
+    void (*mmu_attach_scheduler)(struct MMU* mmu, struct Scheduler* scheduler);
+    void (*mmu_map_cartridge_pages)(struct MMU* mmu);
 };
 
 // Function declarations
@@ -109,9 +148,34 @@ uint16_t mmu_get_word(struct MMU* mmu, uint16_t address);
 void mmu_set_word(struct MMU* mmu, uint16_t address, uint16_t word);
 // DMA
 void DMA(struct MMU* mmu, uint8_t source_bank);
+// Request an interrupt (INT_VBLANK, INT_LCD_STAT, ...) by setting its bit in IF
+void mmu_request_interrupt(struct MMU* mmu, uint8_t interrupt);
+// Clear an interrupt bit in IF once the CPU has serviced it
+void mmu_acknowledge_interrupt(struct MMU* mmu, uint8_t interrupt);
+// EVENT_DMA callback
+void mmu_handle_dma_event(void* context, uint64_t deadline);
 // Attach joypad
 void mmu_attach_joypad(struct MMU* mmu, struct Joypad* joypad);
 // Attach APU
 void mmu_attach_apu(struct MMU* mmu, struct APU* apu);
+// Attach timer
+void mmu_attach_timer(struct MMU* mmu, struct Timer* timer);
+// Attach serial port
+void mmu_attach_serial(struct MMU* mmu, struct Serial* serial);
+// Attach PPU registers, the PPU owns LCDC/STAT/SCY/SCX/LY/LYC/BGP/OBP0/OBP1/WY/WX
+void mmu_attach_ppu(struct MMU* mmu, struct PPU* ppu);
+// Attach scheduler, OAM DMA then completes after DMA_CYCLES instead of instantly
+void mmu_attach_scheduler(struct MMU* mmu, struct Scheduler* scheduler);
+// Install I/O register handlers, NULL restores plain memory
+void mmu_register_io_handler(
+    struct MMU* mmu, uint16_t address, uint8_t (*read)(struct MMU*, uint16_t),
+    void (*write)(struct MMU*, uint16_t, uint8_t));
+// Plain memory I/O handlers
+uint8_t mmu_io_read_memory(struct MMU* mmu, uint16_t address);
+void    mmu_io_write_memory(struct MMU* mmu, uint16_t address, uint8_t byte);
+// Build page table
+void mmu_map_pages(struct MMU* mmu);
+// Repoint cartridge ROM/RAM pages, called on bank switch
+void mmu_map_cartridge_pages(struct MMU* mmu);
 
 #endif
@@ -1,4 +1,6 @@
 #include "ppu.h"
+#include "render_pool.h"
+#include "render_worker.h"
 
 struct PPU* create_ppu(struct Vram* vram)
 {
@@ -10,6 +12,13 @@ struct PPU* create_ppu(struct Vram* vram)
     // Initialize state
     ppu->ppu_inner_clock  = 0;
     ppu->mode             = MODE_OAM_SEARCH;   // Start in OAM scan mode
+    ppu->scheduler        = NULL;
+    ppu->stage            = STAGE_FRAME_START;
+    ppu->frame_ready      = false;
+    ppu->frame_count      = 0;
+    ppu->render_worker    = NULL;
+    ppu->render_pool      = NULL;
+    ppu->frame_state_count = 0;
     ppu->vram             = vram;
     ppu->framebuffer      = (uint8_t*)malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint8_t));
     if (ppu->framebuffer == NULL) {
@@ -21,8 +30,7 @@ struct PPU* create_ppu(struct Vram* vram)
     memset(ppu->framebuffer, 3, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint8_t));
 
     // Initialize line buffers
-    memset(ppu->line_buffer_bg_and_window, 0, SCREEN_WIDTH);
-    memset(ppu->line_buffer_sprite, 0, SCREEN_WIDTH * 2);
+    memset(&ppu->line_buffers, 0, sizeof(ppu->line_buffers));
     memset(ppu->line_buffer, 0, SCREEN_WIDTH);
 
     // Initialize FIFO structures
@@ -43,22 +51,36 @@ struct PPU* create_ppu(struct Vram* vram)
         return NULL;
     }
     ppu->searched_sprite_count = 0;
+    memset(&ppu->sprite_table, 0, sizeof(ppu->sprite_table));
+    ppu->sprite_bins_dirty = true;
+
+    ppu->deferred_frame     = false;
+    ppu->deferred_next_line = 0;
+    ppu->change_count       = 0;
 
     // Initialize default register values
+    // (post boot ROM state, the PPU owns 0xFF40-0xFF4B)
     ppu->ly = 0;
-    ppu->lcdc = 0xA1;  // LCD & BG enabled by default (with tile data from 0x8000)
+    ppu->lyc = 0;
+    ppu->lcdc = 0x91;  // LCD & BG enabled, tile data from 0x8000
     ppu->stat = 0;
     ppu->scx = 0;
     ppu->scy = 0;
     ppu->wy = 0;
     ppu->wx = 0;
-    ppu->bgp = 0xE4;   // Default palette (11 10 01 00) - inverted for GB
+    ppu->bgp = 0xFC;   // Default palette (11 11 11 00)
     ppu->obp0 = 0xFF;
     ppu->obp1 = 0xFF;
     ppu->tile_map_base_address = 0x9800;
     ppu->tile_data_base_address = 0x9000;
 
     // Initialize public method pointers
+    ppu->compose = compositor_select();
+
+    // no output until a consumer sets one, DMG green shades by default
+    static const uint32_t dmg_palette[4] = {0xFFE8FCCC, 0xFFACD490, 0xFF548C70, 0xFF142C38};
+    memset(&ppu->output, 0, sizeof(ppu->output));
+    ppu_set_output_palette(ppu, dmg_palette, 4);
 
     return ppu;
 }
@@ -67,18 +89,9 @@ struct PPU* create_ppu(struct Vram* vram)
 void ppu_attach_mmu(struct PPU* self, struct MMU* mmu)
 {
     self->mmu = mmu;
-    
-    // Write initial PPU register values to memory
-    mmu->mmu_set_byte(mmu, LCDC_ADDRESS, self->lcdc);
-    mmu->mmu_set_byte(mmu, STAT_ADDRESS, self->stat);
-    mmu->mmu_set_byte(mmu, SCY_ADDRESS, self->scy);
-    mmu->mmu_set_byte(mmu, SCX_ADDRESS, self->scx);
-    mmu->mmu_set_byte(mmu, LY_ADDRESS, self->ly);
-    mmu->mmu_set_byte(mmu, WY_ADDRESS, self->wy);
-    mmu->mmu_set_byte(mmu, WX_ADDRESS, self->wx);
-    mmu->mmu_set_byte(mmu, BGP_ADDRESS, self->bgp);
-    mmu->mmu_set_byte(mmu, OBP0_ADDRESS, self->obp0);
-    mmu->mmu_set_byte(mmu, OBP1_ADDRESS, self->obp1);
+    // LCD registers live in the PPU from now on, the MMU forwards 0xFF40-0xFF4B (except DMA)
+    mmu_attach_ppu(mmu, self);
+    ppu_reload_sprite_table(self);
 }
 
 // attach form to ppu
@@ -87,21 +100,373 @@ void ppu_attach_form(struct PPU* self, struct Form* form)
     self->form = form;
 }
 
+void ppu_attach_render_worker(struct PPU* self, struct RenderWorker* worker)
+{
+    self->render_worker = worker;
+}
+
+void ppu_attach_render_pool(struct PPU* self, struct RenderPool* pool)
+{
+    self->render_pool = pool;
+}
+
+// ARGB8888 color in the output format
+static uint32_t ppu_convert_color(uint32_t argb, enum PPUOutputFormat format)
+{
+    if (format == PPU_OUTPUT_RGB565) {
+        return ((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F);
+    }
+    return argb;
+}
+
+void ppu_set_output_palette(struct PPU* self, const uint32_t* colors, int count)
+{
+    for (int index = 0; index < count && index < PPU_OUTPUT_PALETTE_SIZE; index++) {
+        self->output.palette[index] = colors[index];
+        self->output.lut[index]     = ppu_convert_color(colors[index], self->output.format);
+    }
+}
+
+void ppu_set_output(struct PPU* self, void* pixels, int pitch, enum PPUOutputFormat format)
+{
+    self->output.pixels = pixels;
+    self->output.pitch  = pitch;
+    self->output.format = format;
+    for (int index = 0; index < PPU_OUTPUT_PALETTE_SIZE; index++) {
+        self->output.lut[index] = ppu_convert_color(self->output.palette[index], format);
+    }
+}
+
+// Map a line of shades through the palette into the output frame
+static void ppu_output_line(struct PPU* self, uint8_t ly, const uint8_t* shades)
+{
+    uint8_t*        row = (uint8_t*)self->output.pixels + ly * self->output.pitch;
+    const uint32_t* lut = self->output.lut;
+    if (self->output.format == PPU_OUTPUT_RGB565) {
+        uint16_t* pixels = (uint16_t*)row;
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            pixels[x] = lut[shades[x]];
+        }
+        return;
+    }
+    uint32_t* pixels = (uint32_t*)row;
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+        pixels[x] = lut[shades[x]];
+    }
+}
+
+void ppu_attach_scheduler(struct PPU* self, struct Scheduler* scheduler)
+{
+    self->scheduler = scheduler;
+    self->stage     = STAGE_FRAME_START;
+    scheduler_register(scheduler, EVENT_PPU, ppu_handle_event, self);
+    scheduler_schedule_in(scheduler, EVENT_PPU, 0);
+}
+
+// Whether this frame's scanlines are rendered (fast forward only renders every 4th frame)
+static bool ppu_should_render_frame(struct PPU* self)
+{
+    return !config.fast_forward_mode || self->frame_count % 4 == 0;
+}
+
+// Enter mode 2 on a visible line
+static void ppu_start_visible_line(struct PPU* self, uint8_t ly, uint64_t deadline)
+{
+    // OAM Scan (Mode 2)
+    // https://hacktix.github.io/GBEDG/ppu/
+    // This mode is entered at the start of every scanline (except for V-Blank) before pixels
+    // are actually drawn to the screen. During this mode the PPU searches OAM memory for
+    // sprites that should be rendered on the current scanline and stores them in a buffer. This
+    // procedure takes a total amount of 80 T-Cycles, meaning that the PPU checks a new OAM
+    // entry every 2 T-Cycles. CPU can't access OAM here
+    ppu_set_ly(self, ly);
+    ppu_set_mode(self, MODE_OAM_SEARCH);
+    if (ppu_should_render_frame(self) && !self->deferred_frame) {
+        ppu_oam_search(self);
+    }
+    self->stage = STAGE_OAM_SEARCH;
+    scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_OAM_SEARCH_CYCLES);
+}
+
+// First line a write made now shows up on: the current one until its pixels have been drawn.
+// OAM is locked during modes 2 and 3, so OAM search and drawing of a line never disagree
+static uint8_t ppu_change_line(struct PPU* self)
+{
+    return self->stage == STAGE_HBLANK ? self->ly + 1 : self->ly;
+}
+
+// Draw the lines collected for the render pool with the VRAM they were captured against
+static void ppu_draw_frame_states(struct PPU* self)
+{
+    render_pool_draw(self->render_pool, self->frame_states, self->frame_state_count,
+                     self->framebuffer);
+    self->frame_state_count = 0;
+}
+
+// Store a logged value without any of the side effects of a CPU write
+static void ppu_apply_change(struct PPU* self, uint16_t address, uint8_t value)
+{
+    if (address < 0xA000) {
+        if (self->render_worker) {
+            render_worker_sync(self->render_worker);
+        }
+        if (self->frame_state_count) {
+            ppu_draw_frame_states(self);
+        }
+        self->vram->vram_set_byte(self->vram, address, value);
+        return;
+    }
+    if (address < LCDC_ADDRESS) {
+        self->mmu->ram->ram_byte[address] = value;
+        ppu_update_sprite_table(self, address, value);
+        return;
+    }
+    switch (address) {
+    case LCDC_ADDRESS: self->lcdc = value; break;
+    case SCY_ADDRESS: self->scy = value; break;
+    case SCX_ADDRESS: self->scx = value; break;
+    case BGP_ADDRESS: self->bgp = value; break;
+    case OBP0_ADDRESS: self->obp0 = value; break;
+    case OBP1_ADDRESS: self->obp1 = value; break;
+    case WY_ADDRESS: self->wy = value; break;
+    case WX_ADDRESS: self->wx = value; break;
+    default: break;
+    }
+}
+
+void ppu_log_change(struct PPU* self, uint16_t address, uint8_t old_value, uint8_t new_value)
+{
+    if (old_value == new_value) {
+        return;
+    }
+    uint8_t line = ppu_change_line(self);
+    if (self->change_count == PPU_CHANGE_LOG_SIZE) {
+        PPU_TRACE_PRINT("Change log full on line %d, drawing pending lines\n", line);
+        ppu_render_deferred_lines(self, line);
+    }
+    struct PPUChange* change = &self->change_log[self->change_count++];
+    change->address          = address;
+    change->line             = line;
+    change->old_value        = old_value;
+    change->new_value        = new_value;
+}
+
+void ppu_render_deferred_lines(struct PPU* self, uint8_t end_line)
+{
+    struct PPUChange* log = self->change_log;
+    // rewind to the state the first pending line would have been drawn with
+    for (int index = self->change_count - 1; index >= 0; index--) {
+        ppu_apply_change(self, log[index].address, log[index].old_value);
+    }
+    // then play the log forward, one line at a time
+    int next = 0;
+    for (int line = self->deferred_next_line; line < end_line; line++) {
+        while (next < self->change_count && log[next].line <= line) {
+            ppu_apply_change(self, log[next].address, log[next].new_value);
+            next++;
+        }
+        ppu_oam_search_line(self, line);
+        if (self->render_pool) {
+            ppu_capture_line_state(self, line, &self->frame_states[self->frame_state_count++]);
+        }
+        else {
+            ppu_render_scanline_ly(self, line);
+        }
+    }
+    if (self->frame_state_count) {
+        ppu_draw_frame_states(self);
+    }
+    for (; next < self->change_count; next++) {
+        ppu_apply_change(self, log[next].address, log[next].new_value);
+    }
+    self->change_count       = 0;
+    self->deferred_next_line = end_line;
+}
+
+// LCD disabled: LY reads 0, STAT reports mode 0 and no STAT interrupts are raised.
+// The screen stays blank for a full frame, so the frame loop keeps presenting
+static void ppu_stop_lcd(struct PPU* self, uint64_t deadline)
+{
+    if (self->deferred_frame) {
+        // lines already on screen keep what they showed, the rest stays stale
+        ppu_render_deferred_lines(self, ppu_change_line(self));
+        self->deferred_frame = false;
+    }
+    self->ly   = 0;
+    self->mode = MODE_HBLANK;
+    self->stat = self->stat & ~STAT_MODE_MASK;
+    if (self->scheduler == NULL) {
+        return;
+    }
+    self->stage = STAGE_LCD_OFF;
+    scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_FRAME_CYCLES);
+}
+
+static void ppu_start_frame(struct PPU* self, uint64_t deadline)
+{
+    self->frame_count += 1;
+    if (!ppu_is_lcd_enabled(self)) {
+        ppu_stop_lcd(self, deadline);
+        return;
+    }
+    self->deferred_frame =
+        (config.deferred_rendering || self->render_pool) && ppu_should_render_frame(self);
+    self->deferred_next_line = 0;
+    self->change_count       = 0;
+    ppu_start_visible_line(self, 0, deadline);
+}
+
+void ppu_handle_event(void* context, uint64_t deadline)
+{
+    struct PPU* self = (struct PPU*)context;
+    switch (self->stage) {
+    case STAGE_FRAME_START: ppu_start_frame(self, deadline); break;
+    case STAGE_OAM_SEARCH:
+        // Pixel Transfer (Mode 3)
+        // The Drawing Mode is where the PPU transfers pixels to the LCD. CPU can't access VRAM
+        // and OAM here
+        ppu_set_mode(self, MODE_PIXEL_TRANSFER);
+        self->stage = STAGE_PIXEL_TRANSFER;
+        scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_PIXEL_TRANSFER_CYCLES);
+        break;
+    case STAGE_PIXEL_TRANSFER:
+        if (ppu_should_render_frame(self) && !self->deferred_frame) {
+            ppu_render_scanline_ly(self, self->ly);
+        }
+        // H-Blank (Mode 0)
+        // This mode takes up the remainder of the scanline after the Drawing Mode finishes,
+        // "padding" the duration of the scanline to a total of 456 T-Cycles.
+        ppu_set_mode(self, MODE_HBLANK);
+        self->stage = STAGE_HBLANK;
+        scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_HBLANK_CYCLES);
+        break;
+    case STAGE_HBLANK:
+        if (self->ly + 1 < SCREEN_HEIGHT) {
+            ppu_start_visible_line(self, self->ly + 1, deadline);
+            break;
+        }
+        if (self->deferred_frame) {
+            ppu_render_deferred_lines(self, SCREEN_HEIGHT);
+            self->deferred_frame = false;
+        }
+        if (self->render_worker && ppu_should_render_frame(self)) {
+            render_worker_end_frame(self->render_worker);
+        }
+        // V-Blank interrupt happening here
+        mmu_request_interrupt(self->mmu, INT_VBLANK);
+        // V-Blank (Mode 1): scanlines 144-153, 456 cycles each
+        ppu_set_ly(self, SCREEN_HEIGHT);
+        ppu_set_mode(self, MODE_VBLANK);
+        self->stage = STAGE_VBLANK;
+        scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_SCANLINE_CYCLES);
+        break;
+    case STAGE_VBLANK:
+        if (self->ly + 1 < PPU_SCANLINES_PER_FRAME) {
+            ppu_set_ly(self, self->ly + 1);
+            ppu_set_mode(self, MODE_VBLANK);
+            scheduler_schedule_at(self->scheduler, EVENT_PPU, deadline + PPU_SCANLINE_CYCLES);
+            break;
+        }
+        if (self->render_worker) {
+            // the frame is presented next, it has to be complete
+            render_worker_sync(self->render_worker);
+        }
+        self->frame_ready = true;
+        ppu_start_frame(self, deadline);
+        break;
+    case STAGE_LCD_OFF:
+        self->frame_ready = true;
+        ppu_start_frame(self, deadline);
+        break;
+    }
+}
+
+uint8_t ppu_read_register(struct PPU* self, uint16_t address)
+{
+    switch (address) {
+    case LCDC_ADDRESS: return self->lcdc;
+    case STAT_ADDRESS: return self->stat | STAT_UNUSED_BITS;
+    case SCY_ADDRESS: return self->scy;
+    case SCX_ADDRESS: return self->scx;
+    case LY_ADDRESS: return self->ly;
+    case LYC_ADDRESS: return self->lyc;
+    case BGP_ADDRESS: return self->bgp;
+    case OBP0_ADDRESS: return self->obp0;
+    case OBP1_ADDRESS: return self->obp1;
+    case WY_ADDRESS: return self->wy;
+    case WX_ADDRESS: return self->wx;
+    default: return 0xFF;
+    }
+}
+
+static void ppu_write_lcdc(struct PPU* self, uint8_t byte)
+{
+    bool     was_enabled = ppu_is_lcd_enabled(self);
+    uint64_t now         = self->scheduler ? self->scheduler->now : 0;
+    self->lcdc           = byte;
+    if (was_enabled && !ppu_is_lcd_enabled(self)) {
+        PPU_DEBUG_PRINT("LCD turned off on line %d\n", self->ly);
+        ppu_stop_lcd(self, now);
+    }
+    else if (!was_enabled && ppu_is_lcd_enabled(self) && self->scheduler != NULL) {
+        // the blank frame ends here, drawing restarts from line 0
+        PPU_DEBUG_PRINT("LCD turned on%s", "\n");
+        self->frame_ready = true;
+        ppu_start_frame(self, now);
+    }
+}
+
+void ppu_write_register(struct PPU* self, uint16_t address, uint8_t byte)
+{
+    if (self->deferred_frame && address != STAT_ADDRESS && address != LY_ADDRESS &&
+        address != LYC_ADDRESS) {
+        ppu_log_change(self, address, ppu_read_register(self, address), byte);
+    }
+    switch (address) {
+    case LCDC_ADDRESS: ppu_write_lcdc(self, byte); break;
+    case STAT_ADDRESS:
+        // only the interrupt enables are writable
+        self->stat = (self->stat & ~STAT_WRITABLE_BITS) | (byte & STAT_WRITABLE_BITS);
+        // DMG quirk: the write briefly enables every STAT source, so a write during H-Blank,
+        // V-Blank or while LY == LYC raises the STAT interrupt
+        if (ppu_is_lcd_enabled(self) &&
+            (self->mode == MODE_HBLANK || self->mode == MODE_VBLANK ||
+             (self->stat & STAT_LYC_EQUAL))) {
+            mmu_request_interrupt(self->mmu, INT_LCD_STAT);
+        }
+        break;
+    case SCY_ADDRESS: self->scy = byte; break;
+    case SCX_ADDRESS: self->scx = byte; break;
+    case LY_ADDRESS:
+        // read only
+        break;
+    case LYC_ADDRESS:
+        self->lyc = byte;
+        if (ppu_is_lcd_enabled(self)) {
+            ppu_update_lyc(self);
+        }
+        break;
+    case BGP_ADDRESS: self->bgp = byte; break;
+    case OBP0_ADDRESS: self->obp0 = byte; break;
+    case OBP1_ADDRESS: self->obp1 = byte; break;
+    case WY_ADDRESS: self->wy = byte; break;
+    case WX_ADDRESS: self->wx = byte; break;
+    default: break;
+    }
+}
+
 bool ppu_is_lcd_enabled(struct PPU* self)
 {
-    uint8_t lcdc = self->mmu->mmu_get_byte(self->mmu, LCDC_ADDRESS);
-    return (lcdc & LCDC_ENABLE) != 0;
+    return (self->lcdc & LCDC_ENABLE) != 0;
 }
 
 
 void ppu_set_mode(struct PPU* self, enum PPU_MODE mode)
 {
-    // Read current STAT register
-    uint8_t stat = self->mmu->mmu_get_byte(self->mmu, STAT_ADDRESS);
     // Update mode bits (preserve upper bits)
-    stat = (stat & ~STAT_MODE_MASK) | mode;
-    // Write back to memory
-    self->mmu->mmu_set_byte(self->mmu, STAT_ADDRESS, stat);
+    self->mode = mode;
+    self->stat = (self->stat & ~STAT_MODE_MASK) | mode;
+    uint8_t stat = self->stat;
     
     // Check for STAT mode interrupts
     bool trigger_stat_int = false;
@@ -122,56 +487,105 @@ void ppu_set_mode(struct PPU* self, enum PPU_MODE mode)
     }
     
     if (trigger_stat_int) {
-        uint8_t int_flag = self->mmu->mmu_get_byte(self->mmu, IF_ADDRESS);
-        int_flag |= 0x02; // Set bit 1 for STAT interrupt
-        self->mmu->mmu_set_byte(self->mmu, IF_ADDRESS, int_flag);
+        mmu_request_interrupt(self->mmu, INT_LCD_STAT);
     }
 }
 
 
 void ppu_oam_search(struct PPU* self)
+{
+    ppu_oam_search_line(self, self->ly);
+}
+
+void ppu_update_sprite_table(struct PPU* self, uint16_t address, uint8_t byte)
+{
+    uint16_t offset = address - OAM_TABLE_INITIAL_ADDDRESS;
+    uint8_t  index  = offset / 4;
+    switch (offset % 4) {
+    case 0:
+        self->sprite_bins_dirty |= self->sprite_table.y[index] != byte;
+        self->sprite_table.y[index] = byte;
+        break;
+    case 1:
+        self->sprite_bins_dirty |= self->sprite_table.x[index] != byte;
+        self->sprite_table.x[index] = byte;
+        break;
+    case 2: self->sprite_table.tile[index] = byte; break;
+    default: self->sprite_table.flags[index] = byte; break;
+    }
+}
+
+void ppu_reload_sprite_table(struct PPU* self)
+{
+    const uint8_t* oam = self->mmu->ram->ram_byte + OAM_TABLE_INITIAL_ADDDRESS;
+    for (int index = 0; index < OAM_SPRITE_COUNT; index++) {
+        self->sprite_table.y[index]     = oam[index * 4];
+        self->sprite_table.x[index]     = oam[index * 4 + 1];
+        self->sprite_table.tile[index]  = oam[index * 4 + 2];
+        self->sprite_table.flags[index] = oam[index * 4 + 3];
+    }
+    self->sprite_bins_dirty = true;
+}
+
+// Sort every sprite into the lines it shows up on, at most PPU_SPRITES_PER_LINE per line
+static void ppu_bin_sprites(struct PPU* self, uint8_t sprite_height)
+{
+    memset(self->line_sprite_count, 0, sizeof(self->line_sprite_count));
+    for (int index = 0; index < OAM_SPRITE_COUNT; index++) {
+        // Sprite visibility rules according to GBEDG:
+        // - Sprite X-Position must be greater than 0
+        // - LY + 16 must be greater than or equal to Sprite Y-Position
+        // - LY + 16 must be less than Sprite Y-Position + Sprite Height
+        if (self->sprite_table.x[index] == 0) {
+            continue;
+        }
+        // screen coordinates wrap like the 8 bit registers, sprites partly above line 0 are
+        // left out just as a per line search would
+        uint8_t sprite_y = self->sprite_table.y[index] - 16;
+        int     last     = sprite_y + sprite_height;
+        if (last > SCREEN_HEIGHT) {
+            last = SCREEN_HEIGHT;
+        }
+        for (int line = sprite_y; line < last; line++) {
+            // Earlier sprites in OAM have higher priority, later ones past the limit drop out
+            if (self->line_sprite_count[line] < PPU_SPRITES_PER_LINE) {
+                self->line_sprites[line][self->line_sprite_count[line]++] = index;
+            }
+        }
+    }
+    self->sprite_bins_dirty  = false;
+    self->sprite_bins_height = sprite_height;
+}
+
+void ppu_oam_search_line(struct PPU* self, uint8_t ly)
 {
     // OAM Search Mode according to GBEDG:
     // - Takes 80 T-cycles total (2 T-cycles per OAM entry)
     // - Searches all 40 OAM entries for sprites on current scanline
     // - Stores up to 10 sprites that meet visibility criteria
     // - Earlier sprites in OAM have higher priority
-    
-    // 1. Get the current line
-    uint8_t ly = self->mmu->mmu_get_byte(self->mmu, LY_ADDRESS);
-    // 2. Get sprite height (8 for normal, 16 for tall sprite mode)
+    // OAM rarely changes within a frame, so the search is done once for all lines in
+    // ppu_bin_sprites and a line only looks its sprites up
+
+    // 1. Get sprite height (8 for normal, 16 for tall sprite mode)
     uint8_t sprite_height =
-        8 * (((self->mmu->mmu_get_byte(self->mmu, LCDC_ADDRESS) & 0x04) >> 2) + 1);
+        8 * (((self->lcdc & 0x04) >> 2) + 1);
+    if (self->sprite_bins_dirty || self->sprite_bins_height != sprite_height) {
+        ppu_bin_sprites(self, sprite_height);
+    }
     self->searched_sprite_count = 0;
-    // populate all sprites from OAM: data from 0xFE00 to 0xFE9F
-    for (int index = 0; index < 40; index++) {
-        uint16_t            sprite_entry_address = OAM_TABLE_INITIAL_ADDDRESS + index * 4;
-        struct SpriteEntry* current_sprite       = &self->oam_buffer[index];
-        ppu_unpack_sprite_entry(
-            self->mmu->mmu_get_byte(self->mmu, sprite_entry_address),
-            self->mmu->mmu_get_byte(self->mmu, sprite_entry_address + 1),
-            self->mmu->mmu_get_byte(self->mmu, sprite_entry_address + 2),
-            self->mmu->mmu_get_byte(self->mmu, sprite_entry_address + 3),
-            current_sprite);
-        // Convert sprite coordinates to screen coordinates for consistent checking
-        uint8_t sprite_y = current_sprite->y - 16;
-        uint8_t sprite_x = current_sprite->x - 8;
-        
-        // Sprite visibility rules according to GBEDG:
-        // - Sprite X-Position must be greater than 0
-        // - LY + 16 must be greater than or equal to Sprite Y-Position  
-        // - LY + 16 must be less than Sprite Y-Position + Sprite Height
-        if (current_sprite->x == 0 || 
-            ly < sprite_y || ly >= sprite_y + sprite_height) {
-            continue;
-        }
-        // The amount of sprites already stored in the OAM Buffer must be less than 10
-        if (self->searched_sprite_count >= 10) {
-            break;  // Game Boy hardware limit: max 10 sprites per scanline
-        }
-        self->selected_oam_entries[self->searched_sprite_count] = current_sprite;
-        (self->searched_sprite_count) += 1;
+    if (ly >= SCREEN_HEIGHT) {
+        return;
+    }
+    for (int slot = 0; slot < self->line_sprite_count[ly]; slot++) {
+        uint8_t             index          = self->line_sprites[ly][slot];
+        struct SpriteEntry* current_sprite = &self->oam_buffer[index];
+        ppu_unpack_sprite_entry(self->sprite_table.y[index], self->sprite_table.x[index],
+                                self->sprite_table.tile[index], self->sprite_table.flags[index],
+                                current_sprite);
+        self->selected_oam_entries[slot] = current_sprite;
     }
+    self->searched_sprite_count = self->line_sprite_count[ly];
 }
 
 // unpack sprite entry to supplied sprite entry pointer and sprite flag pointer
@@ -202,23 +616,20 @@ void ppu_unpack_sprite_entry(
 void ppu_set_ly(struct PPU* self, uint8_t ly)
 {
     self->ly = ly;
-    self->mmu->mmu_set_byte(self->mmu, LY_ADDRESS, ly);
-    // check lyc
-    uint8_t lyc_byte  = self->mmu->mmu_get_byte(self->mmu, LYC_ADDRESS);
-    uint8_t stat_byte  = self->mmu->mmu_get_byte(self->mmu, STAT_ADDRESS);
-    if (ly == lyc_byte) {
-        stat_byte |= STAT_LYC_EQUAL;
-        if (stat_byte & STAT_LYC_INT) {
-            uint8_t int_flag = self->mmu->mmu_get_byte(self->mmu, IF_ADDRESS);
-            int_flag |= 0x02;
-            self->mmu->mmu_set_byte(self->mmu, IF_ADDRESS, int_flag);
+    ppu_update_lyc(self);
+}
+
+void ppu_update_lyc(struct PPU* self)
+{
+    if (self->ly == self->lyc) {
+        self->stat |= STAT_LYC_EQUAL;
+        if (self->stat & STAT_LYC_INT) {
+            mmu_request_interrupt(self->mmu, INT_LCD_STAT);
         }
     }
     else {
-        stat_byte &= ~STAT_LYC_EQUAL;
+        self->stat &= ~STAT_LYC_EQUAL;
     }
-
-    self->mmu->mmu_set_byte(self->mmu, STAT_ADDRESS, stat_byte);
 }
 
 // Render single scanline with given ly parameter
@@ -229,91 +640,85 @@ void ppu_render_scanline_ly(struct PPU* self, uint8_t ly)
         return;
     }
 
+    struct PPULineState state;
+    ppu_capture_line_state(self, ly, &state);
+    if (self->render_worker) {
+        render_worker_push(self->render_worker, &state);
+        return;
+    }
+    ppu_render_line(self, &self->line_buffers, &state, self->framebuffer + ly * SCREEN_WIDTH);
+}
+
+void ppu_capture_line_state(struct PPU* self, uint8_t ly, struct PPULineState* state)
+{
+    state->ly           = ly;
+    state->lcdc         = self->lcdc;
+    state->scx          = self->scx;
+    state->scy          = self->scy;
+    state->wy           = self->wy;
+    state->wx           = self->wx;
+    state->bgp          = self->bgp;
+    state->obp0         = self->obp0;
+    state->obp1         = self->obp1;
+    state->sprite_count = self->searched_sprite_count;
+    for (int index = 0; index < self->searched_sprite_count; index++) {
+        state->sprites[index] = *self->selected_oam_entries[index];
+    }
+}
+
+void ppu_render_line(struct PPU* self, struct PPULineBuffers* buffers,
+                     const struct PPULineState* state, uint8_t* out)
+{
     // Load PPU state for this scanline
-    uint8_t lcdc = self->mmu->mmu_get_byte(self->mmu, LCDC_ADDRESS);
-    uint8_t scx  = self->mmu->mmu_get_byte(self->mmu, SCX_ADDRESS);
-    uint8_t scy  = self->mmu->mmu_get_byte(self->mmu, SCY_ADDRESS);
-    uint8_t wy   = self->mmu->mmu_get_byte(self->mmu, WY_ADDRESS);
-    uint8_t wx   = self->mmu->mmu_get_byte(self->mmu, WX_ADDRESS);
-    uint8_t bgp  = self->mmu->mmu_get_byte(self->mmu, BGP_ADDRESS);
-    uint8_t obp0 = self->mmu->mmu_get_byte(self->mmu, OBP0_ADDRESS);
-    uint8_t obp1 = self->mmu->mmu_get_byte(self->mmu, OBP1_ADDRESS);
+    uint8_t ly   = state->ly;
+    uint8_t lcdc = state->lcdc;
+    uint8_t scx  = state->scx;
+    uint8_t scy  = state->scy;
+    uint8_t wy   = state->wy;
+    uint8_t wx   = state->wx;
+    uint8_t bgp  = state->bgp;
+    uint8_t obp0 = state->obp0;
+    uint8_t obp1 = state->obp1;
     
     // Calculate base addresses
-    uint16_t tile_map_base_address  = (lcdc & LCDC_BG_MAP) ? 0x9C00 : 0x9800;
-    uint16_t tile_data_base_address = (lcdc & LCDC_TILE_DATA) ? 0x8000 : 0x9000;
-    bool     signed_addressing = !(lcdc & LCDC_TILE_DATA);
+    uint16_t tile_map_base_address = (lcdc & LCDC_BG_MAP) ? 0x9C00 : 0x9800;
+    bool     signed_addressing     = !(lcdc & LCDC_TILE_DATA);
 
     // Clear line buffers
-    memset(self->line_buffer_bg_and_window, 0, SCREEN_WIDTH);
-    memset(self->line_buffer_sprite, 0, SCREEN_WIDTH * 2);
-    memset(self->line_buffer, 0, SCREEN_WIDTH);
+    memset(buffers, 0, sizeof(*buffers));
 
     // Draw background for this line
     if (lcdc & LCDC_BG_ON) {
-        ppu_render_background_scanline(self, ly, scx, scy, tile_map_base_address, tile_data_base_address, signed_addressing, bgp);
+        ppu_render_background_scanline(self, buffers, ly, scx, scy, tile_map_base_address, signed_addressing);
     }
 
     // Draw window for this line
     if (lcdc & LCDC_WINDOW_ON) {
         // Window uses its own tile map selection bit (bit 6 of LCDC)
         uint16_t window_tile_map = (lcdc & LCDC_WINDOW_MAP) ? 0x9C00 : 0x9800;
-        ppu_render_window_scanline(self, ly, wx, wy, window_tile_map, tile_data_base_address, signed_addressing, bgp);
+        ppu_render_window_scanline(self, buffers, ly, wx, wy, window_tile_map, signed_addressing);
     }
 
     // Draw sprites for this line
     if (lcdc & LCDC_OBJ_ON) {
-        ppu_render_sprites_scanline(self, ly, lcdc, obp0, obp1);
+        ppu_render_sprites_scanline(self, buffers, ly, lcdc, state->sprites, state->sprite_count);
     }
 
-    // Merge layers and copy to framebuffer with proper sprite priority using RAW color indices
-    for (int x = 0; x < SCREEN_WIDTH; x++) {
-        uint8_t bg_color_raw = self->line_buffer_bg_and_window[x];      // Raw BG color index (0-3)
-        uint8_t sprite_color_raw = self->line_buffer_sprite[x][0];      // Raw sprite color index (0-3)
-        uint8_t sprite_info = self->line_buffer_sprite[x][1];
-        
-        // LCDC.0 - BG/Window Enable: If disabled, background shows as white (color 0)
-        if (!(lcdc & LCDC_BG_ON)) {
-            bg_color_raw = 0;  // Force background to white when BG/Window disabled
-        }
-        
-        // Determine final raw color index using Game Boy priority rules
-        uint8_t final_color_raw;
-        uint8_t final_palette;
-        
-        // Handle sprite-to-background priority using RAW color indices
-        if (sprite_color_raw != 0) {
-            // Extract sprite priority and palette info
-            bool sprite_priority_behind = (sprite_info & 0x80) != 0;
-            bool sprite_uses_obp1 = (sprite_info & 0x40) != 0;
-            
-            if (sprite_priority_behind) {
-                // Priority 1: Sprite appears behind background colors 1, 2, 3 (but above color 0)
-                if (bg_color_raw == 0) {
-                    final_color_raw = sprite_color_raw;
-                    final_palette = sprite_uses_obp1 ? obp1 : obp0;  // Use sprite palette
-                } else {
-                    final_color_raw = bg_color_raw;
-                    final_palette = bgp;  // Use background palette
-                }
-            } else {
-                // Priority 0: Sprite appears above background
-                final_color_raw = sprite_color_raw;
-                final_palette = sprite_uses_obp1 ? obp1 : obp0;  // Use sprite palette
-            }
-        } else {
-            // No sprite pixel, use background
-            final_color_raw = bg_color_raw;
-            final_palette = bgp;  // Use background palette
-        }
-        
-        // Apply the appropriate palette to get final display color
-        uint8_t final_display_color = (final_palette >> (final_color_raw * 2)) & 0x03;
-        self->line_buffer[x] = final_display_color;
+    // Merge layers with Game Boy sprite priority rules and apply the palettes
+    // LCDC.0 - BG/Window Enable: If disabled, background shows as white (color 0)
+    struct CompositorLine line = {
+        .bg         = buffers->bg_and_window,
+        .obj_color  = buffers->sprite_color,
+        .obj_info   = buffers->sprite_info,
+        .bg_enabled = (lcdc & LCDC_BG_ON) != 0,
+        .bgp        = bgp,
+        .obp0       = obp0,
+        .obp1       = obp1,
+    };
+    self->compose(out, &line);
+    if (self->output.pixels) {
+        ppu_output_line(self, ly, out);
     }
-    
-    // Copy line to framebuffer
-    memcpy(self->framebuffer + ly * SCREEN_WIDTH, self->line_buffer, SCREEN_WIDTH);
 }
 
 // // Render full frame (160x144) to framebuffer - called during V-Blank
@@ -375,51 +780,28 @@ void ppu_render_scanline_ly(struct PPU* self, uint8_t ly)
 // }
 
 // Helper function to render background for a single scanline
-void ppu_render_background_scanline(struct PPU* self, uint8_t ly, uint8_t scx, uint8_t scy, 
-                                   uint16_t tile_map, uint16_t tile_data_base, bool signed_addressing, uint8_t bgp)
+void ppu_render_background_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                    uint8_t scx, uint8_t scy, uint16_t tile_map,
+                                    bool signed_addressing)
 {
-    uint8_t y        = (ly + scy) & 0xFF; // Wrap around at 256
-    uint8_t tile_row = y / 8;
-    uint8_t tile_y   = y % 8;
+    uint8_t y = (ly + scy) & 0xFF; // Wrap around at 256
 
-    for (int x = 0; x < SCREEN_WIDTH; x++) {
-        uint8_t pixel_x = (x + scx) & 0xFF; // Wrap around at 256
-        uint8_t tile_col = pixel_x / 8;
-        uint8_t tile_x   = pixel_x % 8;
-
-        // Get tile index from background map
-        uint16_t tile_map_address = tile_map + (tile_row * 32) + tile_col;
-        uint8_t  tile_index       = self->mmu->mmu_get_byte(self->mmu, tile_map_address);
-
-        // Calculate tile data address
-        uint16_t tile_data_address;
-        if (signed_addressing) {
-            // 8800 method: tile_index is signed, base is 0x9000
-            int8_t signed_tile_index = (int8_t)tile_index;
-            tile_data_address = tile_data_base + (signed_tile_index * 16) + (tile_y * 2);
-        } else {
-            // 8000 method: tile_index is unsigned, base is 0x8000
-            tile_data_address = tile_data_base + (tile_index * 16) + (tile_y * 2);
-        }
-
-        // Read tile data (2 bytes per row)
-        uint8_t tile_data_low  = self->mmu->mmu_get_byte(self->mmu, tile_data_address);
-        uint8_t tile_data_high = self->mmu->mmu_get_byte(self->mmu, tile_data_address + 1);
-
-        // Extract pixel color (2 bits per pixel)
-        uint8_t bit_pos = 7 - tile_x;
-        uint8_t color_low  = (tile_data_low >> bit_pos) & 1;
-        uint8_t color_high = (tile_data_high >> bit_pos) & 1;
-        uint8_t color      = (color_high << 1) | color_low;
-
-        // Store RAW background color index (0-3) - palette will be applied later during mixing
-        self->line_buffer_bg_and_window[x] = color;
+    // The whole tile map is kept decoded, a line is a copy that wraps around at x = 256
+    const uint8_t* row   = vram_get_layer_row(self->vram, tile_map, signed_addressing, y);
+    int            count = VRAM_LAYER_SIZE - scx;
+    if (count > SCREEN_WIDTH) {
+        count = SCREEN_WIDTH;
     }
+
+    // Store RAW background color indices (0-3) - palette will be applied later during mixing
+    memcpy(buffers->bg_and_window, row + scx, count);
+    memcpy(buffers->bg_and_window + count, row, SCREEN_WIDTH - count);
 }
 
 // Helper function to render window for a single scanline
-void ppu_render_window_scanline(struct PPU* self, uint8_t ly, uint8_t wx, uint8_t wy,
-                               uint16_t tile_map, uint16_t tile_data_base, bool signed_addressing, uint8_t bgp)
+void ppu_render_window_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                uint8_t wx, uint8_t wy, uint16_t tile_map,
+                                bool signed_addressing)
 {
     // Check if window should be visible on this line
     if (ly < wy) {
@@ -433,51 +815,18 @@ void ppu_render_window_scanline(struct PPU* self, uint8_t ly, uint8_t wx, uint8_
     }
 
     uint8_t window_line = ly - wy;
-    uint8_t tile_row    = window_line / 8;
-    uint8_t tile_y      = window_line % 8;
-
-    for (int x = (window_start_x > 0 ? window_start_x : 0); x < SCREEN_WIDTH; x++) {
-        // Calculate window-relative coordinates
-        int window_x_signed = x - window_start_x;
-        
-        // Skip pixels that are before the window starts
-        if (window_x_signed < 0) {
-            continue;
-        }
-        
-        uint8_t window_x = (uint8_t)window_x_signed;
-        uint8_t tile_col = window_x / 8;
-        uint8_t tile_x   = window_x % 8;
-
-        // Get tile index from window tile map (32x32 grid)
-        uint16_t tile_addr = tile_map + ((tile_row & 31) * 32) + (tile_col & 31);
-        uint8_t  tile_idx  = self->mmu->mmu_get_byte(self->mmu, tile_addr);
-
-        // Calculate tile data address
-        uint16_t data_addr;
-        if (signed_addressing) {
-            // 8800 method: base at 0x9000, signed tile index
-            data_addr = tile_data_base + ((int8_t)tile_idx * 16);
-        } else {
-            // 8000 method: base at 0x8000, unsigned tile index
-            data_addr = tile_data_base + (tile_idx * 16);
-        }
-
-        // Get the two bytes for this tile row (Game Boy 2BPP format)
-        uint8_t byte1 = self->mmu->mmu_get_byte(self->mmu, data_addr + (tile_y * 2));
-        uint8_t byte2 = self->mmu->mmu_get_byte(self->mmu, data_addr + (tile_y * 2) + 1);
+    // the window always starts at the top left of its tile map, no wrapping within a line
+    const uint8_t* row = vram_get_layer_row(self->vram, tile_map, signed_addressing, window_line);
 
-        // Extract the pixel (2 bits per pixel)
-        uint8_t bit = 7 - tile_x;
-        uint8_t color_id = ((byte2 >> bit) & 1) << 1 | ((byte1 >> bit) & 1);
-        
-        // Store RAW window color index (0-3) - palette will be applied later during mixing
-        self->line_buffer_bg_and_window[x] = color_id;
-    }
+    // Store RAW window color indices (0-3) - palette will be applied later during mixing
+    int x = window_start_x > 0 ? window_start_x : 0;
+    memcpy(buffers->bg_and_window + x, row + (x - window_start_x), SCREEN_WIDTH - x);
 }
 
 // Helper function to render sprites for a single scanline
-void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uint8_t obp0, uint8_t obp1)
+void ppu_render_sprites_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                 uint8_t lcdc, const struct SpriteEntry* sprites,
+                                 uint8_t sprite_count)
 {
     uint8_t sprite_height = (lcdc & LCDC_OBJ_SIZE) ? 16 : 8;
 
@@ -486,8 +835,8 @@ void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uin
     
     // Draw sprites in forward OAM order for proper priority
     // Earlier sprites in OAM have higher priority and should overwrite later sprites
-    for (int sprite_idx = 0; sprite_idx < self->searched_sprite_count; sprite_idx++) {
-        struct SpriteEntry* sprite = self->selected_oam_entries[sprite_idx];
+    for (int sprite_idx = 0; sprite_idx < sprite_count; sprite_idx++) {
+        const struct SpriteEntry* sprite = &sprites[sprite_idx];
         
         uint8_t sprite_y = sprite->y - 16;  // Sprite Y is offset by 16
         uint8_t sprite_x = sprite->x - 8;   // Sprite X is offset by 8
@@ -511,13 +860,17 @@ void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uin
             }
         }
 
-        // Sprites always use 8000 addressing method
-        uint16_t data_addr = 0x8000 + (tile_idx * 16) + (sprite_row * 2);
-        uint8_t  byte1     = self->mmu->mmu_get_byte(self->mmu, data_addr);
-        uint8_t  byte2     = self->mmu->mmu_get_byte(self->mmu, data_addr + 1);
+        // Sprites always use 8000 addressing method, X flip picks the mirrored cache entry
+        const uint8_t* row = vram_get_tile_row(self->vram, tile_idx, sprite_row, sprite->x_flip);
 
-        // Select palette (sprite->palette: 0=OBP0, 1=OBP1)
-        uint8_t palette = sprite->palette ? obp1 : obp0;
+        // Sprite info: low 7 bits = sprite index, bit 7 = priority, bit 6 = palette (OBP1)
+        uint8_t sprite_info = sprite_idx & 0x7F;
+        if (sprite->priority == 1) {
+            sprite_info |= COMPOSITOR_OBJ_BEHIND_BG;
+        }
+        if (sprite->palette == 1) {
+            sprite_info |= COMPOSITOR_OBJ_PALETTE_1;
+        }
 
         // Draw 8 pixels of the sprite
         for (int pixel_x = 0; pixel_x < 8; pixel_x++) {
@@ -528,9 +881,7 @@ void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uin
                 continue;
             }
 
-            // Handle X flip
-            uint8_t bit = sprite->x_flip ? pixel_x : (7 - pixel_x);
-            uint8_t color_id = ((byte2 >> bit) & 1) << 1 | ((byte1 >> bit) & 1);
+            uint8_t color_id = row[pixel_x];
 
             // Color 0 is transparent for sprites
             if (color_id == 0) {
@@ -539,24 +890,13 @@ void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uin
 
             // Sprite-to-sprite priority: Don't overwrite existing sprite pixels
             // Earlier sprites in OAM have higher priority
-            if (self->line_buffer_sprite[screen_x][0] != 0) {
+            if (buffers->sprite_color[screen_x] != 0) {
                 continue; // Skip this pixel, earlier sprite already claimed it
             }
             
             // Store RAW sprite color index (0-3) - palette will be applied later during mixing
-            self->line_buffer_sprite[screen_x][0] = color_id;
-            
-            // Store sprite info: low 7 bits = sprite index, high bit = priority
-            self->line_buffer_sprite[screen_x][1] = sprite_idx & 0x7F;
-            if (sprite->priority == 1) {
-                self->line_buffer_sprite[screen_x][1] |= 0x80; // Set high bit for priority 1
-            }
-            
-            // Store palette selection in a way we can retrieve it
-            // We'll use a separate approach - store palette bit in unused bits
-            if (sprite->palette == 1) {
-                self->line_buffer_sprite[screen_x][1] |= 0x40; // Use bit 6 for palette selection
-            }
+            buffers->sprite_color[screen_x] = color_id;
+            buffers->sprite_info[screen_x]  = sprite_info;
         }
     }
 }
@@ -625,7 +965,7 @@ void bg_fetcher_reset(struct BackgroundFetcher* fetcher, uint8_t ly, uint8_t scx
 void bg_fetcher_step(struct PPU* ppu)
 {
     struct BackgroundFetcher* fetcher = &ppu->bg_fetcher;
-    uint8_t lcdc = ppu->mmu->mmu_get_byte(ppu->mmu, LCDC_ADDRESS);
+    uint8_t lcdc = ppu->lcdc;
     
     switch (fetcher->state) {
         case FETCH_TILE_NUMBER: {
@@ -728,8 +1068,8 @@ void sprite_fetcher_reset(struct SpriteFetcher* fetcher)
 void sprite_fetcher_step(struct PPU* ppu, struct SpriteEntry* sprite)
 {
     struct SpriteFetcher* fetcher = &ppu->sprite_fetcher;
-    uint8_t lcdc = ppu->mmu->mmu_get_byte(ppu->mmu, LCDC_ADDRESS);
-    uint8_t ly = ppu->mmu->mmu_get_byte(ppu->mmu, LY_ADDRESS);
+    uint8_t lcdc = ppu->lcdc;
+    uint8_t ly = ppu->ly;
     
     switch (fetcher->state) {
         case FETCH_TILE_NUMBER: {
@@ -809,8 +1149,8 @@ void sprite_fetcher_step(struct PPU* ppu, struct SpriteEntry* sprite)
 void sprite_fetcher_push_pixels(struct PPU* ppu, struct SpriteEntry* sprite)
 {
     struct SpriteFetcher* fetcher = &ppu->sprite_fetcher;
-    uint8_t obp0 = ppu->mmu->mmu_get_byte(ppu->mmu, OBP0_ADDRESS);
-    uint8_t obp1 = ppu->mmu->mmu_get_byte(ppu->mmu, OBP1_ADDRESS);
+    uint8_t obp0 = ppu->obp0;
+    uint8_t obp1 = ppu->obp1;
     uint8_t palette_reg = sprite->palette ? obp1 : obp0;
     
     // Calculate sprite screen position
@@ -891,11 +1231,11 @@ void ppu_render_scanline_fifo(struct PPU* self, uint8_t ly)
     }
     
     // Load PPU registers
-    uint8_t lcdc = self->mmu->mmu_get_byte(self->mmu, LCDC_ADDRESS);
-    uint8_t scx = self->mmu->mmu_get_byte(self->mmu, SCX_ADDRESS);
-    uint8_t scy = self->mmu->mmu_get_byte(self->mmu, SCY_ADDRESS);
-    uint8_t wx = self->mmu->mmu_get_byte(self->mmu, WX_ADDRESS);
-    uint8_t wy = self->mmu->mmu_get_byte(self->mmu, WY_ADDRESS);
+    uint8_t lcdc = self->lcdc;
+    uint8_t scx = self->scx;
+    uint8_t scy = self->scy;
+    uint8_t wx = self->wx;
+    uint8_t wy = self->wy;
     
     // Initialize FIFO state
     fifo_clear(&self->background_fifo);
@@ -1028,15 +1368,15 @@ void ppu_render_scanline_fifo(struct PPU* self, uint8_t ly)
             uint8_t final_color = final_pixel.color_raw;
             if (final_pixel.palette == 0) {
                 // Background palette (BGP)
-                uint8_t bgp = self->mmu->mmu_get_byte(self->mmu, BGP_ADDRESS);
+                uint8_t bgp = self->bgp;
                 final_color = (bgp >> (final_pixel.color_raw * 2)) & 0x03;
             } else if (final_pixel.palette == 1) {
                 // Sprite palette 0 (OBP0)
-                uint8_t obp0 = self->mmu->mmu_get_byte(self->mmu, OBP0_ADDRESS);
+                uint8_t obp0 = self->obp0;
                 final_color = (obp0 >> (final_pixel.color_raw * 2)) & 0x03;
             } else if (final_pixel.palette == 2) {
                 // Sprite palette 1 (OBP1)
-                uint8_t obp1 = self->mmu->mmu_get_byte(self->mmu, OBP1_ADDRESS);
+                uint8_t obp1 = self->obp1;
                 final_color = (obp1 >> (final_pixel.color_raw * 2)) & 0x03;
             }
             
@@ -1059,6 +1399,14 @@ void ppu_render_scanline_fifo(struct PPU* self, uint8_t ly)
 void free_ppu(struct PPU* ppu)
 {
     if (ppu != NULL) {
+        if (ppu->render_worker != NULL) {
+            free_render_worker(ppu->render_worker);
+            ppu->render_worker = NULL;
+        }
+        if (ppu->render_pool != NULL) {
+            free_render_pool(ppu->render_pool);
+            ppu->render_pool = NULL;
+        }
         if (ppu->vram != NULL) {
             free_vram(ppu->vram);
             ppu->vram = NULL;
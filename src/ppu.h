@@ -1,8 +1,10 @@
 #ifndef GAMEBOY_PPU_H
 #define GAMEBOY_PPU_H
 
+#include "compositor.h"
 #include "general.h"
 #include "mmu.h"
+#include "scheduler.h"
 #include "vram.h"
 
 // PPU Constants
@@ -24,6 +26,37 @@ enum PPU_MODE
     MODE_PIXEL_TRANSFER = 3
 };
 
+// PPU timing, in the same cycles the CPU is stepped with
+#define PPU_OAM_SEARCH_CYCLES     80
+#define PPU_PIXEL_TRANSFER_CYCLES 172
+#define PPU_HBLANK_CYCLES         204
+#define PPU_SCANLINE_CYCLES       456
+#define PPU_SCANLINES_PER_FRAME   154
+#define PPU_FRAME_CYCLES          (PPU_SCANLINE_CYCLES * PPU_SCANLINES_PER_FRAME)
+
+// What the PPU is doing until its next EVENT_PPU fires
+enum PPU_STAGE
+{
+    STAGE_FRAME_START,      // about to start a frame (checks LCDC.7)
+    STAGE_OAM_SEARCH,       // mode 2 of a visible line
+    STAGE_PIXEL_TRANSFER,   // mode 3 of a visible line
+    STAGE_HBLANK,           // mode 0 of a visible line
+    STAGE_VBLANK,           // one of the V-Blank lines
+    STAGE_LCD_OFF           // a frame with the LCD disabled
+};
+
+// Writes logged while a deferred frame is on screen, the pending lines are drawn early when full
+#define PPU_CHANGE_LOG_SIZE 1024
+
+// One write to an LCD register, VRAM or OAM, in effect from `line` on
+struct PPUChange
+{
+    uint16_t address;
+    uint8_t  line;
+    uint8_t  old_value;
+    uint8_t  new_value;
+};
+
 extern struct EmulatorConfig config;
 
 // PPU debug print
@@ -119,6 +152,10 @@ extern struct EmulatorConfig config;
 #define STAT_LYC_EQUAL  0x04
 // Bit2-1: Mode Bits
 #define STAT_MODE_MASK  0x03
+// Bits 3-6 are the only ones the CPU can write
+#define STAT_WRITABLE_BITS 0x78
+// Bit 7 is unused and reads back as 1
+#define STAT_UNUSED_BITS   0x80
 
 // Pixel FIFO pixel structure
 struct FIFOPixel {
@@ -203,6 +240,69 @@ struct SpriteEntry
     uint8_t palette  : 1;
 };
 
+#define OAM_SPRITE_COUNT     40
+#define PPU_SPRITES_PER_LINE 10   // hardware limit per scanline
+
+// OAM split into one array per field, kept in step with every OAM write
+struct SpriteTable
+{
+    uint8_t y[OAM_SPRITE_COUNT];
+    uint8_t x[OAM_SPRITE_COUNT];
+    uint8_t tile[OAM_SPRITE_COUNT];
+    uint8_t flags[OAM_SPRITE_COUNT];
+};
+
+// Everything a scanline is drawn from besides VRAM, captured when its pixels are transferred
+struct PPULineState
+{
+    uint8_t            ly;
+    uint8_t            lcdc;
+    uint8_t            scx;
+    uint8_t            scy;
+    uint8_t            wy;
+    uint8_t            wx;
+    uint8_t            bgp;
+    uint8_t            obp0;
+    uint8_t            obp1;
+    uint8_t            sprite_count;
+    struct SpriteEntry sprites[10];   // sprites OAM search selected, in OAM order
+};
+
+// Per layer line buffers, every thread that draws lines needs its own
+struct PPULineBuffers
+{
+    // BG & Window - 160 pixels
+    uint8_t bg_and_window[160];
+    // Sprite - 160 pixels
+    // color index, and sprite index in bits 0-6 plus the COMPOSITOR_OBJ_* bits
+    // kept as two planes so the compositor can load them 16/32 pixels at a time
+    uint8_t sprite_color[160];
+    uint8_t sprite_info[160];
+};
+
+// Pixel formats the PPU can write finished lines in
+enum PPUOutputFormat
+{
+    PPU_OUTPUT_ARGB8888,
+    PPU_OUTPUT_RGB565,
+};
+
+// Palette entries: the 4 DMG shades, sized for 8 BG + 8 OBJ palettes of 4 colors on CGB
+#define PPU_OUTPUT_PALETTE_SIZE 64
+
+// Caller owned frame the PPU writes final colors into, next to its 2 bit shade framebuffer
+struct PPUOutput
+{
+    void*                pixels;   // NULL: no output
+    int                  pitch;    // bytes between the starts of two lines
+    enum PPUOutputFormat format;
+    uint32_t             palette[PPU_OUTPUT_PALETTE_SIZE];   // ARGB8888 as set by the caller
+    uint32_t             lut[PPU_OUTPUT_PALETTE_SIZE];       // palette in the output format
+};
+
+struct RenderWorker;
+struct RenderPool;
+
 struct PPU
 {
     // Internal state
@@ -212,9 +312,24 @@ struct PPU
     struct MMU*   mmu;                // only for r/w registers
     struct Form*  form;               // form for drawing
     uint8_t*      framebuffer;        // Screen resolution 160x144
+    // draws lines on another thread when attached, ppu->framebuffer then flips once per frame
+    struct RenderWorker* render_worker;
+    // draws deferred frames with several threads when attached, lines are collected in
+    // frame_states and drawn in one batch unless a VRAM change has to land in between
+    struct RenderPool*   render_pool;
+    struct PPULineState  frame_states[SCREEN_HEIGHT];
+    int                  frame_state_count;
+
+    // Timing, driven by EVENT_PPU
+    struct Scheduler* scheduler;
+    enum PPU_STAGE    stage;
+    bool              frame_ready;   // set when a frame has been completed
+    uint32_t          frame_count;   // frames started so far, starting at 1
 
     // these shouldn't change during drawing
+    // LCD registers 0xFF40-0xFF4B (except DMA), the MMU forwards CPU accesses here
     uint8_t ly;
+    uint8_t lyc;
     uint8_t lcdc;
     uint8_t stat;
     uint8_t scx;
@@ -227,14 +342,22 @@ struct PPU
     uint16_t tile_map_base_address;
     uint16_t tile_data_base_address;
 
-    // line buffer - BG & Window - 160 pixels
-    uint8_t line_buffer_bg_and_window[160];
+    // Deferred rendering (config.deferred_rendering): the whole frame is drawn at V-Blank.
+    // Writes that land while the frame is on screen are logged so every line still sees the
+    // registers, VRAM and OAM it would have been drawn with
+    bool             deferred_frame;       // this frame is drawn from the change log
+    uint8_t          deferred_next_line;   // first line not drawn yet
+    uint16_t         change_count;
+    struct PPUChange change_log[PPU_CHANGE_LOG_SIZE];
+
+    // layer buffers of the line being drawn on this thread
+    struct PPULineBuffers line_buffers;
+
+    // BG/sprite merge and palette mapping, picked at startup from the host CPU features
+    compositor_fn compose;
 
-    // line buffer - Sprite - 160 pixels
-    // 2 bytes for each pixel:
-    // [0] = color index
-    // [1] = sprite index
-    uint8_t line_buffer_sprite[160][2];
+    // lines are also written here in final colors when output.pixels is set
+    struct PPUOutput output;
 
     // final line buffer
     uint8_t line_buffer[160];
@@ -258,31 +381,68 @@ struct PPU
     struct SpriteEntry** selected_oam_entries;
     // searched sprites
     uint8_t searched_sprite_count;
+    // OAM as parsed fields, and the sprites OAM search picks for every visible line.
+    // The bins are rebuilt on the next search after a Y/X change or an LCDC.2 flip
+    struct SpriteTable sprite_table;
+    uint8_t            line_sprite_count[SCREEN_HEIGHT];
+    uint8_t            line_sprites[SCREEN_HEIGHT][PPU_SPRITES_PER_LINE];
+    bool               sprite_bins_dirty;
+    uint8_t            sprite_bins_height;   // sprite height the bins were built for
     // Public method pointers
     void (*ppu_step)(struct PPU*, uint8_t cycles);
 };
 
 // Function declarations
-// render single scanline with given ly
+// render single scanline with given ly (queued on the render worker if there is one)
 void ppu_render_scanline_ly(struct PPU* self, uint8_t ly);
+// snapshot the registers and selected sprites line ly is drawn with
+void ppu_capture_line_state(struct PPU* self, uint8_t ly, struct PPULineState* state);
+// draw one scanline from a snapshot into out (160 shades), reads VRAM
+void ppu_render_line(struct PPU* self, struct PPULineBuffers* buffers,
+                     const struct PPULineState* state, uint8_t* out);
 // render full frame
 void ppu_render_full_frame(struct PPU* self);
 // helper functions for full frame rendering
-void ppu_render_background_scanline(struct PPU* self, uint8_t ly, uint8_t scx, uint8_t scy, 
-                                   uint16_t tile_map, uint16_t tile_data_base, bool signed_addressing, uint8_t bgp);
-void ppu_render_window_scanline(struct PPU* self, uint8_t ly, uint8_t wx, uint8_t wy,
-                               uint16_t tile_map, uint16_t tile_data_base, bool signed_addressing, uint8_t bgp);
-void ppu_render_sprites_scanline(struct PPU* self, uint8_t ly, uint8_t lcdc, uint8_t obp0, uint8_t obp1);
+void ppu_render_background_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                    uint8_t scx, uint8_t scy, uint16_t tile_map,
+                                    bool signed_addressing);
+void ppu_render_window_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                uint8_t wx, uint8_t wy, uint16_t tile_map,
+                                bool signed_addressing);
+void ppu_render_sprites_scanline(struct PPU* self, struct PPULineBuffers* buffers, uint8_t ly,
+                                 uint8_t lcdc, const struct SpriteEntry* sprites,
+                                 uint8_t sprite_count);
 // update STAT register
 void ppu_update_stat(struct PPU* self);
 // check if LCD is enabled
 bool ppu_is_lcd_enabled(struct PPU* self);
+// read an LCD register (0xFF40-0xFF4B except DMA)
+uint8_t ppu_read_register(struct PPU* self, uint16_t address);
+// write an LCD register: LY is read only, only STAT bits 3-6 are writable and clearing LCDC.7
+// turns the LCD off (LY 0, mode 0) until it is set again
+void ppu_write_register(struct PPU* self, uint16_t address, uint8_t byte);
 // create PPU
 struct PPU* create_ppu(struct Vram* vram);
-// attach mmu to ppu
+// record a write to an LCD register, VRAM or OAM, call before the write while deferred_frame
+void ppu_log_change(struct PPU* self, uint16_t address, uint8_t old_value, uint8_t new_value);
+// draw the lines of a deferred frame up to (excluding) end_line, replaying the change log
+void ppu_render_deferred_lines(struct PPU* self, uint8_t end_line);
+// attach mmu to ppu, installs the LCD register handlers
 void ppu_attach_mmu(struct PPU* self, struct MMU* mmu);
 // attach form to ppu
 void ppu_attach_form(struct PPU* self, struct Form* form);
+// attach a render worker, the PPU stops it and frees it on free_ppu
+void ppu_attach_render_worker(struct PPU* self, struct RenderWorker* worker);
+// attach a render pool, every frame is then deferred; the PPU frees it on free_ppu
+void ppu_attach_render_pool(struct PPU* self, struct RenderPool* pool);
+// write every drawn line into pixels as well, pitch in bytes; NULL pixels stops the output
+void ppu_set_output(struct PPU* self, void* pixels, int pitch, enum PPUOutputFormat format);
+// set the output colors (ARGB8888) of the first count palette entries
+void ppu_set_output_palette(struct PPU* self, const uint32_t* colors, int count);
+// attach scheduler to ppu, the first frame starts at the current cycle
+void ppu_attach_scheduler(struct PPU* self, struct Scheduler* scheduler);
+// EVENT_PPU callback: end the current stage and start the next one
+void ppu_handle_event(void* context, uint64_t deadline);
 // free PPU
 void free_ppu(struct PPU* ppu);
 // set mode
@@ -293,6 +453,12 @@ void ppu_set_ly(struct PPU* self, uint8_t ly);
 // PPU States
 // OAM Search   
 void    ppu_oam_search(struct PPU* self);
+// OAM Search for the given line instead of LY
+void    ppu_oam_search_line(struct PPU* self, uint8_t ly);
+// keep the sprite table in step with an OAM write, the caller stores the byte in OAM itself
+void    ppu_update_sprite_table(struct PPU* self, uint16_t address, uint8_t byte);
+// reparse the whole sprite table from OAM memory
+void    ppu_reload_sprite_table(struct PPU* self);
 // set mode
 void    ppu_set_mode(struct PPU* self, enum PPU_MODE mode);
 // reset interrupt registers
@@ -16,6 +16,8 @@ struct Registers* create_registers()
     registers->sp = &(registers->reg_control[SP]);
     registers->pc = &(registers->reg_control[PC]);
 
+    registers->lazy_flags.operation = FlagOperation_None;
+
     // set registers
     set_register_byte(registers, A, 0x01);
     set_register_byte(registers, F, 0xB0);
@@ -58,26 +60,25 @@ void free_registers(struct Registers* registers)
 
 uint8_t get_register_byte(struct Registers* registers, enum Register reg)
 {
-    REGISTER_TRACE_PRINT(
-        "GET_REGISTER_BYTE: reg: %d, value: 0x%02x\n", reg, registers->reg_primary[reg]);
-    return registers->reg_primary[reg];
+    uint8_t value = registers_get_byte(registers, reg);
+    REGISTER_TRACE_PRINT("GET_REGISTER_BYTE: reg: %d, value: 0x%02x\n", reg, value);
+    return value;
 }
 
 uint16_t get_register_pair(struct Registers* registers, enum RegisterPair reg_pair)
 {
+    uint16_t value = registers_get_pair(registers, reg_pair);
     REGISTER_TRACE_PRINT("GET_REGISTER_PAIR: reg_pair: %d, high_byte: 0x%02x, low_byte: 0x%02x\n",
                          reg_pair,
-                         registers->reg_primary[reg_pair << 1],
-                         registers->reg_primary[(reg_pair << 1) | 1]);
-    uint16_t high_byte = (registers->reg_primary[reg_pair << 1] << 8);
-    uint16_t low_byte  = registers->reg_primary[(reg_pair << 1) | 1];
-    return high_byte | low_byte;
+                         registers->reg_primary[REGISTER_PAIR_HIGH(reg_pair)],
+                         registers->reg_primary[REGISTER_PAIR_LOW(reg_pair)]);
+    return value;
 }
 
 void set_register_byte(struct Registers* registers, enum Register reg, uint8_t value)
 {
     REGISTER_TRACE_PRINT("SET_REGISTER_BYTE: reg: %d, value: 0x%02x\n", reg, value);
-    registers->reg_primary[reg] = value;
+    registers_set_byte(registers, reg, value);
 }
 
 void set_register_pair(struct Registers* registers, enum RegisterPair reg_pair, uint16_t value)
@@ -88,8 +89,7 @@ void set_register_pair(struct Registers* registers, enum RegisterPair reg_pair,
                          reg_pair,
                          high_byte,
                          low_byte);
-    registers->reg_primary[reg_pair << 1]       = high_byte;
-    registers->reg_primary[(reg_pair << 1) | 1] = low_byte;
+    registers_set_pair(registers, reg_pair, value);
 }
 
 uint16_t get_control_register(struct Registers* registers, enum ControlRegister reg)
@@ -108,8 +108,8 @@ void set_control_register(struct Registers* registers, enum ControlRegister reg,
 uint8_t get_flag(struct Registers* registers, enum Flag flag)
 {
     REGISTER_TRACE_PRINT(
-        "GET_FLAG: flag: %d, value: 0x%01x\n", flag, (registers->reg_primary[F] & flag) != 0);
-    return (registers->reg_primary[F] & flag) != 0;
+        "GET_FLAG: flag: %d, value: 0x%01x\n", flag, registers_get_flag(registers, flag));
+    return registers_get_flag(registers, flag);
 }
 
 bool get_flag_z(struct Registers* registers)
@@ -135,12 +135,7 @@ bool get_flag_c(struct Registers* registers)
 void set_flag(struct Registers* registers, enum Flag flag, bool value)
 {
     REGISTER_TRACE_PRINT("SET_FLAG: flag: %d, value: 0x%01x\n", flag, value);
-    if (value) {
-        registers->reg_primary[F] |= flag;   // Set flag
-    }
-    else {
-        registers->reg_primary[F] &= ~flag;   // Clear flag
-    }
+    registers_set_flag(registers, flag, value);
 }
 
 void set_flag_z(struct Registers* registers, bool value)
@@ -162,3 +157,41 @@ void set_flag_c(struct Registers* registers, bool value)
 {
     set_flag(registers, Flag_C, value);
 }
+
+void registers_materialize_flags(struct Registers* registers)
+{
+    struct LazyFlags* lazy   = &registers->lazy_flags;
+    uint8_t           result = lazy->result & 0xFF;
+    uint8_t           flags  = 0;
+    switch (lazy->operation) {
+    case FlagOperation_Add:
+        flags = (result == 0 ? Flag_Z : 0) |
+                ((lazy->operand_1 & 0x0F) + (lazy->operand_2 & 0x0F) + lazy->carry > 0x0F ? Flag_H
+                                                                                         : 0) |
+                (lazy->result > 0xFF ? Flag_C : 0);
+        break;
+    case FlagOperation_Sub:
+        flags = (result == 0 ? Flag_Z : 0) | Flag_N |
+                ((lazy->operand_1 & 0x0F) < (lazy->operand_2 & 0x0F) + lazy->carry ? Flag_H : 0) |
+                (lazy->operand_1 < lazy->operand_2 + lazy->carry ? Flag_C : 0);
+        break;
+    case FlagOperation_And: flags = (result == 0 ? Flag_Z : 0) | Flag_H; break;
+    case FlagOperation_Logic: flags = result == 0 ? Flag_Z : 0; break;
+    case FlagOperation_Inc:
+        flags = (result == 0 ? Flag_Z : 0) | ((lazy->operand_1 & 0x0F) == 0x0F ? Flag_H : 0) |
+                (lazy->carry ? Flag_C : 0);
+        break;
+    case FlagOperation_Dec:
+        flags = (result == 0 ? Flag_Z : 0) | Flag_N |
+                ((lazy->operand_1 & 0x0F) == 0x00 ? Flag_H : 0) | (lazy->carry ? Flag_C : 0);
+        break;
+    case FlagOperation_Shift:
+        flags = (result == 0 ? Flag_Z : 0) | (lazy->carry ? Flag_C : 0);
+        break;
+    case FlagOperation_RotateA: flags = lazy->carry ? Flag_C : 0; break;
+    case FlagOperation_None: return;
+    }
+    REGISTER_TRACE_PRINT("MATERIALIZE_FLAGS: operation: %d, flags: 0x%02x\n", lazy->operation, flags);
+    registers->reg_primary[F] = flags;
+    lazy->operation           = FlagOperation_None;
+}
@@ -72,6 +72,23 @@ enum RegisterPair
     HL = 0x03,
 };
 
+// The 8-bit registers are laid out so that reg_primary overlays reg_pair in host byte order:
+// the high byte of pair rp is reg_primary[REGISTER_PAIR_HIGH(rp)]
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+enum Register
+{
+    F = 0x00,
+    A = 0x01,
+    C = 0x02,
+    B = 0x03,
+    E = 0x04,
+    D = 0x05,
+    L = 0x06,
+    H = 0x07
+};
+#define REGISTER_PAIR_HIGH(rp) (((rp) << 1) | 1)
+#define REGISTER_PAIR_LOW(rp)  ((rp) << 1)
+#else
 enum Register
 {
     A = 0x00,
@@ -83,6 +100,9 @@ enum Register
     H = 0x06,
     L = 0x07
 };
+#define REGISTER_PAIR_HIGH(rp) ((rp) << 1)
+#define REGISTER_PAIR_LOW(rp)  (((rp) << 1) | 1)
+#endif
 
 enum ControlRegister
 {
@@ -106,13 +126,48 @@ enum Flag
     Flag_C = 0x10
 };
 
+// Lazy flags
+// ALU instructions record their operands, result and kind instead of computing Z/N/H/C.
+// F is rebuilt by registers_materialize_flags only when something reads it (conditional jumps,
+// carry-in, PUSH AF, DAA or an explicit F read through the accessors below).
+// Build with -DREGISTER_EAGER_FLAGS to materialize on every record, e.g. when debugging.
+enum FlagOperation
+{
+    FlagOperation_None = 0x00,   // F is up to date
+    FlagOperation_Add,           // ADD, ADC: Z 0 H C
+    FlagOperation_Sub,           // SUB, SBC, CP: Z 1 H C
+    FlagOperation_And,           // AND: Z 0 1 0
+    FlagOperation_Logic,         // XOR, OR: Z 0 0 0
+    FlagOperation_Inc,           // INC: Z 0 H -
+    FlagOperation_Dec,           // DEC: Z 1 H -
+    FlagOperation_Shift,         // CB rotates and shifts: Z 0 0 C
+    FlagOperation_RotateA        // RLCA, RLA, RRCA, RRA: 0 0 0 C
+};
+
+struct LazyFlags
+{
+    enum FlagOperation operation;
+    uint8_t            operand_1;
+    uint8_t            operand_2;
+    // Carry in for ADD/SUB, carry out for shifts and rotates, previous C for INC/DEC
+    uint8_t  carry;
+    uint16_t result;
+};
+
 // Register structure
 struct Registers
 {
-    // CPU 8-bit registers array [A, F, B, C, D, E, H, L]
-    uint8_t reg_primary[8];
+    union
+    {
+        // CPU 8-bit registers array, indexed by enum Register
+        uint8_t reg_primary[8];
+        // 16-bit view of the same storage [AF, BC, DE, HL]
+        uint16_t reg_pair[4];
+    };
     // CPU special registers array [SP, PC]
     uint16_t reg_control[2];
+    // Pending flag computation, F is stale while operation is not FlagOperation_None
+    struct LazyFlags lazy_flags;
 
     // pointer for quick access
     uint8_t*  a;
@@ -166,4 +221,110 @@ void    set_flag_n(struct Registers* registers, bool value);
 void    set_flag_h(struct Registers* registers, bool value);
 void    set_flag_c(struct Registers* registers, bool value);
 
+// lazy flags methods
+void registers_materialize_flags(struct Registers* registers);
+
+static inline void registers_record_flags(struct Registers* registers,
+                                          enum FlagOperation operation, uint8_t operand_1,
+                                          uint8_t operand_2, uint8_t carry, uint16_t result)
+{
+    registers->lazy_flags.operation = operation;
+    registers->lazy_flags.operand_1 = operand_1;
+    registers->lazy_flags.operand_2 = operand_2;
+    registers->lazy_flags.carry     = carry;
+    registers->lazy_flags.result    = result;
+#ifdef REGISTER_EAGER_FLAGS
+    registers_materialize_flags(registers);
+#endif
+}
+
+static inline void registers_sync_flags(struct Registers* registers)
+{
+    if (registers->lazy_flags.operation != FlagOperation_None) {
+        registers_materialize_flags(registers);
+    }
+}
+
+// C as the pending operation leaves it, without materializing the other flags
+static inline bool registers_get_carry(struct Registers* registers)
+{
+    struct LazyFlags* lazy = &registers->lazy_flags;
+    switch (lazy->operation) {
+    case FlagOperation_None: return (registers->reg_primary[F] & Flag_C) != 0;
+    case FlagOperation_Add: return lazy->result > 0xFF;
+    case FlagOperation_Sub: return lazy->operand_1 < lazy->operand_2 + lazy->carry;
+    case FlagOperation_And:
+    case FlagOperation_Logic: return false;
+    case FlagOperation_Inc:
+    case FlagOperation_Dec:
+    case FlagOperation_Shift:
+    case FlagOperation_RotateA: return lazy->carry != 0;
+    }
+    return false;
+}
+
+// Direct accessors for the CPU hot path
+// Same semantics as the methods above, without the indirect call and trace print.
+// Code reading reg_primary[F] directly must call registers_sync_flags first.
+static inline uint8_t registers_get_byte(struct Registers* registers, enum Register reg)
+{
+    if (reg == F) {
+        registers_sync_flags(registers);
+    }
+    return registers->reg_primary[reg];
+}
+
+static inline void registers_set_byte(struct Registers* registers, enum Register reg, uint8_t value)
+{
+    if (reg == F) {
+        registers->lazy_flags.operation = FlagOperation_None;
+    }
+    registers->reg_primary[reg] = value;
+}
+
+static inline uint16_t registers_get_pair(struct Registers* registers, enum RegisterPair reg_pair)
+{
+    if (reg_pair == AF) {
+        registers_sync_flags(registers);
+    }
+    return registers->reg_pair[reg_pair];
+}
+
+static inline void registers_set_pair(struct Registers* registers, enum RegisterPair reg_pair,
+                                      uint16_t value)
+{
+    if (reg_pair == AF) {
+        registers->lazy_flags.operation = FlagOperation_None;
+    }
+    registers->reg_pair[reg_pair] = value;
+}
+
+static inline uint16_t registers_get_control(struct Registers* registers, enum ControlRegister reg)
+{
+    return registers->reg_control[reg];
+}
+
+static inline void registers_set_control(struct Registers* registers, enum ControlRegister reg,
+                                         uint16_t value)
+{
+    registers->reg_control[reg] = value;
+}
+
+static inline bool registers_get_flag(struct Registers* registers, enum Flag flag)
+{
+    registers_sync_flags(registers);
+    return (registers->reg_primary[F] & flag) != 0;
+}
+
+static inline void registers_set_flag(struct Registers* registers, enum Flag flag, bool value)
+{
+    registers_sync_flags(registers);
+    if (value) {
+        registers->reg_primary[F] |= flag;
+    }
+    else {
+        registers->reg_primary[F] &= ~flag;
+    }
+}
+
 #endif
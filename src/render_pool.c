@@ -0,0 +1,149 @@
+#include "render_pool.h"
+
+// Claim and draw chunks of the current batch until none are left
+static void render_pool_drain(struct RenderPool* pool, struct PPULineBuffers* buffers)
+{
+    while (true) {
+        int first = atomic_fetch_add(&pool->next_state, RENDER_POOL_CHUNK_LINES);
+        if (first >= pool->state_count) {
+            return;
+        }
+        int last = first + RENDER_POOL_CHUNK_LINES;
+        if (last > pool->state_count) {
+            last = pool->state_count;
+        }
+        for (int index = first; index < last; index++) {
+            const struct PPULineState* state = &pool->states[index];
+            uint8_t*                   out   = pool->framebuffer + state->ly * SCREEN_WIDTH;
+            ppu_render_line(pool->ppu, buffers, state, out);
+        }
+    }
+}
+
+struct RenderPoolHelper
+{
+    struct RenderPool* pool;
+    int                index;
+};
+
+static void* render_pool_main(void* context)
+{
+    struct RenderPool* pool  = ((struct RenderPoolHelper*)context)->pool;
+    int                index = ((struct RenderPoolHelper*)context)->index;
+    unsigned int       batch = 0;
+    free(context);
+
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (pool->running && pool->batch == batch) {
+            pthread_cond_wait(&pool->batch_posted, &pool->lock);
+        }
+        if (!pool->running) {
+            break;
+        }
+        batch = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+
+        render_pool_drain(pool, &pool->line_buffers[index]);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->busy_helpers -= 1;
+        if (pool->busy_helpers == 0) {
+            pthread_cond_signal(&pool->batch_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+void render_pool_draw(struct RenderPool* pool, const struct PPULineState* states, int state_count,
+                      uint8_t* framebuffer)
+{
+    if (state_count == 0) {
+        return;
+    }
+    // helpers must not race each other decoding the same tile or redrawing the same layer
+    vram_decode_dirty_tiles(pool->ppu->vram);
+    vram_update_layers(pool->ppu->vram);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->states       = states;
+    pool->state_count  = state_count;
+    pool->framebuffer  = framebuffer;
+    pool->busy_helpers = pool->helper_count;
+    pool->batch       += 1;
+    atomic_store(&pool->next_state, 0);
+    pthread_cond_broadcast(&pool->batch_posted);
+    pthread_mutex_unlock(&pool->lock);
+
+    render_pool_drain(pool, &pool->line_buffers[pool->thread_count - 1]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy_helpers > 0) {
+        pthread_cond_wait(&pool->batch_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+struct RenderPool* create_render_pool(struct PPU* ppu, int thread_count)
+{
+    if (thread_count < 2 || thread_count > RENDER_POOL_MAX_THREADS) {
+        return NULL;
+    }
+    struct RenderPool* pool = (struct RenderPool*)malloc(sizeof(struct RenderPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->ppu          = ppu;
+    pool->thread_count = thread_count;
+    pool->helper_count = 0;
+    pool->states       = NULL;
+    pool->state_count  = 0;
+    pool->framebuffer  = NULL;
+    pool->batch        = 0;
+    pool->busy_helpers = 0;
+    pool->running      = true;
+    atomic_init(&pool->next_state, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->batch_posted, NULL);
+    pthread_cond_init(&pool->batch_done, NULL);
+
+    // the calling thread is the last one
+    for (int index = 0; index < thread_count - 1; index++) {
+        struct RenderPoolHelper* helper = malloc(sizeof(struct RenderPoolHelper));
+        if (helper == NULL) {
+            break;
+        }
+        helper->pool  = pool;
+        helper->index = index;
+        if (pthread_create(&pool->helpers[index], NULL, render_pool_main, helper) != 0) {
+            free(helper);
+            break;
+        }
+        pool->helper_count += 1;
+    }
+    if (pool->helper_count != thread_count - 1) {
+        free_render_pool(pool);
+        return NULL;
+    }
+    RENDER_POOL_DEBUG_PRINT("Render pool started with %d threads\n", thread_count);
+    return pool;
+}
+
+void free_render_pool(struct RenderPool* pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->running = false;
+    pthread_cond_broadcast(&pool->batch_posted);
+    pthread_mutex_unlock(&pool->lock);
+    for (int index = 0; index < pool->helper_count; index++) {
+        pthread_join(pool->helpers[index], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->batch_posted);
+    pthread_cond_destroy(&pool->batch_done);
+    free(pool);
+}
@@ -0,0 +1,65 @@
+#ifndef GAMEBOY_RENDER_POOL_H
+#define GAMEBOY_RENDER_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "general.h"
+#include "ppu.h"
+
+extern struct EmulatorConfig config;
+
+// Render pool debug print
+#define RENDER_POOL_DEBUG_PRINT(fmt, ...)                           \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("RDP: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+// Most threads a pool is created with, the calling thread included
+#define RENDER_POOL_MAX_THREADS 16
+// Lines a thread claims at a time
+#define RENDER_POOL_CHUNK_LINES 8
+
+// Draws a batch of captured lines with several threads at once.
+// The calling thread draws too, so a pool of N threads starts N - 1 helpers. Helpers sleep until
+// a batch is posted, claim RENDER_POOL_CHUNK_LINES lines at a time and draw them with their own
+// line buffers. VRAM and its caches are only read during a batch: dirty tiles and layers are
+// brought up to date before the helpers are woken up, and render_pool_draw returns once every
+// line is drawn.
+struct RenderPool
+{
+    struct PPU* ppu;
+    int         thread_count;   // helpers + the calling thread
+    int         helper_count;
+    pthread_t   helpers[RENDER_POOL_MAX_THREADS - 1];
+
+    // line buffers of each thread, the calling thread uses the last one
+    struct PPULineBuffers line_buffers[RENDER_POOL_MAX_THREADS];
+
+    // current batch
+    const struct PPULineState* states;
+    int                        state_count;
+    uint8_t*                   framebuffer;
+    atomic_int                 next_state;   // first line not claimed yet
+
+    // batch hand off, protected by lock
+    pthread_mutex_t lock;
+    pthread_cond_t  batch_posted;
+    pthread_cond_t  batch_done;
+    unsigned int    batch;          // batches posted so far
+    int             busy_helpers;   // helpers still drawing the current batch
+    bool            running;
+};
+
+// create a pool of thread_count threads (2 - RENDER_POOL_MAX_THREADS, the caller included)
+struct RenderPool* create_render_pool(struct PPU* ppu, int thread_count);
+// stop and join the helpers
+void free_render_pool(struct RenderPool* pool);
+// draw the lines in states into framebuffer, returns when all of them are drawn
+void render_pool_draw(struct RenderPool* pool, const struct PPULineState* states, int state_count,
+                      uint8_t* framebuffer);
+
+#endif
@@ -0,0 +1,113 @@
+#include "render_worker.h"
+
+static void render_worker_draw(struct RenderWorker* worker, const struct PPULineState* job)
+{
+    if (job->ly != RENDER_WORKER_FRAME_END) {
+        ppu_render_line(worker->ppu, &worker->line_buffers, job,
+                        worker->back_buffer + job->ly * SCREEN_WIDTH);
+        return;
+    }
+    // the finished frame goes on screen, the next one is drawn over the previous front buffer
+    uint8_t* finished        = worker->back_buffer;
+    worker->back_buffer      = worker->ppu->framebuffer;
+    worker->ppu->framebuffer = finished;
+}
+
+static void* render_worker_main(void* context)
+{
+    struct RenderWorker* worker = (struct RenderWorker*)context;
+    while (true) {
+        unsigned int tail = atomic_load_explicit(&worker->tail, memory_order_relaxed);
+        if (tail != atomic_load(&worker->head)) {
+            render_worker_draw(worker, &worker->jobs[tail & RENDER_WORKER_RING_MASK]);
+            atomic_store_explicit(&worker->tail, tail + 1, memory_order_release);
+            continue;
+        }
+        if (!atomic_load(&worker->running)) {
+            break;
+        }
+        // ring is empty: announce the nap, then look again so a push in between is not missed
+        pthread_mutex_lock(&worker->lock);
+        atomic_store(&worker->sleeping, true);
+        if (tail == atomic_load(&worker->head) && atomic_load(&worker->running)) {
+            pthread_cond_wait(&worker->wake_up, &worker->lock);
+        }
+        atomic_store(&worker->sleeping, false);
+        pthread_mutex_unlock(&worker->lock);
+    }
+    return NULL;
+}
+
+static void render_worker_wake(struct RenderWorker* worker)
+{
+    if (atomic_load(&worker->sleeping)) {
+        pthread_mutex_lock(&worker->lock);
+        pthread_cond_signal(&worker->wake_up);
+        pthread_mutex_unlock(&worker->lock);
+    }
+}
+
+void render_worker_push(struct RenderWorker* worker, const struct PPULineState* state)
+{
+    unsigned int head = atomic_load_explicit(&worker->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&worker->tail, memory_order_acquire) ==
+           RENDER_WORKER_RING_SIZE) {
+        sched_yield();
+    }
+    worker->jobs[head & RENDER_WORKER_RING_MASK] = *state;
+    atomic_store(&worker->head, head + 1);
+    render_worker_wake(worker);
+}
+
+void render_worker_end_frame(struct RenderWorker* worker)
+{
+    struct PPULineState frame_end = {.ly = RENDER_WORKER_FRAME_END};
+    render_worker_push(worker, &frame_end);
+}
+
+struct RenderWorker* create_render_worker(struct PPU* ppu)
+{
+    struct RenderWorker* worker = (struct RenderWorker*)malloc(sizeof(struct RenderWorker));
+    if (worker == NULL) {
+        return NULL;
+    }
+    worker->ppu         = ppu;
+    worker->back_buffer = (uint8_t*)malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint8_t));
+    if (worker->back_buffer == NULL) {
+        free(worker);
+        return NULL;
+    }
+    memcpy(worker->back_buffer, ppu->framebuffer, SCREEN_WIDTH * SCREEN_HEIGHT);
+    atomic_init(&worker->head, 0);
+    atomic_init(&worker->tail, 0);
+    atomic_init(&worker->sleeping, false);
+    atomic_init(&worker->running, true);
+    pthread_mutex_init(&worker->lock, NULL);
+    pthread_cond_init(&worker->wake_up, NULL);
+    if (pthread_create(&worker->thread, NULL, render_worker_main, worker) != 0) {
+        pthread_mutex_destroy(&worker->lock);
+        pthread_cond_destroy(&worker->wake_up);
+        free(worker->back_buffer);
+        free(worker);
+        return NULL;
+    }
+    RENDER_WORKER_DEBUG_PRINT("Render worker started%s", "\n");
+    return worker;
+}
+
+void free_render_worker(struct RenderWorker* worker)
+{
+    if (worker == NULL) {
+        return;
+    }
+    atomic_store(&worker->running, false);
+    pthread_mutex_lock(&worker->lock);
+    pthread_cond_signal(&worker->wake_up);
+    pthread_mutex_unlock(&worker->lock);
+    pthread_join(worker->thread, NULL);
+    pthread_mutex_destroy(&worker->lock);
+    pthread_cond_destroy(&worker->wake_up);
+    free(worker->back_buffer);
+    free(worker);
+    RENDER_WORKER_DEBUG_PRINT("Render worker stopped%s", "\n");
+}
@@ -0,0 +1,71 @@
+#ifndef GAMEBOY_RENDER_WORKER_H
+#define GAMEBOY_RENDER_WORKER_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "general.h"
+#include "ppu.h"
+
+extern struct EmulatorConfig config;
+
+// Render worker debug print
+#define RENDER_WORKER_DEBUG_PRINT(fmt, ...)                         \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("RDW: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+// Scanline jobs in flight, a whole frame fits without the producer waiting
+#define RENDER_WORKER_RING_SIZE 256
+#define RENDER_WORKER_RING_MASK (RENDER_WORKER_RING_SIZE - 1)
+
+// Job line number that marks the end of a frame: swap the framebuffers
+#define RENDER_WORKER_FRAME_END 0xFF
+
+// Draws scanlines on its own thread while the emulation thread runs ahead.
+// The emulation thread is the only producer and the worker the only consumer of the ring, so
+// head and tail are plain atomics. VRAM is shared: whoever writes VRAM (or replays VRAM changes)
+// calls render_worker_sync first so the worker never reads it mid-change. Everything else a line
+// needs (registers, selected sprites) travels in the job.
+struct RenderWorker
+{
+    struct PPU* ppu;
+    pthread_t   thread;
+
+    struct PPULineState jobs[RENDER_WORKER_RING_SIZE];
+    atomic_uint         head;   // next job the emulation thread writes
+    atomic_uint         tail;   // next job the worker draws
+
+    // lines are drawn here, swapped with ppu->framebuffer at the end of each frame
+    uint8_t*              back_buffer;
+    struct PPULineBuffers line_buffers;
+
+    // the worker sleeps on wake_up when the ring is empty
+    pthread_mutex_t lock;
+    pthread_cond_t  wake_up;
+    atomic_bool     sleeping;
+    atomic_bool     running;
+};
+
+// create the worker and start its thread, NULL if either fails
+struct RenderWorker* create_render_worker(struct PPU* ppu);
+// stop and join the thread, drawing whatever is still queued first
+void free_render_worker(struct RenderWorker* worker);
+// queue a scanline, waits while the ring is full
+void render_worker_push(struct RenderWorker* worker, const struct PPULineState* state);
+// queue the end of the frame, ppu->framebuffer shows it once the worker gets there
+void render_worker_end_frame(struct RenderWorker* worker);
+// wait until every queued job has been drawn
+static inline void render_worker_sync(struct RenderWorker* worker)
+{
+    unsigned int head = atomic_load_explicit(&worker->head, memory_order_relaxed);
+    while (atomic_load_explicit(&worker->tail, memory_order_acquire) != head) {
+        sched_yield();
+    }
+}
+
+#endif
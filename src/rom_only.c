@@ -0,0 +1,19 @@
+#include "cartridge.h"
+
+// No MBC: 32KB of ROM in two fixed banks, nothing to switch
+
+static void rom_only_write_ctrl(struct Cartridge* cartridge, uint16_t address, uint8_t byte)
+{
+    (void)cartridge;
+    CARTRIDGE_TRACE_PRINT("ROM: Ignoring write to 0x%04x = 0x%02x\n", address, byte);
+}
+
+const struct Mapper mapper_rom_only = {
+    .name       = "ROM",
+    .read_rom   = mapper_read_rom,
+    .read_ram   = mapper_read_ram,
+    .write_ctrl = rom_only_write_ctrl,
+    .write_ram  = mapper_write_ram,
+    .save       = mapper_save_ram,
+    .load       = mapper_load_ram,
+};
@@ -0,0 +1,91 @@
+#include "scheduler.h"
+
+static void scheduler_update_next_deadline(struct Scheduler* scheduler)
+{
+    uint64_t next = SCHEDULER_NEVER;
+    for (int event = 0; event < SCHEDULER_EVENT_COUNT; event++) {
+        if (scheduler->deadline[event] < next) {
+            next = scheduler->deadline[event];
+        }
+    }
+    scheduler->next_deadline = next;
+}
+
+struct Scheduler* create_scheduler(void)
+{
+    struct Scheduler* scheduler = (struct Scheduler*)malloc(sizeof(struct Scheduler));
+    if (scheduler == NULL) {
+        return NULL;
+    }
+    scheduler->now           = 0;
+    scheduler->next_deadline = SCHEDULER_NEVER;
+    for (int event = 0; event < SCHEDULER_EVENT_COUNT; event++) {
+        scheduler->deadline[event] = SCHEDULER_NEVER;
+        scheduler->callback[event] = NULL;
+        scheduler->context[event]  = NULL;
+    }
+    return scheduler;
+}
+
+void free_scheduler(struct Scheduler* scheduler)
+{
+    if (scheduler) {
+        free(scheduler);
+    }
+}
+
+void scheduler_register(struct Scheduler* scheduler, enum SchedulerEvent event,
+                        scheduler_callback_fn callback, void* context)
+{
+    SCHEDULER_DEBUG_PRINT("Registering event %d\n", event);
+    scheduler->callback[event] = callback;
+    scheduler->context[event]  = context;
+}
+
+void scheduler_schedule_at(struct Scheduler* scheduler, enum SchedulerEvent event,
+                           uint64_t deadline)
+{
+    SCHEDULER_TRACE_PRINT("Scheduling event %d at cycle %lu\n", event, (unsigned long)deadline);
+    uint64_t previous          = scheduler->deadline[event];
+    scheduler->deadline[event] = deadline;
+    if (deadline < scheduler->next_deadline) {
+        scheduler->next_deadline = deadline;
+    }
+    else if (previous == scheduler->next_deadline) {
+        // the event was the earliest one and moved later
+        scheduler_update_next_deadline(scheduler);
+    }
+}
+
+void scheduler_schedule_in(struct Scheduler* scheduler, enum SchedulerEvent event,
+                           uint64_t cycles)
+{
+    scheduler_schedule_at(scheduler, event, scheduler->now + cycles);
+}
+
+void scheduler_cancel(struct Scheduler* scheduler, enum SchedulerEvent event)
+{
+    scheduler_schedule_at(scheduler, event, SCHEDULER_NEVER);
+}
+
+void scheduler_dispatch(struct Scheduler* scheduler)
+{
+    while (scheduler->next_deadline <= scheduler->now) {
+        // find the earliest due event, lower index wins ties
+        int event = 0;
+        while (scheduler->deadline[event] != scheduler->next_deadline) {
+            event++;
+        }
+        uint64_t deadline          = scheduler->deadline[event];
+        scheduler->deadline[event] = SCHEDULER_NEVER;
+        scheduler_update_next_deadline(scheduler);
+
+        SCHEDULER_TRACE_PRINT("Firing event %d (deadline %lu, now %lu)\n",
+                              event,
+                              (unsigned long)deadline,
+                              (unsigned long)scheduler->now);
+        if (scheduler->callback[event]) {
+            scheduler->callback[event](scheduler->context[event], deadline);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef GAMEBOY_SCHEDULER_H
+#define GAMEBOY_SCHEDULER_H
+
+#include "general.h"
+
+extern struct EmulatorConfig config;
+
+// Scheduler debug print
+#define SCHEDULER_DEBUG_PRINT(fmt, ...)                             \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("SCHED: ");                                          \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+#define SCHEDULER_TRACE_PRINT(fmt, ...)                             \
+    if (config.debug_mode && config.verbose_level >= TRACE_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(TRACE_LEVEL);                                   \
+        printf("SCHED: ");                                          \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+// Deadline of an event that is not scheduled
+#define SCHEDULER_NEVER UINT64_MAX
+
+// Scheduler
+// One absolute cycle counter shared by every device, plus one deadline slot per event source.
+// The CPU runs until the earliest deadline, then the due events are fired in deadline order.
+// There are only a handful of sources, so a small array with a cached minimum beats a heap.
+enum SchedulerEvent
+{
+    EVENT_PPU                 = 0x00,   // PPU mode transitions and LY increments
+    EVENT_TIMER               = 0x01,   // TIMA overflow
+    EVENT_SERIAL              = 0x02,   // serial transfer complete
+    EVENT_DMA                 = 0x03,   // OAM DMA end
+    EVENT_APU_FRAME_SEQUENCER = 0x04,   // 512 Hz APU frame sequencer tick
+    SCHEDULER_EVENT_COUNT     = 0x05
+};
+
+// context is the pointer given to scheduler_register
+// deadline is the cycle the event was scheduled for, schedule follow-ups relative to it so
+// instruction overshoot does not accumulate
+typedef void (*scheduler_callback_fn)(void* context, uint64_t deadline);
+
+struct Scheduler
+{
+    // current cycle, advanced by the CPU
+    uint64_t now;
+    // earliest deadline in the table, SCHEDULER_NEVER if nothing is scheduled
+    uint64_t next_deadline;
+
+    uint64_t              deadline[SCHEDULER_EVENT_COUNT];
+    scheduler_callback_fn callback[SCHEDULER_EVENT_COUNT];
+    void*                 context[SCHEDULER_EVENT_COUNT];
+};
+
+// create scheduler
+struct Scheduler* create_scheduler(void);
+// free scheduler
+void free_scheduler(struct Scheduler* scheduler);
+// set the callback of an event source
+void scheduler_register(struct Scheduler* scheduler, enum SchedulerEvent event,
+                        scheduler_callback_fn callback, void* context);
+// schedule (or move) an event to an absolute cycle
+void scheduler_schedule_at(struct Scheduler* scheduler, enum SchedulerEvent event,
+                           uint64_t deadline);
+// schedule (or move) an event to a number of cycles from now
+void scheduler_schedule_in(struct Scheduler* scheduler, enum SchedulerEvent event,
+                           uint64_t cycles);
+// unschedule an event
+void scheduler_cancel(struct Scheduler* scheduler, enum SchedulerEvent event);
+// fire every event whose deadline has passed
+void scheduler_dispatch(struct Scheduler* scheduler);
+
+// cycles left until the earliest deadline, 0 if an event is already due
+static inline uint64_t scheduler_cycles_until_next_event(struct Scheduler* scheduler)
+{
+    if (scheduler->next_deadline <= scheduler->now) {
+        return 0;
+    }
+    return scheduler->next_deadline - scheduler->now;
+}
+
+#endif
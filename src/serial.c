@@ -0,0 +1,135 @@
+#include "serial.h"
+#include "mmu.h"
+
+struct Serial* create_serial(void)
+{
+    struct Serial* serial = (struct Serial*)malloc(sizeof(struct Serial));
+    if (serial == NULL) {
+        return NULL;
+    }
+    serial->buffer = (char*)malloc(SERIAL_BUFFER_SIZE);
+    if (serial->buffer == NULL) {
+        free(serial);
+        return NULL;
+    }
+    serial->reg_sb          = 0x00;
+    serial->reg_sc          = 0x00;
+    serial->transfer_byte   = 0x00;
+    serial->buffer_length   = 0;
+    serial->buffer_capacity = SERIAL_BUFFER_SIZE;
+    serial->print_output    = false;
+    serial->mmu             = NULL;
+    serial->scheduler       = NULL;
+    return serial;
+}
+
+void free_serial(struct Serial* serial)
+{
+    if (serial) {
+        serial_flush(serial);
+        free(serial->buffer);
+        free(serial);
+    }
+}
+
+void serial_flush(struct Serial* serial)
+{
+    if (serial->print_output && serial->buffer_length) {
+        fwrite(serial->buffer, 1, serial->buffer_length, stdout);
+        fflush(stdout);
+    }
+    serial->buffer_length = 0;
+}
+
+// Make room for one more byte: print a full buffer, or double it while nothing is printed
+static bool serial_reserve(struct Serial* serial)
+{
+    if (serial->buffer_length < serial->buffer_capacity) {
+        return true;
+    }
+    if (serial->print_output) {
+        serial_flush(serial);
+        return true;
+    }
+    char* buffer = (char*)realloc(serial->buffer, serial->buffer_capacity * 2);
+    if (buffer == NULL) {
+        SERIAL_DEBUG_PRINT("Failed to grow output buffer, byte dropped\n");
+        return false;
+    }
+    serial->buffer          = buffer;
+    serial->buffer_capacity = serial->buffer_capacity * 2;
+    return true;
+}
+
+static void serial_complete_transfer(struct Serial* serial)
+{
+    SERIAL_TRACE_PRINT("Transfer complete: 0x%02X\n", serial->transfer_byte);
+    if (serial_reserve(serial)) {
+        serial->buffer[serial->buffer_length++] = (char)serial->transfer_byte;
+    }
+    if (serial->print_output && serial->transfer_byte == '\n') {
+        serial_flush(serial);
+    }
+
+    // nothing on the other end of the cable
+    serial->reg_sb = 0xFF;
+    serial->reg_sc &= ~SERIAL_SC_TRANSFER_START;
+    if (serial->mmu) {
+        mmu_request_interrupt(serial->mmu, INT_SERIAL);
+    }
+}
+
+uint8_t serial_read_register(struct Serial* serial, uint16_t address)
+{
+    if (address == SERIAL_SB_ADDRESS) {
+        return serial->reg_sb;
+    }
+    return serial->reg_sc | SERIAL_SC_UNUSED_BITS;
+}
+
+void serial_write_register(struct Serial* serial, uint16_t address, uint8_t byte)
+{
+    if (address == SERIAL_SB_ADDRESS) {
+        serial->reg_sb = byte;
+        return;
+    }
+    serial->reg_sc = byte & (SERIAL_SC_TRANSFER_START | SERIAL_SC_INTERNAL_CLOCK);
+    if ((byte & (SERIAL_SC_TRANSFER_START | SERIAL_SC_INTERNAL_CLOCK)) !=
+        (SERIAL_SC_TRANSFER_START | SERIAL_SC_INTERNAL_CLOCK)) {
+        // stopped, or waiting for an external clock that never comes
+        if (serial->scheduler) {
+            scheduler_cancel(serial->scheduler, EVENT_SERIAL);
+        }
+        return;
+    }
+    serial->transfer_byte = serial->reg_sb;
+    if (serial->scheduler == NULL) {
+        serial_complete_transfer(serial);
+        return;
+    }
+    scheduler_schedule_in(serial->scheduler, EVENT_SERIAL, SERIAL_TRANSFER_CYCLES);
+}
+
+void serial_handle_event(void* context, uint64_t deadline)
+{
+    (void)deadline;
+    serial_complete_transfer((struct Serial*)context);
+}
+
+void serial_attach_scheduler(struct Serial* serial, struct Scheduler* scheduler)
+{
+    serial->scheduler = scheduler;
+    scheduler_register(scheduler, EVENT_SERIAL, serial_handle_event, serial);
+}
+
+void serial_set_print_output(struct Serial* serial, bool print_output)
+{
+    SERIAL_DEBUG_PRINT("Serial output enabled: %d\n", print_output);
+    serial->print_output = print_output;
+}
+
+const char* serial_get_output(struct Serial* serial, size_t* length)
+{
+    *length = serial->buffer_length;
+    return serial->buffer;
+}
@@ -0,0 +1,83 @@
+#ifndef GAMEBOY_SERIAL_H
+#define GAMEBOY_SERIAL_H
+
+#include "general.h"
+#include "scheduler.h"
+
+extern struct EmulatorConfig config;
+
+// Serial debug print
+#define SERIAL_DEBUG_PRINT(fmt, ...)                                \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("SER: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+#define SERIAL_TRACE_PRINT(fmt, ...)                                \
+    if (config.debug_mode && config.verbose_level >= TRACE_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(TRACE_LEVEL);                                   \
+        printf("SER: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+// SC bits
+#define SERIAL_SC_TRANSFER_START  0x80
+#define SERIAL_SC_INTERNAL_CLOCK  0x01
+// SC bits 1-6 are unused and read back as 1
+#define SERIAL_SC_UNUSED_BITS     0x7E
+
+// Internal clock is 8192 Hz, one bit per tick: 8 bits take 4096 cycles
+#define SERIAL_TRANSFER_CYCLES 4096
+
+// Initial capacity of the captured output. It is flushed to stdout in bulk when printing is
+// enabled and grows otherwise, so nothing is dropped before it has been printed
+#define SERIAL_BUFFER_SIZE 4096
+
+struct MMU;
+
+// Serial port
+// There is no link partner: every transfer shifts in 0xFF.
+// A transfer started with the internal clock completes after SERIAL_TRANSFER_CYCLES and raises
+// INT_SERIAL, a transfer waiting on the external clock never completes.
+struct Serial
+{
+    uint8_t reg_sb;   // serial transfer data ff01
+    uint8_t reg_sc;   // serial transfer control ff02
+
+    // byte shifted out by the transfer in progress
+    uint8_t transfer_byte;
+
+    // every byte sent since the last flush, in order
+    char*  buffer;
+    size_t buffer_length;
+    size_t buffer_capacity;
+    // write the buffer to stdout on newline, when full and on free
+    bool print_output;
+
+    struct MMU*       mmu;
+    struct Scheduler* scheduler;
+};
+
+// create serial port
+struct Serial* create_serial(void);
+// free serial port, flushes pending output
+void free_serial(struct Serial* serial);
+// read SB/SC
+uint8_t serial_read_register(struct Serial* serial, uint16_t address);
+// write SB/SC, a write to SC with bit 7 and the internal clock set starts a transfer
+void serial_write_register(struct Serial* serial, uint16_t address, uint8_t byte);
+// EVENT_SERIAL callback
+void serial_handle_event(void* context, uint64_t deadline);
+// Attach scheduler, without one transfers complete instantly
+void serial_attach_scheduler(struct Serial* serial, struct Scheduler* scheduler);
+// Print bytes sent so far to stdout
+void serial_set_print_output(struct Serial* serial, bool print_output);
+// Bytes sent since the last flush, not NUL terminated
+const char* serial_get_output(struct Serial* serial, size_t* length);
+// Write the captured output to stdout if printing is enabled, then empty the buffer
+void serial_flush(struct Serial* serial);
+
+#endif
@@ -1,63 +1,133 @@
 #include "timer.h"
+#include "mmu.h"
 
-void timer_add_time(struct Timer* self, uint8_t cycle)
+// System counter bit whose falling edge clocks TIMA
+static uint8_t timer_get_clock_bit(struct Timer* self)
 {
-    timer_refresh_register(self);
-
-    self->divider += cycle;
-    if (self->divider >= 256) {
-        self->divider -= 256;
-        self->reg_div++;
+    switch (self->reg_tac & TIMER_TAC_CLOCK_MASK) {
+    case 0: return 7;    // 00: Every 256 cycles (4096 Hz)
+    case 1: return 1;    // 01: Every 4 cycles (262144 Hz)
+    case 2: return 3;    // 10: Every 16 cycles (65536 Hz)
+    default: return 5;   // 11: Every 64 cycles (16384 Hz)
     }
+}
 
-    if ((self->reg_tac & 0x04) == 0) {   // timer enabled?
-        return;
+static uint64_t timer_now(struct Timer* self)
+{
+    return self->scheduler ? self->scheduler->now : 0;
+}
+
+// Cycles since the last DIV reset, not wrapped: every TIMA period divides 0x10000
+static uint64_t timer_system_counter(struct Timer* self, uint64_t cycle)
+{
+    return cycle - self->div_base;
+}
+
+// Level of the signal whose falling edges clock TIMA
+static bool timer_clock_signal(struct Timer* self, uint64_t cycle)
+{
+    if ((self->reg_tac & TIMER_TAC_ENABLE) == 0) {
+        return false;
     }
+    return (timer_system_counter(self, cycle) >> timer_get_clock_bit(self)) & 1;
+}
 
-    self->counter += cycle;
-    uint64_t current_clock_threshold;
+static void timer_tick(struct Timer* self, uint64_t ticks)
+{
+    while (ticks > 0) {
+        uint64_t until_overflow = 0x100 - self->reg_tima;
+        if (ticks < until_overflow) {
+            self->reg_tima += ticks;
+            return;
+        }
+        ticks -= until_overflow;
+        // request timer interrupt and reset tima to tma
+        TIMER_TRACE_PRINT("TIMA overflow, reloading 0x%02X\n", self->reg_tma);
+        mmu_request_interrupt(self->mmu, INT_TIMER);
+        self->reg_tima = self->reg_tma;
+    }
+}
 
-    switch (self->reg_tac & 0x3) {
-    case 0: current_clock_threshold = 256; break;  // 00: Every 256 M-cycles (4096 Hz)
-    case 1: current_clock_threshold = 4; break;    // 01: Every 4 M-cycles (262144 Hz)
-    case 2: current_clock_threshold = 16; break;   // 10: Every 16 M-cycles (65536 Hz)
-    case 3: current_clock_threshold = 64; break;   // 11: Every 64 M-cycles (16384 Hz)
+// Bring TIMA up to date with the falling edges between tima_sync and cycle
+static void timer_sync(struct Timer* self, uint64_t cycle)
+{
+    if (self->reg_tac & TIMER_TAC_ENABLE) {
+        uint8_t  shift = timer_get_clock_bit(self) + 1;
+        uint64_t edges = (timer_system_counter(self, cycle) >> shift) -
+                         (timer_system_counter(self, self->tima_sync) >> shift);
+        timer_tick(self, edges);
     }
+    self->tima_sync = cycle;
+}
 
-    while (self->counter >= current_clock_threshold) {
-        self->counter -= current_clock_threshold;
+// Move EVENT_TIMER to the falling edge that overflows TIMA, call after timer_sync
+static void timer_schedule_overflow(struct Timer* self)
+{
+    if (self->scheduler == NULL) {
+        return;
+    }
+    if ((self->reg_tac & TIMER_TAC_ENABLE) == 0) {
+        scheduler_cancel(self->scheduler, EVENT_TIMER);
+        return;
+    }
+    uint8_t  shift   = timer_get_clock_bit(self) + 1;
+    uint64_t periods = (timer_system_counter(self, self->tima_sync) >> shift) +
+                       (0x100 - self->reg_tima);
+    scheduler_schedule_at(self->scheduler, EVENT_TIMER, self->div_base + (periods << shift));
+}
 
-        if (self->reg_tima == 0xFF) {
-            // request timer interrupt
-            uint8_t temp_interrupt_flag = self->ram->get_ram_byte(self->ram, IF_ADDRESS);
-            temp_interrupt_flag |= 0x04;
-            self->ram->set_ram_byte(self->ram, IF_ADDRESS, temp_interrupt_flag);
+uint8_t timer_read_register(struct Timer* self, uint16_t address)
+{
+    uint64_t now = timer_now(self);
+    switch (address) {
+    case TIMER_DIV_ADDRESS: return (timer_system_counter(self, now) >> 8) & 0xFF;
+    case TIMER_TIMA_ADDRESS: timer_sync(self, now); return self->reg_tima;
+    case TIMER_TMA_ADDRESS: return self->reg_tma;
+    default: return self->reg_tac | TIMER_TAC_UNUSED_BITS;
+    }
+}
 
-            // reset tima to tma
-            self->reg_tima = self->reg_tma;
+void timer_write_register(struct Timer* self, uint16_t address, uint8_t byte)
+{
+    uint64_t now = timer_now(self);
+    timer_sync(self, now);
+    switch (address) {
+    case TIMER_DIV_ADDRESS:
+        // any write resets the system counter, a selected bit going 1 -> 0 clocks TIMA
+        if (timer_clock_signal(self, now)) {
+            timer_tick(self, 1);
         }
-        else {
-            self->reg_tima++;
+        self->div_base = now;
+        break;
+    case TIMER_TIMA_ADDRESS: self->reg_tima = byte; break;
+    case TIMER_TMA_ADDRESS: self->reg_tma = byte; return;
+    default: {
+        // disabling the timer or switching to a clear bit is a falling edge too
+        bool signal_before = timer_clock_signal(self, now);
+        self->reg_tac      = byte & (TIMER_TAC_ENABLE | TIMER_TAC_CLOCK_MASK);
+        if (signal_before && !timer_clock_signal(self, now)) {
+            timer_tick(self, 1);
         }
+        break;
     }
-
-    timer_set_register(self);
+    }
+    timer_schedule_overflow(self);
 }
 
-void timer_refresh_register(struct Timer* self)
+void timer_handle_event(void* context, uint64_t deadline)
 {
-    self->reg_div  = self->ram->get_ram_byte(self->ram, TIMER_DIV_ADDRESS);
-    self->reg_tima = self->ram->get_ram_byte(self->ram, TIMER_TIMA_ADDRESS);
-    self->reg_tma  = self->ram->get_ram_byte(self->ram, TIMER_TMA_ADDRESS);
-    self->reg_tac  = self->ram->get_ram_byte(self->ram, TIMER_TAC_ADDRESS);
+    struct Timer* self = (struct Timer*)context;
+    timer_sync(self, deadline);
+    timer_schedule_overflow(self);
 }
 
-void timer_set_register(struct Timer* self)
+void timer_attach_scheduler(struct Timer* self, struct Scheduler* scheduler)
 {
-    self->ram->set_ram_byte(self->ram, TIMER_DIV_ADDRESS, self->reg_div);
-    self->ram->set_ram_byte(self->ram, TIMER_TIMA_ADDRESS, self->reg_tima);
-    self->ram->set_ram_byte(self->ram, TIMER_TMA_ADDRESS, self->reg_tma);
-    self->ram->set_ram_byte(self->ram, TIMER_TAC_ADDRESS, self->reg_tac);
+    self->scheduler = scheduler;
+    self->div_base  = scheduler->now;
+    self->tima_sync = scheduler->now;
+    scheduler_register(scheduler, EVENT_TIMER, timer_handle_event, self);
+    timer_schedule_overflow(self);
 }
 
 struct Timer* create_timer(void)
@@ -65,24 +135,20 @@ struct Timer* create_timer(void)
     struct Timer* timer = (struct Timer*)malloc(sizeof(struct Timer));
 
     // Initialize data members
-    timer->counter  = 0;
-    timer->divider  = 0;
-    timer->reg_div  = 0;   // register divider ff04
-    timer->reg_tima = 0;   // counter ff05
-    timer->reg_tma  = 0;   // modulator ff06
-    timer->reg_tac  = 0;   // control ff07
+    timer->div_base  = 0;
+    timer->tima_sync = 0;
+    timer->reg_tima  = 0;   // counter ff05
+    timer->reg_tma   = 0;   // modulator ff06
+    timer->reg_tac   = 0;   // control ff07
 
     // Initialize method pointers
-    timer->add_time               = timer_add_time;
-    timer->refresh_timer_register = timer_refresh_register;
-    timer->set_timer_register     = timer_set_register;
+    timer->read_register  = timer_read_register;
+    timer->write_register = timer_write_register;
 
-    return timer;
-}
+    timer->mmu       = NULL;
+    timer->scheduler = NULL;
 
-void timer_attach_ram(struct Timer* self, struct Ram* ram)
-{
-    self->ram = ram;
+    return timer;
 }
 
 void free_timer(struct Timer* timer)
@@ -2,7 +2,7 @@
 #define GAMEBOY_TIMER_H
 
 #include "general.h"
-#include "ram.h"
+#include "scheduler.h"
 
 extern struct EmulatorConfig config;
 
@@ -55,31 +55,48 @@ extern struct EmulatorConfig config;
         printf(fmt, ##__VA_ARGS__);     \
     }
 
+// TAC bits
+#define TIMER_TAC_ENABLE      0x04
+#define TIMER_TAC_CLOCK_MASK  0x03
+// TAC bits 3-7 are unused and read back as 1
+#define TIMER_TAC_UNUSED_BITS 0xF8
+
+struct MMU;
+
+// Timer
+// Nothing is counted per instruction. A 16 bit system counter is the number of cycles since the
+// last DIV reset, DIV is its upper byte and TIMA counts falling edges of the counter bit selected
+// by TAC. Both are derived from the scheduler clock on access, and the TIMA overflow is an
+// EVENT_TIMER deadline, re-planned only when DIV, TIMA or TAC are written.
 struct Timer
 {
     // Data members
-    uint64_t counter;
-    uint64_t divider;
-    uint8_t  reg_div;    // register divider ff04
-    uint8_t  reg_tima;   // counter ff05
-    uint8_t  reg_tma;    // modulator ff06
-    uint8_t  reg_tac;    // control ff07
+    uint64_t div_base;    // cycle the system counter was last reset at
+    uint64_t tima_sync;   // cycle reg_tima was last brought up to date at
+    uint8_t  reg_tima;    // counter ff05
+    uint8_t  reg_tma;     // modulator ff06
+    uint8_t  reg_tac;     // control ff07
 
     // Method pointers
-    void (*add_time)(struct Timer*, uint8_t);
-    void (*refresh_timer_register)(struct Timer*);
-    void (*set_timer_register)(struct Timer*);
+    uint8_t (*read_register)(struct Timer*, uint16_t address);
+    void (*write_register)(struct Timer*, uint16_t address, uint8_t byte);
 
-    // RAM
-    struct Ram* ram;
+    // MMU, set by mmu_attach_timer, used to request INT_TIMER
+    struct MMU* mmu;
+    // Scheduler, owns the clock the timer is derived from
+    struct Scheduler* scheduler;
 };
 
 // Function declarations
-void          timer_add_time(struct Timer* self, uint8_t cycle);
-void          timer_refresh_register(struct Timer* self);
-void          timer_set_register(struct Timer* self);
 struct Timer* create_timer(void);
 void          free_timer(struct Timer* timer);
-void          timer_attach_ram(struct Timer* self, struct Ram* ram);
+// read DIV/TIMA/TMA/TAC
+uint8_t timer_read_register(struct Timer* self, uint16_t address);
+// write DIV/TIMA/TMA/TAC
+void timer_write_register(struct Timer* self, uint16_t address, uint8_t byte);
+// EVENT_TIMER callback, TIMA overflow
+void timer_handle_event(void* context, uint64_t deadline);
+// Attach scheduler, the system counter starts at the current cycle
+void timer_attach_scheduler(struct Timer* self, struct Scheduler* scheduler);
 
 #endif
@@ -0,0 +1,347 @@
+#include "upscaler.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define UPSCALER_MAX_HEIGHT 144
+
+void upscale_row_scalar(uint32_t* dst, const uint32_t* src, int width, int scale)
+{
+    for (int x = 0; x < width; x++) {
+        for (int copy = 0; copy < scale; copy++) {
+            *dst++ = src[x];
+        }
+    }
+}
+
+void upscale_scale2x_row_scalar(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                                const uint32_t* mid, const uint32_t* down, int width)
+{
+    for (int x = 0; x < width; x++) {
+        //   B        E0 E1
+        // D E F  ->  E2 E3
+        //   H
+        uint32_t  b = up[x + 1], d = mid[x], e = mid[x + 1], f = mid[x + 2], h = down[x + 1];
+        uint32_t* top    = dst + x * 2;
+        uint32_t* bottom = top + dst_pitch;
+        if (b != h && d != f) {
+            top[0]    = d == b ? d : e;
+            top[1]    = b == f ? f : e;
+            bottom[0] = d == h ? d : e;
+            bottom[1] = h == f ? f : e;
+        }
+        else {
+            top[0] = top[1] = bottom[0] = bottom[1] = e;
+        }
+    }
+}
+
+void upscale_scale3x_row_scalar(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                                const uint32_t* mid, const uint32_t* down, int width)
+{
+    for (int x = 0; x < width; x++) {
+        // A B C      E0 E1 E2
+        // D E F  ->  E3 E4 E5
+        // G H I      E6 E7 E8
+        uint32_t a = up[x], b = up[x + 1], c = up[x + 2];
+        uint32_t d = mid[x], e = mid[x + 1], f = mid[x + 2];
+        uint32_t g = down[x], h = down[x + 1], i = down[x + 2];
+        uint32_t* row0 = dst + x * 3;
+        uint32_t* row1 = row0 + dst_pitch;
+        uint32_t* row2 = row1 + dst_pitch;
+        row0[0] = row0[1] = row0[2] = e;
+        row1[0] = row1[1] = row1[2] = e;
+        row2[0] = row2[1] = row2[2] = e;
+        if (b != h && d != f) {
+            row0[0] = d == b ? d : e;
+            row0[1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+            row0[2] = b == f ? f : e;
+            row1[0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+            row1[2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+            row2[0] = d == h ? d : e;
+            row2[1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+            row2[2] = h == f ? f : e;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// out[k] of a group: 4 source pixels repeated, the shuffle picks which source pixel goes where
+#define UPSCALE_STORE(k, order) \
+    _mm_storeu_si128((__m128i*)(out + (k) * 4), _mm_shuffle_epi32(v, order))
+
+__attribute__((target("sse2"))) void upscale_row_sse2(uint32_t* dst, const uint32_t* src,
+                                                      int width, int scale)
+{
+    if (scale == 1) {
+        memcpy(dst, src, width * sizeof(uint32_t));
+        return;
+    }
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i   v   = _mm_loadu_si128((const __m128i*)(src + x));
+        uint32_t* out = dst + x * scale;
+        switch (scale) {
+        case 2:
+            _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi32(v, v));
+            break;
+        case 3:
+            UPSCALE_STORE(0, _MM_SHUFFLE(1, 0, 0, 0));
+            UPSCALE_STORE(1, _MM_SHUFFLE(2, 2, 1, 1));
+            UPSCALE_STORE(2, _MM_SHUFFLE(3, 3, 3, 2));
+            break;
+        case 4:
+            UPSCALE_STORE(0, _MM_SHUFFLE(0, 0, 0, 0));
+            UPSCALE_STORE(1, _MM_SHUFFLE(1, 1, 1, 1));
+            UPSCALE_STORE(2, _MM_SHUFFLE(2, 2, 2, 2));
+            UPSCALE_STORE(3, _MM_SHUFFLE(3, 3, 3, 3));
+            break;
+        case 5:
+            UPSCALE_STORE(0, _MM_SHUFFLE(0, 0, 0, 0));
+            UPSCALE_STORE(1, _MM_SHUFFLE(1, 1, 1, 0));
+            UPSCALE_STORE(2, _MM_SHUFFLE(2, 2, 1, 1));
+            UPSCALE_STORE(3, _MM_SHUFFLE(3, 2, 2, 2));
+            UPSCALE_STORE(4, _MM_SHUFFLE(3, 3, 3, 3));
+            break;
+        default:
+            UPSCALE_STORE(0, _MM_SHUFFLE(0, 0, 0, 0));
+            UPSCALE_STORE(1, _MM_SHUFFLE(1, 1, 0, 0));
+            UPSCALE_STORE(2, _MM_SHUFFLE(1, 1, 1, 1));
+            UPSCALE_STORE(3, _MM_SHUFFLE(2, 2, 2, 2));
+            UPSCALE_STORE(4, _MM_SHUFFLE(3, 3, 2, 2));
+            UPSCALE_STORE(5, _MM_SHUFFLE(3, 3, 3, 3));
+            break;
+        }
+    }
+    upscale_row_scalar(dst + x * scale, src + x, width - x, scale);
+}
+
+#undef UPSCALE_STORE
+
+// mask ? a : b
+__attribute__((target("sse2"))) static inline __m128i upscale_select(__m128i mask, __m128i a,
+                                                                     __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+__attribute__((target("sse2"))) void upscale_scale2x_row_sse2(uint32_t* dst, int dst_pitch,
+                                                              const uint32_t* up,
+                                                              const uint32_t* mid,
+                                                              const uint32_t* down, int width)
+{
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i b = _mm_loadu_si128((const __m128i*)(up + x + 1));
+        __m128i d = _mm_loadu_si128((const __m128i*)(mid + x));
+        __m128i e = _mm_loadu_si128((const __m128i*)(mid + x + 1));
+        __m128i f = _mm_loadu_si128((const __m128i*)(mid + x + 2));
+        __m128i h = _mm_loadu_si128((const __m128i*)(down + x + 1));
+
+        // only where B != H and D != F
+        __m128i blocked = _mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f));
+        __m128i active  = _mm_andnot_si128(blocked, _mm_set1_epi32(-1));
+        __m128i e0 = upscale_select(_mm_and_si128(active, _mm_cmpeq_epi32(d, b)), d, e);
+        __m128i e1 = upscale_select(_mm_and_si128(active, _mm_cmpeq_epi32(b, f)), f, e);
+        __m128i e2 = upscale_select(_mm_and_si128(active, _mm_cmpeq_epi32(d, h)), d, e);
+        __m128i e3 = upscale_select(_mm_and_si128(active, _mm_cmpeq_epi32(h, f)), f, e);
+
+        uint32_t* top    = dst + x * 2;
+        uint32_t* bottom = top + dst_pitch;
+        _mm_storeu_si128((__m128i*)top, _mm_unpacklo_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)(top + 4), _mm_unpackhi_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)bottom, _mm_unpacklo_epi32(e2, e3));
+        _mm_storeu_si128((__m128i*)(bottom + 4), _mm_unpackhi_epi32(e2, e3));
+    }
+    upscale_scale2x_row_scalar(dst + x * 2, dst_pitch, up + x, mid + x, down + x, width - x);
+}
+
+// Interleave three vectors of 4 pixels into 12: a0 b0 c0 a1 b1 c1 ...
+__attribute__((target("sse2"))) static inline void upscale_store3(uint32_t* out, __m128i a,
+                                                                  __m128i b, __m128i c)
+{
+    __m128i ab_low  = _mm_unpacklo_epi32(a, b);   // a0 b0 a1 b1
+    __m128i ab_high = _mm_unpackhi_epi32(a, b);   // a2 b2 a3 b3
+    __m128i ca_low  = _mm_unpacklo_epi32(c, a);   // c0 a0 c1 a1
+    __m128i bc_high = _mm_unpackhi_epi32(b, c);   // b2 c2 b3 c3
+    __m128i bc_low  = _mm_unpacklo_epi32(b, c);   // b0 c0 b1 c1
+    __m128i ca_high = _mm_unpackhi_epi32(c, a);   // c2 a2 c3 a3
+    // a0 b0 | c0 a1
+    __m128i c0_a1   = _mm_shuffle_epi32(ca_low, _MM_SHUFFLE(3, 3, 3, 0));
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi64(ab_low, c0_a1));
+    // b1 c1 | a2 b2
+    _mm_storeu_si128((__m128i*)(out + 4),
+                     _mm_unpacklo_epi64(_mm_unpackhi_epi64(bc_low, bc_low), ab_high));
+    // c2 a3 | b3 c3
+    _mm_storeu_si128((__m128i*)(out + 8),
+                     _mm_unpacklo_epi64(_mm_shuffle_epi32(ca_high, _MM_SHUFFLE(3, 3, 3, 0)),
+                                        _mm_unpackhi_epi64(bc_high, bc_high)));
+}
+
+__attribute__((target("sse2"))) void upscale_scale3x_row_sse2(uint32_t* dst, int dst_pitch,
+                                                              const uint32_t* up,
+                                                              const uint32_t* mid,
+                                                              const uint32_t* down, int width)
+{
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(up + x));
+        __m128i b = _mm_loadu_si128((const __m128i*)(up + x + 1));
+        __m128i c = _mm_loadu_si128((const __m128i*)(up + x + 2));
+        __m128i d = _mm_loadu_si128((const __m128i*)(mid + x));
+        __m128i e = _mm_loadu_si128((const __m128i*)(mid + x + 1));
+        __m128i f = _mm_loadu_si128((const __m128i*)(mid + x + 2));
+        __m128i g = _mm_loadu_si128((const __m128i*)(down + x));
+        __m128i h = _mm_loadu_si128((const __m128i*)(down + x + 1));
+        __m128i i = _mm_loadu_si128((const __m128i*)(down + x + 2));
+
+        // only where B != H and D != F
+        __m128i blocked = _mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f));
+        __m128i active  = _mm_andnot_si128(blocked, _mm_set1_epi32(-1));
+        __m128i db = _mm_and_si128(active, _mm_cmpeq_epi32(d, b));
+        __m128i bf = _mm_and_si128(active, _mm_cmpeq_epi32(b, f));
+        __m128i dh = _mm_and_si128(active, _mm_cmpeq_epi32(d, h));
+        __m128i hf = _mm_and_si128(active, _mm_cmpeq_epi32(h, f));
+        __m128i ea = _mm_cmpeq_epi32(e, a);
+        __m128i ec = _mm_cmpeq_epi32(e, c);
+        __m128i eg = _mm_cmpeq_epi32(e, g);
+        __m128i ei = _mm_cmpeq_epi32(e, i);
+
+        // (X && E != Y) is andnot(E == Y, X)
+        __m128i e0 = upscale_select(db, d, e);
+        __m128i e1 = upscale_select(
+            _mm_or_si128(_mm_andnot_si128(ec, db), _mm_andnot_si128(ea, bf)), b, e);
+        __m128i e2 = upscale_select(bf, f, e);
+        __m128i e3 = upscale_select(
+            _mm_or_si128(_mm_andnot_si128(eg, db), _mm_andnot_si128(ea, dh)), d, e);
+        __m128i e5 = upscale_select(
+            _mm_or_si128(_mm_andnot_si128(ei, bf), _mm_andnot_si128(ec, hf)), f, e);
+        __m128i e6 = upscale_select(dh, d, e);
+        __m128i e7 = upscale_select(
+            _mm_or_si128(_mm_andnot_si128(ei, dh), _mm_andnot_si128(eg, hf)), h, e);
+        __m128i e8 = upscale_select(hf, f, e);
+
+        uint32_t* row0 = dst + x * 3;
+        upscale_store3(row0, e0, e1, e2);
+        upscale_store3(row0 + dst_pitch, e3, e, e5);
+        upscale_store3(row0 + dst_pitch * 2, e6, e7, e8);
+    }
+    upscale_scale3x_row_scalar(dst + x * 3, dst_pitch, up + x, mid + x, down + x, width - x);
+}
+
+#endif
+
+struct Upscaler* create_upscaler(enum UpscaleFilter filter)
+{
+    struct Upscaler* upscaler = (struct Upscaler*)malloc(sizeof(struct Upscaler));
+    if (upscaler == NULL) {
+        return NULL;
+    }
+    upscaler->filter   = filter;
+    upscaler->filtered = NULL;
+    if (filter != UPSCALE_NEAREST) {
+        // largest filter output: Scale3x of the whole frame
+        upscaler->filtered = (uint32_t*)malloc(UPSCALER_MAX_WIDTH * 3 * UPSCALER_MAX_HEIGHT * 3 *
+                                               sizeof(uint32_t));
+        if (upscaler->filtered == NULL) {
+            free(upscaler);
+            return NULL;
+        }
+    }
+
+    upscaler->widen_row   = upscale_row_scalar;
+    upscaler->scale2x_row = upscale_scale2x_row_scalar;
+    upscaler->scale3x_row = upscale_scale3x_row_scalar;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        UPSCALER_DEBUG_PRINT("Using SSE2 upscaler%s", "\n");
+        upscaler->widen_row   = upscale_row_sse2;
+        upscaler->scale2x_row = upscale_scale2x_row_sse2;
+        upscaler->scale3x_row = upscale_scale3x_row_sse2;
+        return upscaler;
+    }
+#endif
+    UPSCALER_DEBUG_PRINT("Using scalar upscaler%s", "\n");
+    return upscaler;
+}
+
+void free_upscaler(struct Upscaler* upscaler)
+{
+    if (upscaler) {
+        free(upscaler->filtered);
+        free(upscaler);
+    }
+}
+
+// Widen every source row once, then copy the finished row down scale - 1 times
+static void upscaler_scale_nearest(struct Upscaler* self, uint32_t* dst, int dst_pitch,
+                                   const uint32_t* src, int src_pitch, int width, int height,
+                                   int scale)
+{
+    size_t row_bytes = (size_t)width * scale * sizeof(uint32_t);
+    for (int y = 0; y < height; y++) {
+        uint32_t* out = dst + (size_t)y * scale * dst_pitch;
+        self->widen_row(out, src + (size_t)y * src_pitch, width, scale);
+        for (int copy = 1; copy < scale; copy++) {
+            memcpy(out + (size_t)copy * dst_pitch, out, row_bytes);
+        }
+    }
+}
+
+// Copy a source row between two repeated edge pixels
+static void upscaler_pad_row(uint32_t* padded, const uint32_t* row, int width)
+{
+    padded[0] = row[0];
+    memcpy(padded + 1, row, width * sizeof(uint32_t));
+    padded[width + 1] = row[width - 1];
+}
+
+void upscaler_scale(struct Upscaler* self, uint32_t* dst, int dst_pitch, const uint32_t* src,
+                    int src_pitch, int width, int height, int scale)
+{
+    upscale_filter_row_fn filter_row = NULL;
+    int                   factor     = 1;
+    if (self->filter == UPSCALE_SCALE2X && scale % 2 == 0) {
+        filter_row = self->scale2x_row;
+        factor     = 2;
+    }
+    else if (self->filter == UPSCALE_SCALE3X && scale % 3 == 0) {
+        filter_row = self->scale3x_row;
+        factor     = 3;
+    }
+    if (filter_row == NULL || width > UPSCALER_MAX_WIDTH || height > UPSCALER_MAX_HEIGHT) {
+        upscaler_scale_nearest(self, dst, dst_pitch, src, src_pitch, width, height, scale);
+        return;
+    }
+
+    // filter straight into dst, or into the scratch frame when nearest scaling follows
+    uint32_t* out       = dst;
+    int       out_pitch = dst_pitch;
+    if (scale > factor) {
+        out       = self->filtered;
+        out_pitch = width * factor;
+    }
+    uint32_t* up   = self->padded_rows[0];
+    uint32_t* mid  = self->padded_rows[1];
+    uint32_t* down = self->padded_rows[2];
+    upscaler_pad_row(mid, src, width);
+    memcpy(up, mid, (width + 2) * sizeof(uint32_t));
+    for (int y = 0; y < height; y++) {
+        const uint32_t* next = src + (size_t)(y + 1 < height ? y + 1 : y) * src_pitch;
+        upscaler_pad_row(down, next, width);
+        filter_row(out + (size_t)y * factor * out_pitch, out_pitch, up, mid, down, width);
+        // slide the window down a row
+        uint32_t* oldest = up;
+        up               = mid;
+        mid              = down;
+        down             = oldest;
+    }
+    if (scale > factor) {
+        upscaler_scale_nearest(self, dst, dst_pitch, out, out_pitch, width * factor,
+                               height * factor, scale / factor);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef GAMEBOY_UPSCALER_H
+#define GAMEBOY_UPSCALER_H
+
+#include "general.h"
+
+extern struct EmulatorConfig config;
+
+// Upscaler debug print
+#define UPSCALER_DEBUG_PRINT(fmt, ...)                              \
+    if (config.debug_mode && config.verbose_level >= DEBUG_LEVEL) { \
+        PRINT_TIME_IN_SECONDS();                                    \
+        PRINT_LEVEL(DEBUG_LEVEL);                                   \
+        printf("UPS: ");                                            \
+        printf(fmt, ##__VA_ARGS__);                                 \
+    }
+
+#define UPSCALER_MAX_SCALE 6
+#define UPSCALER_MAX_WIDTH 160   // widest source frame, sizes the per row scratch buffers
+
+// Edge directed filters, applied before any remaining whole multiple of nearest scaling
+enum UpscaleFilter
+{
+    UPSCALE_NEAREST,
+    UPSCALE_SCALE2X,   // when the scale is a multiple of 2
+    UPSCALE_SCALE3X,   // when the scale is a multiple of 3
+};
+
+// Repeats every pixel of a row scale times (1 - UPSCALER_MAX_SCALE)
+typedef void (*upscale_row_fn)(uint32_t* dst, const uint32_t* src, int width, int scale);
+// Filters a row, up/mid/down hold width + 2 pixels with the edge pixel repeated on both sides.
+// Writes factor rows of width * factor pixels, dst_pitch pixels apart
+typedef void (*upscale_filter_row_fn)(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                                      const uint32_t* mid, const uint32_t* down, int width);
+
+// Reference implementations, one pixel at a time
+void upscale_row_scalar(uint32_t* dst, const uint32_t* src, int width, int scale);
+void upscale_scale2x_row_scalar(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                                const uint32_t* mid, const uint32_t* down, int width);
+void upscale_scale3x_row_scalar(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                                const uint32_t* mid, const uint32_t* down, int width);
+#if defined(__x86_64__) || defined(__i386__)
+// 4 source pixels at a time, pixels repeated with 32 bit shuffles
+void upscale_row_sse2(uint32_t* dst, const uint32_t* src, int width, int scale);
+// 4 source pixels at a time, neighbour compares as 32 bit masks
+void upscale_scale2x_row_sse2(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                              const uint32_t* mid, const uint32_t* down, int width);
+void upscale_scale3x_row_sse2(uint32_t* dst, int dst_pitch, const uint32_t* up,
+                              const uint32_t* mid, const uint32_t* down, int width);
+#endif
+
+struct Upscaler
+{
+    enum UpscaleFilter    filter;
+    upscale_row_fn        widen_row;
+    upscale_filter_row_fn scale2x_row;
+    upscale_filter_row_fn scale3x_row;
+
+    // source rows with their edges repeated, for the filters
+    uint32_t padded_rows[3][UPSCALER_MAX_WIDTH + 2];
+    // filtered frame, when nearest scaling still follows the filter
+    uint32_t* filtered;
+};
+
+// create an upscaler, the fastest row functions the host CPU supports (CPUID) are picked
+struct Upscaler* create_upscaler(enum UpscaleFilter filter);
+void             free_upscaler(struct Upscaler* upscaler);
+// scale a width x height frame (width up to UPSCALER_MAX_WIDTH) by scale into dst,
+// pitches in pixels; dst must hold width * scale x height * scale pixels
+void upscaler_scale(struct Upscaler* upscaler, uint32_t* dst, int dst_pitch, const uint32_t* src,
+                    int src_pitch, int width, int height, int scale);
+
+#endif
@@ -8,10 +8,107 @@ uint8_t vram_get_byte(struct Vram* self, uint16_t address)
     return self->vram_byte[vram_index];
 }
 
+// Mark the tile a tile data byte belongs to for decoding, or the tile map cell for redrawing
+static inline void vram_invalidate(struct Vram* self, uint16_t vram_index)
+{
+    if (vram_index < VRAM_TILE_DATA_SIZE) {
+        uint16_t tile = vram_index / VRAM_TILE_SIZE;
+        self->tile_dirty[tile >> 6] |= 1ull << (tile & 63);
+        for (int layer = 0; layer < VRAM_LAYER_COUNT; layer++) {
+            self->layer_stale_tiles[layer][tile >> 6] |= 1ull << (tile & 63);
+        }
+        self->layer_pending = (1 << VRAM_LAYER_COUNT) - 1;
+        return;
+    }
+    // both layers of the map, one per addressing mode
+    uint16_t cell  = (vram_index - VRAM_TILE_DATA_SIZE) & (VRAM_TILE_MAP_CELLS - 1);
+    uint8_t  layer = (vram_index - VRAM_TILE_DATA_SIZE) / VRAM_TILE_MAP_CELLS * 2;
+    self->layer_dirty[layer][cell >> 6] |= 1ull << (cell & 63);
+    self->layer_dirty[layer + 1][cell >> 6] |= 1ull << (cell & 63);
+    self->layer_pending |= 3 << layer;
+}
+
+// Store a byte, only changed bytes invalidate anything
+static inline void vram_store(struct Vram* self, uint16_t vram_index, uint8_t byte)
+{
+    if (self->vram_byte[vram_index] != byte) {
+        self->vram_byte[vram_index] = byte;
+        vram_invalidate(self, vram_index);
+    }
+}
+
+void vram_decode_tile(struct Vram* self, uint16_t tile)
+{
+    const uint8_t* data = self->vram_byte + tile * VRAM_TILE_SIZE;
+    for (int row = 0; row < 8; row++) {
+        uint8_t low  = data[row * 2];
+        uint8_t high = data[row * 2 + 1];
+        for (int x = 0; x < 8; x++) {
+            uint8_t bit   = 7 - x;
+            uint8_t color = (((high >> bit) & 1) << 1) | ((low >> bit) & 1);
+            self->tile_cache[tile][row][x]             = color;
+            self->tile_cache_flipped[tile][row][7 - x] = color;
+        }
+    }
+    self->tile_dirty[tile >> 6] &= ~(1ull << (tile & 63));
+}
+
+void vram_decode_dirty_tiles(struct Vram* self)
+{
+    for (int word = 0; word < VRAM_TILE_COUNT / 64; word++) {
+        while (self->tile_dirty[word]) {
+            vram_decode_tile(self, word * 64 + __builtin_ctzll(self->tile_dirty[word]));
+        }
+    }
+}
+
+void vram_update_layer(struct Vram* self, uint8_t layer)
+{
+    const uint8_t* map = self->vram_byte + VRAM_TILE_DATA_SIZE + (layer / 2) * VRAM_TILE_MAP_CELLS;
+    bool signed_addressing = layer & 1;
+
+    // cells showing a tile whose data changed
+    uint64_t stale = 0;
+    for (int word = 0; word < VRAM_TILE_COUNT / 64; word++) {
+        stale |= self->layer_stale_tiles[layer][word];
+    }
+    if (stale) {
+        for (int cell = 0; cell < VRAM_TILE_MAP_CELLS; cell++) {
+            uint16_t tile = vram_tile_from_map(map[cell], signed_addressing);
+            if (self->layer_stale_tiles[layer][tile >> 6] & (1ull << (tile & 63))) {
+                self->layer_dirty[layer][cell >> 6] |= 1ull << (cell & 63);
+            }
+        }
+        memset(self->layer_stale_tiles[layer], 0, sizeof(self->layer_stale_tiles[layer]));
+    }
+
+    for (int word = 0; word < VRAM_TILE_MAP_CELLS / 64; word++) {
+        while (self->layer_dirty[layer][word]) {
+            int      cell = word * 64 + __builtin_ctzll(self->layer_dirty[layer][word]);
+            uint16_t tile = vram_tile_from_map(map[cell], signed_addressing);
+            uint8_t* out  = &self->layer_cache[layer][(cell / 32) * 8][(cell % 32) * 8];
+            for (int row = 0; row < 8; row++) {
+                memcpy(out + row * VRAM_LAYER_SIZE, vram_get_tile_row(self, tile, row, false), 8);
+            }
+            self->layer_dirty[layer][word] &= self->layer_dirty[layer][word] - 1;
+        }
+    }
+    self->layer_pending &= ~(1 << layer);
+}
+
+void vram_update_layers(struct Vram* self)
+{
+    for (uint8_t layer = 0; layer < VRAM_LAYER_COUNT; layer++) {
+        if (self->layer_pending & (1 << layer)) {
+            vram_update_layer(self, layer);
+        }
+    }
+}
+
 void vram_set_byte(struct Vram* self, uint16_t address, uint8_t byte)
 {
     uint16_t vram_index = address - 0x8000;
-    self->vram_byte[vram_index] = byte;
+    vram_store(self, vram_index, byte);
     VRAM_TRACE_PRINT("VRAM_SET_BYTE: address: 0x%02x, vram_index: 0x%02x, value: 0x%02x\n", address, vram_index, byte);
 }
 
@@ -28,8 +125,8 @@ void vram_set_word(struct Vram* self, uint16_t address, uint16_t word)
 {
     uint16_t vram_index = address - 0x8000;
     // Little endian: lower byte first, then higher byte
-    self->vram_byte[vram_index]     = word & 0xFF;
-    self->vram_byte[vram_index + 1] = (word >> 8) & 0xFF;
+    vram_store(self, vram_index, word & 0xFF);
+    vram_store(self, vram_index + 1, (word >> 8) & 0xFF);
     VRAM_TRACE_PRINT("VRAM_SET_WORD: address: 0x%02x, vram_index: 0x%02x, value: 0x%04x\n", address, vram_index, word);
 }
 
@@ -39,6 +136,15 @@ struct Vram* create_vram(void)
     // Initialize vram array to 0
     VRAM_TRACE_PRINT("VRAM_CREATE: Initializing vram array to 0%s", "\n");
     memset(vram->vram_byte, 0, VRAM_SIZE);
+    // all-zero tile data decodes to color 0 everywhere
+    memset(vram->tile_cache, 0, sizeof(vram->tile_cache));
+    memset(vram->tile_cache_flipped, 0, sizeof(vram->tile_cache_flipped));
+    memset(vram->tile_dirty, 0, sizeof(vram->tile_dirty));
+    // and so does every tile map, all of them pointing at tile 0 or 256
+    memset(vram->layer_cache, 0, sizeof(vram->layer_cache));
+    memset(vram->layer_dirty, 0, sizeof(vram->layer_dirty));
+    memset(vram->layer_stale_tiles, 0, sizeof(vram->layer_stale_tiles));
+    vram->layer_pending = 0;
     // set method pointers
     vram->vram_get_byte = vram_get_byte;
     vram->vram_set_byte = vram_set_byte;
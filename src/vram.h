@@ -5,6 +5,17 @@
 
 #define VRAM_SIZE 0x2000   // 8KB Video RAM (0x8000-0x9FFF)
 
+// Tile data: 384 tiles of 16 bytes at 0x8000-0x97FF, the tile maps follow
+#define VRAM_TILE_COUNT     384
+#define VRAM_TILE_SIZE      16
+#define VRAM_TILE_DATA_SIZE (VRAM_TILE_COUNT * VRAM_TILE_SIZE)
+
+// Tile maps: two 32x32 maps at 0x9800 and 0x9C00
+#define VRAM_TILE_MAP_CELLS 1024
+// Background layers: each tile map decoded as a 256x256 bitmap, under 8000 and 8800 addressing
+#define VRAM_LAYER_COUNT 4
+#define VRAM_LAYER_SIZE  256
+
 extern struct EmulatorConfig config;
 
 // VRAM debug print
@@ -61,6 +72,20 @@ struct Vram
     // Data members
     uint8_t vram_byte[VRAM_SIZE];
 
+    // Decoded tile cache: 8 rows of 8 color indices (0-3) per tile, plus the X-flipped copy.
+    // A write to tile data sets the tile's dirty bit, the tile is decoded again on next use.
+    uint8_t  tile_cache[VRAM_TILE_COUNT][8][8];
+    uint8_t  tile_cache_flipped[VRAM_TILE_COUNT][8][8];
+    uint64_t tile_dirty[VRAM_TILE_COUNT / 64];
+
+    // Layer cache: color indices of a whole tile map, layer = map * 2 + signed addressing.
+    // Map writes mark their cell dirty, tile data writes mark the tile stale for every layer;
+    // cells showing a stale tile are found and redrawn on the next use of the layer.
+    uint8_t  layer_cache[VRAM_LAYER_COUNT][VRAM_LAYER_SIZE][VRAM_LAYER_SIZE];
+    uint64_t layer_dirty[VRAM_LAYER_COUNT][VRAM_TILE_MAP_CELLS / 64];
+    uint64_t layer_stale_tiles[VRAM_LAYER_COUNT][VRAM_TILE_COUNT / 64];
+    uint8_t  layer_pending;   // bit per layer with dirty cells or stale tiles
+
     // Method pointers
     uint8_t (*vram_get_byte)(struct Vram*, uint16_t);
     void (*vram_set_byte)(struct Vram*, uint16_t, uint8_t);
@@ -75,5 +100,41 @@ uint16_t     vram_get_word(struct Vram* self, uint16_t address);
 void         vram_set_word(struct Vram* self, uint16_t address, uint16_t word);
 struct Vram* create_vram(void);
 void         free_vram(struct Vram* self);
+// Decode a tile into the cache and clear its dirty bit
+void vram_decode_tile(struct Vram* self, uint16_t tile);
+// Decode every dirty tile, the cache is then read only until the next VRAM write
+void vram_decode_dirty_tiles(struct Vram* self);
+// Redraw the cells of a layer that changed since its last use
+void vram_update_layer(struct Vram* self, uint8_t layer);
+// Bring every layer up to date, the layers are then read only until the next VRAM write
+void vram_update_layers(struct Vram* self);
+
+// Tile index (0-383) of a tile map entry
+// 8000 method: unsigned index from 0x8000, 8800 method: signed index from 0x9000
+static inline uint16_t vram_tile_from_map(uint8_t tile_index, bool signed_addressing)
+{
+    return signed_addressing ? (uint16_t)(256 + (int8_t)tile_index) : tile_index;
+}
+
+// 8 decoded color indices of one tile row
+static inline const uint8_t* vram_get_tile_row(struct Vram* self, uint16_t tile, uint8_t row,
+                                               bool x_flip)
+{
+    if (self->tile_dirty[tile >> 6] & (1ull << (tile & 63))) {
+        vram_decode_tile(self, tile);
+    }
+    return x_flip ? self->tile_cache_flipped[tile][row] : self->tile_cache[tile][row];
+}
+
+// Row y of the 256x256 layer for the tile map at tile_map (0x9800 or 0x9C00)
+static inline const uint8_t* vram_get_layer_row(struct Vram* self, uint16_t tile_map,
+                                                bool signed_addressing, uint8_t y)
+{
+    uint8_t layer = (tile_map == 0x9C00) * 2 + signed_addressing;
+    if (self->layer_pending & (1 << layer)) {
+        vram_update_layer(self, layer);
+    }
+    return self->layer_cache[layer][y];
+}
 
 #endif
@@ -1,6 +1,47 @@
 #include "../src/cartridge.h"
 #include "test.h"
 
+#define IMAGE_PATH "test/mapped-test.gb"
+#define SAVE_PATH  "test/mapped-test.sav"
+
+static uint8_t image[4 * GAMEBOY_BANK_SIZE];
+
+static long save_file_size(void)
+{
+    FILE *save_file = fopen(SAVE_PATH, "rb");
+    assert(save_file != NULL);
+    fseek(save_file, 0, SEEK_END);
+    long size = ftell(save_file);
+    fclose(save_file);
+    return size;
+}
+
+static int save_file_byte(long offset)
+{
+    FILE *save_file = fopen(SAVE_PATH, "rb");
+    assert(save_file != NULL);
+    fseek(save_file, offset, SEEK_SET);
+    int byte = fgetc(save_file);
+    fclose(save_file);
+    return byte;
+}
+
+static int bank_switches = 0;
+
+static void count_bank_switch(struct MMU *mmu)
+{
+    (void)mmu;
+    bank_switches++;
+}
+
+static void write_image(size_t size)
+{
+    FILE *image_file = fopen(IMAGE_PATH, "wb");
+    assert(image_file != NULL);
+    assert(fwrite(image, 1, size, image_file) == size);
+    fclose(image_file);
+}
+
 int main()
 {
     config.start_time = get_time_in_seconds();
@@ -9,6 +50,210 @@ int main()
     printf("=========================\n");
     struct Cartridge *cartridge = NULL;
 
+    // Mapped ROM: two ROM only banks written out, then loaded back read only
+    printf("=========================\n");
+    printf("Cartridge: MAPPED\n");
+    printf("=========================\n");
+    memcpy(image + GAMEBOY_ROM_NAME_ADDRESS, "MAPPED", 6);
+    image[GAMEBOY_BANK_SIZE] = 0x5A;
+    write_image(2 * GAMEBOY_BANK_SIZE);
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    remove(IMAGE_PATH);   // the mapping outlives the file name
+    assert(strcmp(cartridge_get_rom_name(cartridge), "MAPPED") == 0);
+    assert(cartridge->rom_size == 2 * GAMEBOY_BANK_SIZE);
+    assert(cartridge->rom_data[GAMEBOY_BANK_SIZE] == 0x5A);
+#ifndef _WIN32
+    assert(cartridge->rom_mapped);
+#endif
+    free_cartridge(cartridge);
+    // a ROM shorter than a bank loads, reads past its end give 0xFF
+    write_image(0x200);
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    assert(cartridge_get_cartridge_byte(cartridge, 0x0134) == 'M');
+    assert(cartridge_get_cartridge_byte(cartridge, 0x3FFF) == 0xFF);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4000) == 0xFF);
+    assert(cartridge_get_cartridge_page(cartridge, 0x0200) == NULL);
+    free_cartridge(cartridge);
+    // anything shorter than the header is refused
+    write_image(GAMEBOY_CARTRIDGE_HEADER_END - 1);
+    cartridge = create_cartridge();
+    assert(!load_cartridge(cartridge, IMAGE_PATH));
+    remove(IMAGE_PATH);
+    free_cartridge(cartridge);
+
+    // Bank pointers: MBC1 + RAM, 4 ROM banks tagged with their number, 4 RAM banks
+    printf("=========================\n");
+    printf("Cartridge: BANKS\n");
+    printf("=========================\n");
+    for (int bank = 0; bank < 4; bank++) {
+        image[bank * GAMEBOY_BANK_SIZE + 0x100] = bank;
+    }
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC1_RAM;
+    image[GAMEBOY_ROM_SIZE_ADDRESS]       = 0x01;
+    image[GAMEBOY_RAM_SIZE_ADDRESS]       = 0x03;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    remove(IMAGE_PATH);
+    assert(cartridge->rom_bank_0 == cartridge->rom_data);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 1);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 3);
+    assert(cartridge->rom_bank_1 == cartridge->rom_data + 3 * GAMEBOY_BANK_SIZE);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 3);
+    assert(cartridge_get_cartridge_page(cartridge, 0x4100) == cartridge->rom_bank_1 + 0x100);
+    // bank 0 selects bank 1, banks past the end wrap
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 0);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 1);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 6);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 2);
+    // RAM is unmapped until enabled
+    assert(cartridge->ram == NULL);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA000) == 0xFF);
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0xA010, 0x42);
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 1);
+    assert(cartridge->ram == cartridge->ram_data + GAMEBOY_RAM_BANK_SIZE);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA010) == 0x00);
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 0);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA010) == 0x42);
+    assert(cartridge_get_cartridge_page(cartridge, 0xA010) == cartridge->ram);
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x00);
+    assert(cartridge_get_cartridge_page(cartridge, 0xA010) == NULL);
+    assert(cartridge->mapper == &mapper_mbc1);
+    // the page table is only repointed when a bank actually moves
+    cartridge->on_bank_switch = count_bank_switch;
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 3);
+    assert(bank_switches == 1);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 7);   // wraps to bank 3 again
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x00);
+    assert(bank_switches == 1);
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    assert(bank_switches == 2);
+    free_cartridge(cartridge);
+
+    // Mappers: the handler table follows the cartridge type
+    printf("=========================\n");
+    printf("Cartridge: MAPPERS\n");
+    printf("=========================\n");
+    // MBC5 selects bank 0 and takes the 9th bank bit
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC5_RAM_BATTERY;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    assert(cartridge->mapper == &mapper_mbc5);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 0);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 0);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 2);
+    cartridge_set_cartridge_byte(cartridge, 0x3000, 1);
+    assert(cartridge_get_rom_bank(cartridge) == 0x102);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 2);   // wraps on a 4 bank ROM
+    // RAM survives a save and load through the handler table
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0xA000, 0x99);
+    FILE *save_file = tmpfile();
+    assert(cartridge->mapper->save(cartridge, save_file));
+    cartridge_set_cartridge_byte(cartridge, 0xA000, 0x00);
+    rewind(save_file);
+    assert(cartridge->mapper->load(cartridge, save_file));
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA000) == 0x99);
+    fclose(save_file);
+    // without a motor bit 3 is part of the RAM bank
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 0x0B);
+    assert(cartridge_get_ram_bank(cartridge) == 0x0B);
+    assert(!cartridge->rumble_motor_on);
+    free_cartridge(cartridge);
+    remove(SAVE_PATH);
+    // rumble carts bind their own table, bit 3 drives the motor
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC5_RUMBLE_RAM;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    assert(cartridge->mapper == &mapper_mbc5_rumble);
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 0x0B);
+    assert(cartridge_get_ram_bank(cartridge) == 0x03);
+    assert(cartridge->rumble_motor_on);
+    cartridge_set_cartridge_byte(cartridge, 0x2000, 0);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 0);
+    free_cartridge(cartridge);
+    // MBC2 keeps 512 nibbles, mirrored across 0xA000-0xBFFF
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC2_BATTERY;
+    image[GAMEBOY_RAM_SIZE_ADDRESS]       = 0x00;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    remove(IMAGE_PATH);
+    assert(cartridge->mapper == &mapper_mbc2);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA1FF) == 0xFF);
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0xA1FF, 0x35);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA1FF) == 0xF5);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xA3FF) == 0xF5);
+    assert(cartridge_get_cartridge_page(cartridge, 0xA100) == NULL);
+    // bank select needs address bit 8
+    cartridge_set_cartridge_byte(cartridge, 0x2100, 3);
+    assert(cartridge_get_cartridge_byte(cartridge, 0x4100) == 3);
+    free_cartridge(cartridge);
+    assert(save_file_size() == MBC2_RAM_SIZE);
+    remove(SAVE_PATH);
+
+    // Battery saves: the RAM is the mapped save file next to the ROM and outlives the cartridge
+    printf("=========================\n");
+    printf("Cartridge: BATTERY\n");
+    printf("=========================\n");
+    char *save_path = battery_save_path("roms.v2/game.gb");
+    assert(strcmp(save_path, "roms.v2/game.sav") == 0);
+    free(save_path);
+    save_path = battery_save_path("roms.v2/game");
+    assert(strcmp(save_path, "roms.v2/game.sav") == 0);
+    free(save_path);
+    config.save_interval = 10;
+    remove(SAVE_PATH);
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC3_RAM_BATTERY;
+    image[GAMEBOY_RAM_SIZE_ADDRESS]       = 0x03;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    assert(cartridge->battery && cartridge->battery_save != NULL);
+    assert(cartridge->ram_data == cartridge->battery_save->mapping);
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 3);
+    cartridge_set_cartridge_byte(cartridge, 0xBFFF, 0x77);
+    free_cartridge(cartridge);
+    assert(save_file_size() == 4 * GAMEBOY_RAM_BANK_SIZE);
+    assert(save_file_byte(4 * GAMEBOY_RAM_BANK_SIZE - 1) == 0x77);
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0x4000, 3);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xBFFF) == 0x77);
+    free_cartridge(cartridge);
+    // a 2KB RAM keeps a 2KB save, the rest of the bank stays addressable
+    remove(SAVE_PATH);
+    image[GAMEBOY_RAM_SIZE_ADDRESS] = 0x01;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    cartridge_set_cartridge_byte(cartridge, 0x0000, 0x0A);
+    cartridge_set_cartridge_byte(cartridge, 0xA7FF, 0x11);
+    cartridge_set_cartridge_byte(cartridge, 0xBFFF, 0x22);
+    assert(cartridge_get_cartridge_byte(cartridge, 0xBFFF) == 0x22);
+    free_cartridge(cartridge);
+    assert(save_file_size() == 2048);
+    assert(save_file_byte(2047) == 0x11);
+    // without a battery nothing is saved
+    remove(SAVE_PATH);
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = CONTROLLER_MBC3_RAM;
+    write_image(sizeof(image));
+    cartridge = create_cartridge();
+    assert(load_cartridge(cartridge, IMAGE_PATH));
+    assert(!cartridge->battery && cartridge->battery_save == NULL);
+    free_cartridge(cartridge);
+    assert(fopen(SAVE_PATH, "rb") == NULL);
+    remove(IMAGE_PATH);
+    config.save_interval = 0;
+
     // CPU_INSTRS
     printf("=========================\n");
     printf("Cartridge: CPU_INSTRS\n");
@@ -1,4 +1,6 @@
 #include "../src/cpu.h"
+#include "../src/render_pool.h"
+#include "../src/render_worker.h"
 #include "test.h"
 
 #define TEST_PC 0xC000
@@ -1768,6 +1770,573 @@ void test_opcode_cb_c6()
     DELETE_ALL_COMPONENTS
 }
 
+// Interrupt dispatch through the cached IE & IF mask
+void test_interrupt_dispatch()
+{
+    CREATE_ALL_COMPONENTS
+
+    cpu->interrupt_master_enable = true;
+    cpu->mmu->mmu_set_byte(cpu->mmu, TEST_PC, 0x00);
+
+    // requested but not enabled: nothing pending
+    mmu_request_interrupt(cpu->mmu, INT_TIMER);
+    assert(cpu->mmu->interrupt_pending == 0);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, IF_ADDRESS) == (0xE0 | INT_TIMER));
+
+    // enabling it through IE makes it pending
+    cpu->mmu->mmu_set_byte(cpu->mmu, IE_ADDRESS, INT_TIMER | INT_VBLANK);
+    assert(cpu->mmu->interrupt_pending == INT_TIMER);
+
+    // V-Blank has priority over timer
+    mmu_request_interrupt(cpu->mmu, INT_VBLANK);
+    cpu->cpu_step_next(cpu);
+    assert(cpu->registers->get_control_register(cpu->registers, PC) == INTERRUPT_VECTOR_VBLANK);
+    assert(cpu->registers->get_control_register(cpu->registers, SP) == TEST_SP - 2);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, TEST_SP - 2) == TEST_PC);
+    assert(cpu->interrupt_master_enable == false);
+    assert(cpu->mmu->interrupt_pending == INT_TIMER);
+
+    // writing IF directly clears the mask
+    cpu->mmu->mmu_set_byte(cpu->mmu, IF_ADDRESS, 0x00);
+    assert(cpu->mmu->interrupt_pending == 0);
+
+    DELETE_ALL_COMPONENTS
+}
+
+// Serial transfer without a scheduler completes at once
+void test_serial_transfer()
+{
+    CREATE_ALL_COMPONENTS
+
+    struct Serial *serial = create_serial();
+    mmu_attach_serial(cpu->mmu, serial);
+    cpu->mmu->mmu_set_byte(cpu->mmu, IE_ADDRESS, INT_SERIAL);
+
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SB_ADDRESS, 'o');
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SC_ADDRESS, 0x81);
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SB_ADDRESS, 'k');
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SC_ADDRESS, 0x81);
+    // external clock: no partner, never completes
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SB_ADDRESS, '!');
+    cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SC_ADDRESS, 0x80);
+
+    size_t      length;
+    const char *output = serial_get_output(serial, &length);
+    assert(length == 2);
+    assert(memcmp(output, "ok", 2) == 0);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, SERIAL_SC_ADDRESS) == 0xFE);
+    assert(cpu->mmu->interrupt_pending == INT_SERIAL);
+
+    // without printing the buffer grows instead of dropping output
+    for (int i = 0; i < 2 * SERIAL_BUFFER_SIZE; i++) {
+        cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SB_ADDRESS, 'a' + i % 26);
+        cpu->mmu->mmu_set_byte(cpu->mmu, SERIAL_SC_ADDRESS, 0x81);
+    }
+    output = serial_get_output(serial, &length);
+    assert(length == 2 + 2 * SERIAL_BUFFER_SIZE);
+    assert(memcmp(output, "okab", 4) == 0);
+    assert(output[length - 1] == 'a' + (2 * SERIAL_BUFFER_SIZE - 1) % 26);
+
+    free_serial(serial);
+    DELETE_ALL_COMPONENTS
+}
+
+// Machine state when a HALT waiting on the timer wakes up
+struct HaltWakeUp
+{
+    uint64_t now;
+    uint8_t  tima;
+    uint8_t  div;
+    uint8_t  int_flag;
+};
+
+// HALT with only INT_TIMER enabled (IME off), then run to the wake-up either through the
+// fast-forward of cpu_run_until_next_event or one step at a time
+static struct HaltWakeUp halt_until_timer(bool fast_forward)
+{
+    CREATE_ALL_COMPONENTS
+
+    struct Scheduler *scheduler = create_scheduler();
+    struct Timer     *timer     = create_timer();
+    mmu_attach_timer(cpu->mmu, timer);
+    timer_attach_scheduler(timer, scheduler);
+    cpu_attach_scheduler(cpu, scheduler);
+
+    // start off any timer edge, 4096 Hz: two TIMA ticks to overflow
+    scheduler->now = 0x1234;
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TMA_ADDRESS, 0xF0);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TIMA_ADDRESS, 0xFE);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TAC_ADDRESS, 0x04);
+    cpu->mmu->mmu_set_byte(cpu->mmu, IE_ADDRESS, INT_TIMER);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TEST_PC, 0x76);
+    scheduler->now += cpu_step_next(cpu);
+    assert(cpu->halted);
+
+    if (fast_forward) {
+        // each run skips straight to the next timer event without executing anything
+        while (cpu->halted) {
+            uint64_t deadline = scheduler->next_deadline;
+            cpu_run_until_next_event(cpu);
+            assert(scheduler->now == deadline);
+            assert(registers_get_control(cpu->registers, PC) == TEST_PC + 1);
+            scheduler_dispatch(scheduler);
+            if (cpu->mmu->interrupt_pending) {
+                scheduler->now += cpu_step_next(cpu);
+            }
+        }
+    }
+    else {
+        while (cpu->halted) {
+            scheduler_dispatch(scheduler);
+            scheduler->now += cpu_step_next(cpu);
+        }
+    }
+
+    struct HaltWakeUp wake_up = {
+        .now      = scheduler->now,
+        .tima     = cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TIMA_ADDRESS),
+        .div      = cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_DIV_ADDRESS),
+        .int_flag = cpu->mmu->mmu_get_byte(cpu->mmu, IF_ADDRESS),
+    };
+    free_timer(timer);
+    free_scheduler(scheduler);
+    DELETE_ALL_COMPONENTS
+    return wake_up;
+}
+
+// HALT fast-forward: the timer state on wake-up matches a cycle by cycle run
+void test_halt_fast_forward()
+{
+    struct HaltWakeUp stepped = halt_until_timer(false);
+    struct HaltWakeUp skipped = halt_until_timer(true);
+    assert(stepped.int_flag & INT_TIMER);
+    assert(stepped.tima == 0xF0);
+    assert(skipped.now == stepped.now);
+    assert(skipped.tima == stepped.tima);
+    assert(skipped.div == stepped.div);
+    assert(skipped.int_flag == stepped.int_flag);
+
+    // an interrupt pending (IE & IF) while halted must not be skipped over
+    CREATE_ALL_COMPONENTS
+
+    struct Scheduler *scheduler = create_scheduler();
+    cpu_attach_scheduler(cpu, scheduler);
+    scheduler_schedule_in(scheduler, EVENT_SERIAL, 1000);
+    cpu->mmu->mmu_set_byte(cpu->mmu, IE_ADDRESS, INT_TIMER);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TEST_PC, 0x76);
+    scheduler->now += cpu_step_next(cpu);
+    assert(cpu->halted);
+    mmu_request_interrupt(cpu->mmu, INT_TIMER);
+    assert(cpu_halt_skip_cycles(cpu, scheduler_cycles_until_next_event(scheduler)) == 0);
+    cpu_run_until_next_event(cpu);
+    // woke up at once and ran the NOPs after the HALT instead of sleeping to the deadline
+    assert(!cpu->halted);
+    assert(registers_get_control(cpu->registers, PC) > TEST_PC + 1);
+
+    free_scheduler(scheduler);
+    DELETE_ALL_COMPONENTS
+}
+
+// Write a 4 bank test ROM of the given cartridge type, bank n tagged with n at 0x100
+static void write_test_rom(const char *path, uint8_t controller_type, uint8_t ram_size_code)
+{
+    static uint8_t image[4 * GAMEBOY_BANK_SIZE];
+    memset(image, 0, sizeof(image));
+    for (int bank = 0; bank < 4; bank++) {
+        image[bank * GAMEBOY_BANK_SIZE + 0x100] = bank;
+    }
+    image[GAMEBOY_CARTRIDGE_TYPE_ADDRESS] = controller_type;
+    image[GAMEBOY_ROM_SIZE_ADDRESS]       = 0x01;
+    image[GAMEBOY_RAM_SIZE_ADDRESS]       = ram_size_code;
+    FILE *image_file = fopen(path, "wb");
+    assert(image_file != NULL);
+    assert(fwrite(image, 1, sizeof(image), image_file) == sizeof(image));
+    fclose(image_file);
+}
+
+// Cartridge pages: the page table follows bank switches, words off it go through the mapper
+void test_cartridge_pages()
+{
+    CREATE_ALL_COMPONENTS
+
+    // MBC1 with 8KB of RAM
+    write_test_rom("test/pages-test.gb", CONTROLLER_MBC1_RAM, 0x02);
+    assert(load_cartridge(cartridge, "test/pages-test.gb"));
+    remove("test/pages-test.gb");
+    mmu_map_pages(cpu->mmu);
+    assert(cpu->mmu->read_page_table[0x41] == cartridge->rom_bank_1 + 0x100);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, 0x4100) == 1);
+    cpu->mmu->mmu_set_byte(cpu->mmu, 0x2000, 2);
+    assert(cpu->mmu->read_page_table[0x41] == cartridge->rom_bank_1 + 0x100);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, 0x4100) == 2);
+
+    // disabled RAM is unmapped and reads 0xFF
+    assert(cpu->mmu->read_page_table[0xA0] == NULL);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA010) == 0xFFFF);
+    cpu->mmu->mmu_set_word(cpu->mmu, 0xA010, 0x1234);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA010) == 0xFFFF);
+
+    // enabled RAM is mapped, a word across two pages lands in both
+    cpu->mmu->mmu_set_byte(cpu->mmu, 0x0000, 0x0A);
+    assert(cpu->mmu->read_page_table[0xA0] == cartridge->ram);
+    assert(cpu->mmu->write_page_table[0xA1] == cartridge->ram + 0x100);
+    cpu->mmu->mmu_set_word(cpu->mmu, 0xA0FF, 0x1234);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, 0xA0FF) == 0x34);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, 0xA100) == 0x12);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA0FF) == 0x1234);
+    assert(cartridge->ram[0xFF] == 0x34 && cartridge->ram[0x100] == 0x12);
+    cpu->mmu->mmu_set_word(cpu->mmu, 0xA010, 0xBEEF);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA010) == 0xBEEF);
+    free_cartridge(cartridge);
+
+    // MBC2 nibble RAM stays on the handlers, words included
+    cartridge = create_cartridge();
+    cpu->mmu->cartridge = cartridge;
+    cartridge->mmu            = cpu->mmu;
+    cartridge->on_bank_switch = mmu_map_cartridge_pages;
+    write_test_rom("test/pages-test.gb", CONTROLLER_MBC2, 0x00);
+    assert(load_cartridge(cartridge, "test/pages-test.gb"));
+    remove("test/pages-test.gb");
+    mmu_map_pages(cpu->mmu);
+    cpu->mmu->mmu_set_byte(cpu->mmu, 0x0000, 0x0A);
+    assert(cpu->mmu->read_page_table[0xA0] == NULL);
+    cpu->mmu->mmu_set_word(cpu->mmu, 0xA0FF, 0x1234);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA0FF) == 0xF2F4);
+    assert(cpu->mmu->mmu_get_word(cpu->mmu, 0xA2FF) == 0xF2F4);   // mirrored every 512 bytes
+
+    DELETE_ALL_COMPONENTS
+}
+
+// Timer derived from the scheduler clock
+void test_timer()
+{
+    CREATE_ALL_COMPONENTS
+
+    struct Scheduler *scheduler = create_scheduler();
+    struct Timer     *timer     = create_timer();
+    mmu_attach_timer(cpu->mmu, timer);
+    timer_attach_scheduler(timer, scheduler);
+    assert(scheduler->next_deadline == SCHEDULER_NEVER);
+
+    // DIV is the upper byte of the system counter
+    scheduler->now = 0x1234;
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_DIV_ADDRESS) == 0x12);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_DIV_ADDRESS, 0xAB);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_DIV_ADDRESS) == 0x00);
+
+    // TAC = 5: TIMA counts every 4 cycles
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TMA_ADDRESS, 0xF0);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TIMA_ADDRESS, 0xFE);
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TAC_ADDRESS, 0x05);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TAC_ADDRESS) == 0xFD);
+    assert(scheduler->next_deadline == 0x1234 + 8);
+    scheduler->now = 0x1234 + 7;
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TIMA_ADDRESS) == 0xFF);
+
+    // overflow: reload from TMA and request INT_TIMER
+    scheduler->now = 0x1234 + 9;
+    scheduler_dispatch(scheduler);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TIMA_ADDRESS) == 0xF0);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, IF_ADDRESS) & INT_TIMER);
+    assert(scheduler->next_deadline == 0x1234 + 8 + 16 * 4);
+
+    // resetting DIV while the selected bit is set is a falling edge
+    scheduler->now = 0x1234 + 10;
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_DIV_ADDRESS, 0x00);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TIMA_ADDRESS) == 0xF1);
+
+    // so is disabling the timer
+    scheduler->now += 2;
+    cpu->mmu->mmu_set_byte(cpu->mmu, TIMER_TAC_ADDRESS, 0x01);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, TIMER_TIMA_ADDRESS) == 0xF2);
+    assert(scheduler->next_deadline == SCHEDULER_NEVER);
+
+    free_timer(timer);
+    free_scheduler(scheduler);
+    DELETE_ALL_COMPONENTS
+}
+
+void test_ppu_registers()
+{
+    CREATE_ALL_COMPONENTS
+
+    struct Scheduler *scheduler = create_scheduler();
+    ppu_attach_mmu(ppu, cpu->mmu);
+    ppu_attach_scheduler(ppu, scheduler);
+    scheduler_dispatch(scheduler);
+    assert((cpu->mmu->mmu_get_byte(cpu->mmu, STAT_ADDRESS) & STAT_MODE_MASK) == MODE_OAM_SEARCH);
+
+    // LY is read only
+    cpu->mmu->mmu_set_byte(cpu->mmu, LY_ADDRESS, 0x42);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, LY_ADDRESS) == 0);
+
+    // only STAT bits 3-6 are writable, bit 7 reads back as 1
+    cpu->mmu->mmu_set_byte(cpu->mmu, LYC_ADDRESS, 5);
+    cpu->mmu->mmu_set_byte(cpu->mmu, STAT_ADDRESS, 0xFF);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, STAT_ADDRESS) == (0xF8 | MODE_OAM_SEARCH));
+    assert((cpu->mmu->interrupt_pending & INT_LCD_STAT) == 0);
+
+    // H-Blank raises the enabled mode 0 interrupt
+    cpu->mmu->mmu_set_byte(cpu->mmu, IE_ADDRESS, INT_LCD_STAT);
+    scheduler->now = PPU_OAM_SEARCH_CYCLES + PPU_PIXEL_TRANSFER_CYCLES;
+    scheduler_dispatch(scheduler);
+    assert(cpu->mmu->interrupt_pending & INT_LCD_STAT);
+    mmu_acknowledge_interrupt(cpu->mmu, INT_LCD_STAT);
+
+    // DMG quirk: any STAT write during H-Blank raises the interrupt
+    cpu->mmu->mmu_set_byte(cpu->mmu, STAT_ADDRESS, 0x00);
+    assert(cpu->mmu->interrupt_pending & INT_LCD_STAT);
+    mmu_acknowledge_interrupt(cpu->mmu, INT_LCD_STAT);
+
+    // turning the LCD off resets LY and the mode, then blanks a full frame
+    scheduler->now = PPU_SCANLINE_CYCLES * 3 + 10;
+    scheduler_dispatch(scheduler);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, LY_ADDRESS) == 3);
+    cpu->mmu->mmu_set_byte(cpu->mmu, LCDC_ADDRESS, 0x11);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, LCDC_ADDRESS) == 0x11);
+    assert(cpu->mmu->mmu_get_byte(cpu->mmu, LY_ADDRESS) == 0);
+    assert((cpu->mmu->mmu_get_byte(cpu->mmu, STAT_ADDRESS) & STAT_MODE_MASK) == MODE_HBLANK);
+    assert(scheduler->next_deadline == scheduler->now + PPU_FRAME_CYCLES);
+
+    // turning it back on restarts drawing from line 0
+    scheduler->now += 100;
+    cpu->mmu->mmu_set_byte(cpu->mmu, LCDC_ADDRESS, 0x91);
+    assert(ppu->frame_ready);
+    assert((cpu->mmu->mmu_get_byte(cpu->mmu, STAT_ADDRESS) & STAT_MODE_MASK) == MODE_OAM_SEARCH);
+    assert(scheduler->next_deadline == scheduler->now + PPU_OAM_SEARCH_CYCLES);
+
+    free_scheduler(scheduler);
+    DELETE_ALL_COMPONENTS
+}
+
+// Draw one frame with SCX, BGP, LCDC, VRAM and OAM writes between lines
+static void draw_raster_frame(bool deferred, bool threaded, int pool_threads, uint8_t *framebuffer)
+{
+    CREATE_ALL_COMPONENTS
+
+    config.deferred_rendering   = deferred;
+    struct Scheduler *scheduler = create_scheduler();
+    ppu_attach_mmu(ppu, cpu->mmu);
+    if (threaded) {
+        ppu_attach_render_worker(ppu, create_render_worker(ppu));
+        assert(ppu->render_worker != NULL);
+    }
+    if (pool_threads > 1) {
+        ppu_attach_render_pool(ppu, create_render_pool(ppu, pool_threads));
+        assert(ppu->render_pool != NULL);
+    }
+    srand(1);
+    for (uint16_t address = 0x8000; address < 0xA000; address++) {
+        cpu->mmu->mmu_set_byte(cpu->mmu, address, rand());
+    }
+    for (uint16_t address = 0xFE00; address < 0xFEA0; address++) {
+        cpu->mmu->mmu_set_byte(cpu->mmu, address, rand() % 180);
+    }
+    cpu->mmu->mmu_set_byte(cpu->mmu, LCDC_ADDRESS, 0x93);
+    ppu_attach_scheduler(ppu, scheduler);
+
+    for (int line = 0; line < SCREEN_HEIGHT; line++) {
+        uint64_t line_start = (uint64_t)line * PPU_SCANLINE_CYCLES;
+        // mode 2: shows up on this line
+        scheduler->now = line_start;
+        scheduler_dispatch(scheduler);
+        if (line % 3 == 0) {
+            cpu->mmu->mmu_set_byte(cpu->mmu, SCX_ADDRESS, line * 3);
+            cpu->mmu->mmu_set_byte(cpu->mmu, 0x9800 + rand() % 0x400, rand());
+        }
+        // H-Blank: shows up on the next line
+        scheduler->now = line_start + PPU_OAM_SEARCH_CYCLES + PPU_PIXEL_TRANSFER_CYCLES;
+        scheduler_dispatch(scheduler);
+        if (line % 8 == 0) {
+            cpu->mmu->mmu_set_byte(cpu->mmu, BGP_ADDRESS, rand());
+            cpu->mmu->mmu_set_byte(cpu->mmu, 0x8000 + rand() % 0x1800, rand());
+            cpu->mmu->mmu_set_byte(cpu->mmu, 0xFE00 + rand() % 0xA0, rand() % 180);
+        }
+        if (line == 70) {
+            cpu->mmu->mmu_set_byte(cpu->mmu, WY_ADDRESS, 80);
+            cpu->mmu->mmu_set_byte(cpu->mmu, WX_ADDRESS, 40);
+            cpu->mmu->mmu_set_byte(cpu->mmu, LCDC_ADDRESS, 0xF7);
+        }
+        if (line == 100) {
+            // more than the change log holds
+            for (int index = 0; index < PPU_CHANGE_LOG_SIZE + 100; index++) {
+                cpu->mmu->mmu_set_byte(cpu->mmu, 0x8000 + index, rand());
+            }
+        }
+    }
+    // V-Blank
+    scheduler->now = (uint64_t)SCREEN_HEIGHT * PPU_SCANLINE_CYCLES;
+    scheduler_dispatch(scheduler);
+    assert(!ppu->deferred_frame);
+    if (threaded) {
+        render_worker_sync(ppu->render_worker);
+    }
+    memcpy(framebuffer, ppu->framebuffer, SCREEN_WIDTH * SCREEN_HEIGHT);
+
+    config.deferred_rendering = false;
+    free_scheduler(scheduler);
+    DELETE_ALL_COMPONENTS
+}
+
+void test_deferred_rendering()
+{
+    static uint8_t eager[SCREEN_WIDTH * SCREEN_HEIGHT];
+    static uint8_t deferred[SCREEN_WIDTH * SCREEN_HEIGHT];
+    draw_raster_frame(false, false, 1, eager);
+    draw_raster_frame(true, false, 1, deferred);
+    assert(memcmp(eager, deferred, sizeof(eager)) == 0);
+}
+
+void test_render_worker()
+{
+    static uint8_t eager[SCREEN_WIDTH * SCREEN_HEIGHT];
+    static uint8_t threaded[SCREEN_WIDTH * SCREEN_HEIGHT];
+    draw_raster_frame(false, false, 1, eager);
+    draw_raster_frame(false, true, 1, threaded);
+    assert(memcmp(eager, threaded, sizeof(eager)) == 0);
+    draw_raster_frame(true, true, 1, threaded);
+    assert(memcmp(eager, threaded, sizeof(eager)) == 0);
+}
+
+// Sprites a plain scan of OAM memory picks for line ly, as the PPU did before binning
+static int search_oam_reference(struct MMU *mmu, uint8_t lcdc, uint8_t ly, uint8_t *selected)
+{
+    uint8_t sprite_height = (lcdc & 0x04) ? 16 : 8;
+    int     count         = 0;
+    for (int index = 0; index < 40 && count < 10; index++) {
+        uint8_t y = mmu->mmu_get_byte(mmu, 0xFE00 + index * 4);
+        uint8_t x = mmu->mmu_get_byte(mmu, 0xFE00 + index * 4 + 1);
+        uint8_t sprite_y = y - 16;
+        if (x == 0 || ly < sprite_y || ly >= sprite_y + sprite_height) {
+            continue;
+        }
+        selected[count++] = index;
+    }
+    return count;
+}
+
+static void check_sprite_bins(struct PPU *ppu, struct MMU *mmu)
+{
+    uint8_t selected[10];
+    for (int ly = 0; ly < SCREEN_HEIGHT; ly++) {
+        int count = search_oam_reference(mmu, ppu->lcdc, ly, selected);
+        ppu_oam_search_line(ppu, ly);
+        assert(ppu->searched_sprite_count == count);
+        for (int slot = 0; slot < count; slot++) {
+            struct SpriteEntry *sprite = ppu->selected_oam_entries[slot];
+            uint16_t            entry  = 0xFE00 + selected[slot] * 4;
+            assert(sprite->y == mmu->mmu_get_byte(mmu, entry));
+            assert(sprite->x == mmu->mmu_get_byte(mmu, entry + 1));
+            assert(sprite->tile_index == mmu->mmu_get_byte(mmu, entry + 2));
+            uint8_t flags = mmu->mmu_get_byte(mmu, entry + 3);
+            assert(sprite->priority == (flags >> 7));
+            assert(sprite->y_flip == ((flags >> 6) & 1));
+            assert(sprite->x_flip == ((flags >> 5) & 1));
+            assert(sprite->palette == ((flags >> 4) & 1));
+        }
+    }
+}
+
+void test_sprite_bins()
+{
+    CREATE_ALL_COMPONENTS
+
+    ppu_attach_mmu(ppu, mmu);
+    srand(2);
+    // crowd a few lines past the 10 sprite limit, including sprites cut off at the top
+    for (uint16_t address = 0xFE00; address < 0xFEA0; address += 4) {
+        mmu->mmu_set_byte(mmu, address, 8 + rand() % 40);
+        mmu->mmu_set_byte(mmu, address + 1, rand() % 4 == 0 ? 0 : rand());
+        mmu->mmu_set_word(mmu, address + 2, rand());
+    }
+    mmu->mmu_set_byte(mmu, LCDC_ADDRESS, 0x93);
+    check_sprite_bins(ppu, mmu);
+    // LCDC.2: 8x16 sprites
+    mmu->mmu_set_byte(mmu, LCDC_ADDRESS, 0x97);
+    check_sprite_bins(ppu, mmu);
+    // single byte moves, a word write straddling into OAM
+    mmu->mmu_set_byte(mmu, 0xFE00 + 5 * 4, 100);
+    mmu->mmu_set_byte(mmu, 0xFE00 + 7 * 4 + 1, 0);
+    mmu->mmu_set_word(mmu, 0xFDFF, 0x3000);
+    check_sprite_bins(ppu, mmu);
+    // OAM DMA from WRAM
+    for (uint16_t address = 0xC000; address < 0xC0A0; address++) {
+        mmu->mmu_set_byte(mmu, address, rand() % 170);
+    }
+    DMA(mmu, 0xC0);
+    check_sprite_bins(ppu, mmu);
+    mmu->mmu_set_byte(mmu, LCDC_ADDRESS, 0x93);
+    check_sprite_bins(ppu, mmu);
+
+    DELETE_ALL_COMPONENTS
+}
+
+void test_render_pool()
+{
+    static uint8_t eager[SCREEN_WIDTH * SCREEN_HEIGHT];
+    static uint8_t pooled[SCREEN_WIDTH * SCREEN_HEIGHT];
+    draw_raster_frame(false, false, 1, eager);
+    for (int threads = 2; threads <= 4; threads++) {
+        draw_raster_frame(false, false, threads, pooled);
+        assert(memcmp(eager, pooled, sizeof(eager)) == 0);
+    }
+    assert(create_render_pool(NULL, 1) == NULL);
+    assert(create_render_pool(NULL, RENDER_POOL_MAX_THREADS + 1) == NULL);
+}
+
+void test_ppu_output()
+{
+    CREATE_ALL_COMPONENTS
+
+    // lines padded to 200 pixels, the padding must stay untouched
+    enum { PITCH_PIXELS = 200 };
+    static uint32_t argb[PITCH_PIXELS * SCREEN_HEIGHT];
+    static uint16_t rgb565[PITCH_PIXELS * SCREEN_HEIGHT];
+    const uint32_t  palette[4] = {0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFF000000};
+
+    ppu_attach_mmu(ppu, mmu);
+    srand(4);
+    for (uint16_t address = 0x8000; address < 0xA000; address++) {
+        mmu->mmu_set_byte(mmu, address, rand());
+    }
+    mmu->mmu_set_byte(mmu, LCDC_ADDRESS, 0x93);
+    mmu->mmu_set_byte(mmu, BGP_ADDRESS, 0xE4);
+
+    memset(argb, 0xAB, sizeof(argb));
+    ppu_set_output(ppu, argb, PITCH_PIXELS * sizeof(uint32_t), PPU_OUTPUT_ARGB8888);
+    ppu_set_output_palette(ppu, palette, 4);
+    for (int ly = 0; ly < SCREEN_HEIGHT; ly++) {
+        ppu_oam_search_line(ppu, ly);
+        ppu_render_scanline_ly(ppu, ly);
+    }
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        for (int x = 0; x < PITCH_PIXELS; x++) {
+            uint32_t expected =
+                x < SCREEN_WIDTH ? palette[ppu->framebuffer[y * SCREEN_WIDTH + x]] : 0xABABABAB;
+            assert(argb[y * PITCH_PIXELS + x] == expected);
+        }
+    }
+
+    // switching format converts the palette that is already set
+    memset(rgb565, 0xAB, sizeof(rgb565));
+    ppu_set_output(ppu, rgb565, PITCH_PIXELS * sizeof(uint16_t), PPU_OUTPUT_RGB565);
+    for (int ly = 0; ly < SCREEN_HEIGHT; ly++) {
+        ppu_oam_search_line(ppu, ly);
+        ppu_render_scanline_ly(ppu, ly);
+    }
+    const uint16_t palette_565[4] = {0xFFFF, 0xAD55, 0x52AA, 0x0000};
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        for (int x = 0; x < PITCH_PIXELS; x++) {
+            uint16_t expected =
+                x < SCREEN_WIDTH ? palette_565[ppu->framebuffer[y * SCREEN_WIDTH + x]] : 0xABAB;
+            assert(rgb565[y * PITCH_PIXELS + x] == expected);
+        }
+    }
+
+    ppu_set_output(ppu, NULL, 0, PPU_OUTPUT_ARGB8888);
+    DELETE_ALL_COMPONENTS
+}
+
 int main()
 {
     config.start_time = get_time_in_seconds();
@@ -1940,5 +2509,38 @@ int main()
     test_opcode_cb_c0();
     test_opcode_cb_c6();
     CPU_INFO_PRINT("CB prefix test completed\n");
+
+    test_interrupt_dispatch();
+    CPU_INFO_PRINT("Interrupt test completed\n");
+
+    test_serial_transfer();
+    CPU_INFO_PRINT("Serial test completed\n");
+
+    test_halt_fast_forward();
+    CPU_INFO_PRINT("HALT fast-forward test completed\n");
+
+    test_cartridge_pages();
+    CPU_INFO_PRINT("Cartridge page test completed\n");
+
+    test_timer();
+    CPU_INFO_PRINT("Timer test completed\n");
+
+    test_ppu_registers();
+    CPU_INFO_PRINT("PPU register test completed\n");
+
+    test_deferred_rendering();
+    CPU_INFO_PRINT("Deferred rendering test completed\n");
+
+    test_render_worker();
+    CPU_INFO_PRINT("Render worker test completed\n");
+
+    test_sprite_bins();
+    CPU_INFO_PRINT("Sprite bin test completed\n");
+
+    test_render_pool();
+    CPU_INFO_PRINT("Render pool test completed\n");
+
+    test_ppu_output();
+    CPU_INFO_PRINT("PPU output test completed\n");
     return 0;
 }
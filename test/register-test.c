@@ -120,5 +120,39 @@ int main()
     set_control_register(registers, SP, 0x1234);
     assert(get_control_register(registers, SP) == 0x1234);
 
+    // test lazy flags: 0x0F + 0xF1 = 0x100 -> Z, H, C
+    registers_record_flags(registers, FlagOperation_Add, 0x0F, 0xF1, 0, 0x100);
+    assert(get_register_byte(registers, F) == (Flag_Z | Flag_H | Flag_C));
+    assert(registers->lazy_flags.operation == FlagOperation_None);
+
+    // 0x10 - 0x01 = 0x0F -> N, H
+    registers_record_flags(registers, FlagOperation_Sub, 0x10, 0x01, 0, 0x0F);
+    assert(get_flag(registers, Flag_N) == true);
+    assert(get_flag(registers, Flag_H) == true);
+    assert(get_flag(registers, Flag_C) == false);
+    assert(get_flag(registers, Flag_Z) == false);
+
+    // INC keeps C
+    set_flag(registers, Flag_C, true);
+    registers_record_flags(registers, FlagOperation_Inc, 0xFF, 1, 1, 0x00);
+    assert(get_register_pair(registers, AF) ==
+           ((get_register_byte(registers, A) << 8) | Flag_Z | Flag_H | Flag_C));
+
+    // the carry of a pending operation is read without rebuilding F
+    registers_record_flags(registers, FlagOperation_Sub, 0x01, 0x02, 0, 0xFF);
+    assert(registers_get_carry(registers) == true);
+    assert(registers->lazy_flags.operation == FlagOperation_Sub);
+    registers_record_flags(registers, FlagOperation_Dec, 0x01, 1, true, 0x00);
+    assert(registers_get_carry(registers) == true);
+    registers_record_flags(registers, FlagOperation_Logic, 0x00, 0x00, 0, 0x01);
+    assert(registers_get_carry(registers) == false);
+    assert(get_flag(registers, Flag_C) == false);
+    assert(registers_get_carry(registers) == false);
+
+    // writing F drops the pending operation
+    registers_record_flags(registers, FlagOperation_And, 0x00, 0x00, 0, 0x00);
+    set_register_byte(registers, F, 0x00);
+    assert(get_register_byte(registers, F) == 0x00);
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "../src/scheduler.h"
+#include "test.h"
+
+static int      fired[8];
+static uint64_t fired_deadline[8];
+static int      fired_count = 0;
+
+static void record_event(void* context, uint64_t deadline)
+{
+    fired[fired_count]          = *(int*)context;
+    fired_deadline[fired_count] = deadline;
+    fired_count++;
+}
+
+static struct Scheduler* periodic_scheduler;
+
+static void periodic_event(void* context, uint64_t deadline)
+{
+    record_event(context, deadline);
+    // reschedule relative to the deadline, not to now
+    scheduler_schedule_at(periodic_scheduler, EVENT_APU_FRAME_SEQUENCER, deadline + 100);
+}
+
+int main()
+{
+    config.start_time = get_time_in_seconds();
+    struct Scheduler *scheduler = create_scheduler();
+    assert(scheduler != NULL);
+    assert(scheduler->now == 0);
+    assert(scheduler->next_deadline == SCHEDULER_NEVER);
+
+    int ppu = EVENT_PPU, timer = EVENT_TIMER, dma = EVENT_DMA, apu = EVENT_APU_FRAME_SEQUENCER;
+    scheduler_register(scheduler, EVENT_PPU, record_event, &ppu);
+    scheduler_register(scheduler, EVENT_TIMER, record_event, &timer);
+    scheduler_register(scheduler, EVENT_DMA, record_event, &dma);
+
+    // events fire in deadline order
+    scheduler_schedule_in(scheduler, EVENT_PPU, 30);
+    scheduler_schedule_in(scheduler, EVENT_TIMER, 10);
+    scheduler_schedule_in(scheduler, EVENT_DMA, 20);
+    assert(scheduler->next_deadline == 10);
+    assert(scheduler_cycles_until_next_event(scheduler) == 10);
+
+    scheduler->now = 25;
+    assert(scheduler_cycles_until_next_event(scheduler) == 0);
+    scheduler_dispatch(scheduler);
+    assert(fired_count == 2);
+    assert(fired[0] == EVENT_TIMER && fired_deadline[0] == 10);
+    assert(fired[1] == EVENT_DMA && fired_deadline[1] == 20);
+    assert(scheduler->next_deadline == 30);
+
+    // moving the earliest event later rescans the table
+    scheduler_schedule_at(scheduler, EVENT_PPU, 50);
+    scheduler_schedule_at(scheduler, EVENT_TIMER, 40);
+    assert(scheduler->next_deadline == 40);
+
+    // cancel
+    scheduler_cancel(scheduler, EVENT_TIMER);
+    assert(scheduler->next_deadline == 50);
+    scheduler_cancel(scheduler, EVENT_PPU);
+    assert(scheduler->next_deadline == SCHEDULER_NEVER);
+    scheduler->now = 1000;
+    scheduler_dispatch(scheduler);
+    assert(fired_count == 2);
+
+    // a periodic event keeps its phase even when dispatched late
+    periodic_scheduler = scheduler;
+    scheduler_register(scheduler, EVENT_APU_FRAME_SEQUENCER, periodic_event, &apu);
+    scheduler_schedule_at(scheduler, EVENT_APU_FRAME_SEQUENCER, 1100);
+    scheduler->now = 1250;
+    scheduler_dispatch(scheduler);
+    assert(fired_count == 4);
+    assert(fired_deadline[2] == 1100);
+    assert(fired_deadline[3] == 1200);
+    assert(scheduler->next_deadline == 1300);
+
+    free_scheduler(scheduler);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "../src/upscaler.h"
+#include "test.h"
+
+#define WIDTH  160
+#define HEIGHT 144
+
+static uint32_t source[WIDTH * HEIGHT];
+static uint32_t expected[WIDTH * 6 * HEIGHT * 6];
+static uint32_t actual[WIDTH * 6 * HEIGHT * 6];
+
+// Scale the whole frame with the scalar row functions only
+static void scale_reference(struct Upscaler *upscaler, uint32_t *dst, int scale)
+{
+    upscale_row_fn        widen_row   = upscaler->widen_row;
+    upscale_filter_row_fn scale2x_row = upscaler->scale2x_row;
+    upscale_filter_row_fn scale3x_row = upscaler->scale3x_row;
+    upscaler->widen_row   = upscale_row_scalar;
+    upscaler->scale2x_row = upscale_scale2x_row_scalar;
+    upscaler->scale3x_row = upscale_scale3x_row_scalar;
+    upscaler_scale(upscaler, dst, WIDTH * scale, source, WIDTH, WIDTH, HEIGHT, scale);
+    upscaler->widen_row   = widen_row;
+    upscaler->scale2x_row = scale2x_row;
+    upscaler->scale3x_row = scale3x_row;
+}
+
+int main(void)
+{
+    config.start_time = get_time_in_seconds();
+
+    // few colors so the filters find plenty of matching neighbours
+    srand(5);
+    for (int index = 0; index < WIDTH * HEIGHT; index++) {
+        source[index] = 0xFF000000 | (rand() % 3) * 0x555555;
+    }
+
+    // nearest: every destination pixel is its source pixel
+    struct Upscaler *upscaler = create_upscaler(UPSCALE_NEAREST);
+    assert(upscaler != NULL);
+    for (int scale = 1; scale <= UPSCALER_MAX_SCALE; scale++) {
+        int pitch = WIDTH * scale;
+        upscaler_scale(upscaler, actual, pitch, source, WIDTH, WIDTH, HEIGHT, scale);
+        for (int y = 0; y < HEIGHT * scale; y++) {
+            for (int x = 0; x < pitch; x++) {
+                assert(actual[y * pitch + x] == source[(y / scale) * WIDTH + x / scale]);
+            }
+        }
+    }
+    // odd widths take the scalar tail
+    uint32_t row[7 * 6];
+    for (int scale = 1; scale <= UPSCALER_MAX_SCALE; scale++) {
+        upscaler->widen_row(row, source, 7, scale);
+        for (int x = 0; x < 7 * scale; x++) {
+            assert(row[x] == source[x / scale]);
+        }
+    }
+    free_upscaler(upscaler);
+
+    // Scale2x of one pixel: B and D are set, so the top left corner follows them
+    //   1        1 0
+    // 1 0 0  ->  0 0
+    //   0
+    uint32_t up[3]   = {0, 1, 0};
+    uint32_t mid[3]  = {1, 0, 0};
+    uint32_t down[3] = {0, 0, 0};
+    uint32_t corner[2][2];
+    upscale_scale2x_row_scalar(corner[0], 2, up, mid, down, 1);
+    assert(corner[0][0] == 1 && corner[0][1] == 0 && corner[1][0] == 0 && corner[1][1] == 0);
+    // with B == H nothing changes
+    down[1] = 1;
+    upscale_scale2x_row_scalar(corner[0], 2, up, mid, down, 1);
+    assert(corner[0][0] == 0 && corner[0][1] == 0 && corner[1][0] == 0 && corner[1][1] == 0);
+
+    // filters: the SSE2 rows match the scalar ones at every scale they apply to
+    enum UpscaleFilter filters[2] = {UPSCALE_SCALE2X, UPSCALE_SCALE3X};
+    for (int index = 0; index < 2; index++) {
+        upscaler = create_upscaler(filters[index]);
+        assert(upscaler != NULL);
+        for (int scale = 1; scale <= UPSCALER_MAX_SCALE; scale++) {
+            size_t size = (size_t)WIDTH * scale * HEIGHT * scale * sizeof(uint32_t);
+            scale_reference(upscaler, expected, scale);
+            upscaler_scale(upscaler, actual, WIDTH * scale, source, WIDTH, WIDTH, HEIGHT, scale);
+            assert(memcmp(expected, actual, size) == 0);
+        }
+        free_upscaler(upscaler);
+    }
+
+    // flat areas stay flat through the filters
+    for (int index = 0; index < WIDTH * HEIGHT; index++) {
+        source[index] = 0xFF123456;
+    }
+    upscaler = create_upscaler(UPSCALE_SCALE3X);
+    upscaler_scale(upscaler, actual, WIDTH * 6, source, WIDTH, WIDTH, HEIGHT, 6);
+    for (int index = 0; index < WIDTH * 6 * HEIGHT * 6; index++) {
+        assert(actual[index] == 0xFF123456);
+    }
+    free_upscaler(upscaler);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "../src/vram.h"
+#include "test.h"
+
+int main(void)
+{
+    config.start_time = get_time_in_seconds();
+    struct Vram *vram = create_vram();
+    assert(vram != NULL);
+
+    // blank tile data decodes to color 0
+    const uint8_t *row = vram_get_tile_row(vram, 0, 0, false);
+    for (int x = 0; x < 8; x++) {
+        assert(row[x] == 0);
+    }
+
+    // tile 1, row 2: low plane 0b10100000, high plane 0b11000000 -> 3 2 1 0 0 0 0 0
+    vram->vram_set_byte(vram, 0x8000 + 16 + 4, 0xA0);
+    vram->vram_set_byte(vram, 0x8000 + 16 + 5, 0xC0);
+    uint8_t expected[8] = {3, 2, 1, 0, 0, 0, 0, 0};
+    row = vram_get_tile_row(vram, 1, 2, false);
+    assert(memcmp(row, expected, 8) == 0);
+    row = vram_get_tile_row(vram, 1, 2, true);
+    for (int x = 0; x < 8; x++) {
+        assert(row[x] == expected[7 - x]);
+    }
+
+    // a word write invalidates the tile again
+    vram->vram_set_word(vram, 0x8000 + 16 + 4, 0xFFFF);
+    row = vram_get_tile_row(vram, 1, 2, false);
+    for (int x = 0; x < 8; x++) {
+        assert(row[x] == 3);
+    }
+
+    // last tile, and tile map writes do not touch the cache
+    vram->vram_set_byte(vram, 0x97FF, 0x01);
+    assert(vram_get_tile_row(vram, VRAM_TILE_COUNT - 1, 7, false)[7] == 2);
+    vram->vram_set_byte(vram, 0x9800, 0xFF);
+    for (int word = 0; word < VRAM_TILE_COUNT / 64; word++) {
+        assert(vram->tile_dirty[word] == 0);
+    }
+
+    // 8800 addressing: index 0x80 is tile 256 - 128, index 0x00 is tile 256
+    assert(vram_tile_from_map(0x80, true) == 128);
+    assert(vram_tile_from_map(0x00, true) == 256);
+    assert(vram_tile_from_map(0x7F, true) == 383);
+    assert(vram_tile_from_map(0x80, false) == 128);
+
+    // layers: 0x9800 cell (3, 2) shows tile 1 under 8000 addressing, tile 257 under 8800
+    vram->vram_set_byte(vram, 0x9800 + 2 * 32 + 3, 0x01);
+    const uint8_t *layer_row = vram_get_layer_row(vram, 0x9800, false, 2 * 8 + 2);
+    assert(memcmp(layer_row + 3 * 8, vram_get_tile_row(vram, 1, 2, false), 8) == 0);
+    layer_row = vram_get_layer_row(vram, 0x9800, true, 2 * 8 + 2);
+    assert(memcmp(layer_row + 3 * 8, vram_get_tile_row(vram, 257, 2, false), 8) == 0);
+    // tile data writes reach every cell showing the tile, other maps stay as they were
+    vram->vram_set_byte(vram, 0x8000 + 16 + 4, 0x0F);
+    layer_row = vram_get_layer_row(vram, 0x9800, false, 2 * 8 + 2);
+    assert(memcmp(layer_row + 3 * 8, vram_get_tile_row(vram, 1, 2, false), 8) == 0);
+    assert(vram_get_layer_row(vram, 0x9C00, false, 2 * 8 + 2)[3 * 8] ==
+           vram_get_tile_row(vram, 0, 2, false)[0]);
+    // every layer matches a tile by tile lookup of its map
+    srand(3);
+    for (uint16_t address = 0x8000; address < 0xA000; address++) {
+        if (rand() % 4 == 0) {
+            vram->vram_set_byte(vram, address, rand());
+        }
+    }
+    vram_update_layers(vram);
+    assert(vram->layer_pending == 0);
+    for (int layer = 0; layer < VRAM_LAYER_COUNT; layer++) {
+        uint16_t tile_map = layer < 2 ? 0x9800 : 0x9C00;
+        for (int y = 0; y < VRAM_LAYER_SIZE; y++) {
+            layer_row = vram_get_layer_row(vram, tile_map, layer & 1, y);
+            for (int column = 0; column < 32; column++) {
+                uint8_t  index = vram->vram_get_byte(vram, tile_map + (y / 8) * 32 + column);
+                uint16_t tile  = vram_tile_from_map(index, layer & 1);
+                assert(memcmp(layer_row + column * 8, vram_get_tile_row(vram, tile, y % 8, false),
+                              8) == 0);
+            }
+        }
+    }
+
+    free_vram(vram);
+    return 0;
+}